@@ -0,0 +1,64 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+
+namespace dev
+{
+
+/**
+ * Value that is shared between copies until one of them is modified, which makes
+ * copying cheap. The value has to be accessed through write() for modifications.
+ * Copies must not be modified concurrently from different threads.
+ */
+template <class T>
+class CopyOnWrite
+{
+public:
+	T const& operator*() const { return m_value ? *m_value : empty(); }
+	T const* operator->() const { return &operator*(); }
+
+	/// @returns a modifiable reference to the value, which is copied first if it is shared.
+	/// The reference is invalidated by copying this object.
+	T& write()
+	{
+		if (!m_value)
+			m_value = std::make_shared<T>();
+		else if (m_value.use_count() > 1)
+			m_value = std::make_shared<T>(*m_value);
+		return *m_value;
+	}
+	/// Resets the value to a default-constructed one.
+	void reset() { m_value.reset(); }
+
+	/// @returns true if both objects share their value, which implies that they are equal.
+	bool sharesValueWith(CopyOnWrite const& _other) const { return m_value == _other.m_value; }
+
+private:
+	static T const& empty()
+	{
+		static T const value{};
+		return value;
+	}
+
+	/// The value or nullptr for a default-constructed value.
+	std::shared_ptr<T> m_value;
+};
+
+}
@@ -25,13 +25,48 @@
 
 #include <libdevcore/Assertions.h>
 
-#include <boost/regex.hpp>
+#include <algorithm>
+#include <mutex>
 
 using namespace std;
 using namespace dev;
 
+struct Whiskers::Template
+{
+	enum class Kind { Text, Parameter, List, Condition };
+	struct Element
+	{
+		Kind kind;
+		/// The literal text or the name of the parameter, list or condition.
+		string text;
+		/// The body of a list or the part of a condition used if it is true.
+		unique_ptr<Template> body;
+		/// The part of a condition used if it is false, might be null.
+		unique_ptr<Template> elseBody;
+	};
+
+	/// The unparsed template, used in error messages.
+	string source;
+	vector<Element> elements;
+};
+
+namespace
+{
+
+/// @returns true if @a _c can be part of a parameter name, i.e. matches [a-zA-Z0-9_$-].
+bool isParameterCharacter(char _c)
+{
+	return
+		('a' <= _c && _c <= 'z') ||
+		('A' <= _c && _c <= 'Z') ||
+		('0' <= _c && _c <= '9') ||
+		_c == '_' || _c == '$' || _c == '-';
+}
+
+}
+
 Whiskers::Whiskers(string _template):
-	m_template(move(_template))
+	m_template(compile(_template))
 {
 }
 
@@ -67,16 +102,19 @@ Whiskers& Whiskers::operator()(
 
 string Whiskers::render() const
 {
-	return replace(m_template, m_parameters, m_conditions, m_listParameters);
+	string result;
+	render(result, *m_template, m_parameters, nullptr, m_conditions, m_listParameters);
+	return result;
 }
 
 void Whiskers::checkParameterValid(string const& _parameter) const
 {
-	static boost::regex validParam("^" + paramRegex() + "$");
 	assertThrow(
-		boost::regex_match(_parameter, validParam),
+		!_parameter.empty() && all_of(_parameter.begin(), _parameter.end(), isParameterCharacter),
 		WhiskersError,
-		"Parameter" + _parameter + " contains invalid characters."
+		"Parameter " + _parameter + " contains invalid characters.\n" +
+		"Template:\n" +
+		m_template->source
 	);
 }
 
@@ -85,86 +123,203 @@ void Whiskers::checkParameterUnknown(string const& _parameter) const
 	assertThrow(
 		!m_parameters.count(_parameter),
 		WhiskersError,
-		_parameter + " already set as value parameter."
+		_parameter + " already set as value parameter.\n" +
+		"Template:\n" +
+		m_template->source
 	);
 	assertThrow(
 		!m_conditions.count(_parameter),
 		WhiskersError,
-		_parameter + " already set as condition parameter."
+		_parameter + " already set as condition parameter.\n" +
+		"Template:\n" +
+		m_template->source
 	);
 	assertThrow(
 		!m_listParameters.count(_parameter),
 		WhiskersError,
-		_parameter + " already set as list parameter."
+		_parameter + " already set as list parameter.\n" +
+		"Template:\n" +
+		m_template->source
 	);
 }
 
-string Whiskers::replace(
-	string const& _template,
+shared_ptr<Whiskers::Template const> Whiskers::compile(string const& _template)
+{
+	/// Maximum number of parsed templates kept in the cache. Almost all templates are
+	/// string literals in the code generators, but some are built at runtime, so the
+	/// cache is emptied once it is full. Instances keep their parsed templates alive.
+	static size_t const c_maxCacheSize = 1024;
+	static mutex cacheMutex;
+	static map<string, shared_ptr<Template const>> cache;
+
+	lock_guard<mutex> lock(cacheMutex);
+	if (cache.size() >= c_maxCacheSize && !cache.count(_template))
+		cache.clear();
+	shared_ptr<Template const>& compiled = cache[_template];
+	if (!compiled)
+		compiled = parse(_template, 0, _template.size());
+	return compiled;
+}
+
+unique_ptr<Whiskers::Template> Whiskers::parse(string const& _template, size_t _begin, size_t _end)
+{
+	// This follows the leftmost matches of the regular expression
+	// <(name)>|<#(name)>(.*?)</\2>|<\?(name)>(.*?)(<!\4>(.*?))?</\4>
+	// where "." also matches newlines.
+	auto result = make_unique<Template>();
+	result->source = _template.substr(_begin, _end - _begin);
+
+	/// @returns the end of the name starting at @a _pos if it is followed by ">", _pos otherwise.
+	auto nameEnd = [&](size_t _pos) -> size_t
+	{
+		size_t pos = _pos;
+		while (pos < _end && isParameterCharacter(_template[pos]))
+			pos++;
+		return (pos > _pos && pos < _end && _template[pos] == '>') ? pos : _pos;
+	};
+	/// @returns the position of the first occurrence of @a _tag at or after @a _pos
+	/// or string::npos if it does not end before _end.
+	auto find = [&](string const& _tag, size_t _pos) -> size_t
+	{
+		size_t pos = _template.find(_tag, _pos);
+		return (pos != string::npos && pos + _tag.size() <= _end) ? pos : string::npos;
+	};
+
+	string text;
+	auto addElement = [&](Template::Kind _kind, string _text, unique_ptr<Template> _body, unique_ptr<Template> _elseBody)
+	{
+		if (!text.empty())
+			result->elements.push_back({Template::Kind::Text, move(text), nullptr, nullptr});
+		text.clear();
+		result->elements.push_back({_kind, move(_text), move(_body), move(_elseBody)});
+	};
+
+	size_t pos = _begin;
+	while (pos < _end)
+	{
+		size_t tag = _template.find('<', pos);
+		if (tag == string::npos || tag >= _end)
+			tag = _end;
+		text.append(_template, pos, tag - pos);
+		if (tag == _end)
+			break;
+
+		char marker = tag + 1 < _end ? _template[tag + 1] : '\0';
+		size_t nameStart = (marker == '#' || marker == '?') ? tag + 2 : tag + 1;
+		size_t end = nameEnd(nameStart);
+		if (end != nameStart)
+		{
+			string name = _template.substr(nameStart, end - nameStart);
+			if (marker != '#' && marker != '?')
+			{
+				addElement(Template::Kind::Parameter, move(name), nullptr, nullptr);
+				pos = end + 1;
+				continue;
+			}
+			string closingTag = "</" + name + ">";
+			size_t close = find(closingTag, end + 1);
+			if (close != string::npos)
+			{
+				if (marker == '#')
+					addElement(Template::Kind::List, move(name), parse(_template, end + 1, close), nullptr);
+				else
+				{
+					string elseTag = "<!" + name + ">";
+					size_t elsePos = find(elseTag, end + 1);
+					if (elsePos != string::npos && elsePos < close)
+						addElement(
+							Template::Kind::Condition,
+							move(name),
+							parse(_template, end + 1, elsePos),
+							parse(_template, elsePos + elseTag.size(), close)
+						);
+					else
+						addElement(Template::Kind::Condition, move(name), parse(_template, end + 1, close), nullptr);
+				}
+				pos = close + closingTag.size();
+				continue;
+			}
+		}
+		// Not a tag, keep the character.
+		text += '<';
+		pos = tag + 1;
+	}
+	if (!text.empty())
+		result->elements.push_back({Template::Kind::Text, move(text), nullptr, nullptr});
+	return result;
+}
+
+void Whiskers::render(
+	string& _result,
+	Template const& _template,
 	StringMap const& _parameters,
+	StringMap const* _listElement,
 	map<string, bool> const& _conditions,
-	map<string, vector<StringMap>> const& _listParameters
+	StringListMap const& _listParameters
 )
 {
-	using namespace boost;
-	static regex listOrTag("<(" + paramRegex() + ")>|<#(" + paramRegex() + ")>(.*?)</\\2>|<\\?(" + paramRegex() + ")>(.*?)(<!\\4>(.*?))?</\\4>");
-	return regex_replace(_template, listOrTag, [&](match_results<string::const_iterator> _match) -> string
-	{
-		string tagName(_match[1]);
-		string listName(_match[2]);
-		string conditionName(_match[4]);
-		if (!tagName.empty())
+	for (auto const& element: _template.elements)
+		switch (element.kind)
 		{
+		case Template::Kind::Text:
+			_result += element.text;
+			break;
+		case Template::Kind::Parameter:
+		{
+			string const* value = nullptr;
+			if (_listElement && _listElement->count(element.text))
+				value = &_listElement->at(element.text);
+			else if (_parameters.count(element.text))
+				value = &_parameters.at(element.text);
 			assertThrow(
-				_parameters.count(tagName),
+				value,
 				WhiskersError,
-				"Value for tag " + tagName + " not provided.\n" +
+				"Value for tag " + element.text + " not provided.\n" +
 				"Template:\n" +
-				_template
+				_template.source
 			);
-			return _parameters.at(tagName);
+			_result += *value;
+			break;
 		}
-		else if (!listName.empty())
+		case Template::Kind::List:
 		{
-			string templ(_match[3]);
 			assertThrow(
-				_listParameters.count(listName),
-				WhiskersError, "List parameter " + listName + " not set."
+				_listParameters.count(element.text),
+				WhiskersError,
+				"List parameter " + element.text + " not set.\n" +
+				"Template:\n" +
+				_template.source
 			);
-			string replacement;
-			for (auto const& parameters: _listParameters.at(listName))
-				replacement += replace(templ, joinMaps(_parameters, parameters), _conditions);
-			return replacement;
+			// Lists cannot contain lists.
+			static StringListMap const noListParameters;
+			for (auto const& parameters: _listParameters.at(element.text))
+			{
+				for (auto const& parameter: parameters)
+					assertThrow(
+						!_parameters.count(parameter.first),
+						WhiskersError,
+						"Parameter collision: " + parameter.first + " is set both as value parameter and " +
+						"in list " + element.text + ".\n" +
+						"Template:\n" +
+						_template.source
+					);
+				render(_result, *element.body, _parameters, &parameters, _conditions, noListParameters);
+			}
+			break;
 		}
-		else
+		case Template::Kind::Condition:
 		{
-			assertThrow(!conditionName.empty(), WhiskersError, "");
 			assertThrow(
-				_conditions.count(conditionName),
-				WhiskersError, "Condition parameter " + conditionName + " not set."
-			);
-			return replace(
-				_conditions.at(conditionName) ? _match[5] : _match[7],
-				_parameters,
-				_conditions,
-				_listParameters
+				_conditions.count(element.text),
+				WhiskersError,
+				"Condition parameter " + element.text + " not set.\n" +
+				"Template:\n" +
+				_template.source
 			);
+			Template const* part = _conditions.at(element.text) ? element.body.get() : element.elseBody.get();
+			if (part)
+				render(_result, *part, _parameters, _listElement, _conditions, _listParameters);
+			break;
+		}
 		}
-	});
-}
-
-Whiskers::StringMap Whiskers::joinMaps(
-	Whiskers::StringMap const& _a,
-	Whiskers::StringMap const& _b
-)
-{
-	Whiskers::StringMap ret = _a;
-	for (auto const& x: _b)
-		assertThrow(
-			ret.insert(x).second,
-			WhiskersError,
-			"Parameter collision"
-		);
-	return ret;
 }
-
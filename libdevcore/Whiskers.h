@@ -27,6 +27,7 @@
 
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace dev
@@ -62,6 +63,9 @@ DEV_SIMPLE_EXCEPTION(WhiskersError);
  *  - List parameter: <#list>...</list>
  *    The part between the tags is repeated as often as values are provided
  *    in the mapping. Each list element can have its own parameter -> value mapping.
+ *
+ * Templates are parsed only once per template string and the parsed form is shared
+ * between all instances, so that rendering is a single pass over the parsed template.
  */
 class Whiskers
 {
@@ -85,24 +89,31 @@ public:
 	std::string render() const;
 
 private:
+	/// A template parsed into text, parameters, lists and conditions, defined in Whiskers.cpp.
+	struct Template;
+
 	// Prevent implicit cast to bool
 	Whiskers& operator()(std::string _parameter, long long);
 	void checkParameterValid(std::string const& _parameter) const;
 	void checkParameterUnknown(std::string const& _parameter) const;
 
-	static std::string replace(
-		std::string const& _template,
+	/// @returns the parsed form of @a _template, parsing it only the first time it is requested.
+	static std::shared_ptr<Template const> compile(std::string const& _template);
+	/// Parses the part of @a _template between @a _begin and @a _end.
+	static std::unique_ptr<Template> parse(std::string const& _template, size_t _begin, size_t _end);
+
+	/// Appends @a _template to @a _result. Values of regular parameters are taken from
+	/// @a _listElement (if not null) and @a _parameters.
+	static void render(
+		std::string& _result,
+		Template const& _template,
 		StringMap const& _parameters,
+		StringMap const* _listElement,
 		std::map<std::string, bool> const& _conditions,
-		StringListMap const& _listParameters = StringListMap()
+		StringListMap const& _listParameters
 	);
 
-	static std::string paramRegex() { return "[a-zA-Z0-9_$-]+"; }
-
-	/// Joins the two maps throwing an exception if two keys are equal.
-	static StringMap joinMaps(StringMap const& _a, StringMap const& _b);
-
-	std::string m_template;
+	std::shared_ptr<Template const> m_template;
 	StringMap m_parameters;
 	std::map<std::string, bool> m_conditions;
 	StringListMap m_listParameters;
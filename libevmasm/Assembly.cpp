@@ -26,10 +26,16 @@
 #include <libevmasm/PeepholeOptimiser.h>
 #include <libevmasm/JumpdestRemover.h>
 #include <libevmasm/BlockDeduplicator.h>
+#include <libevmasm/BlockLayoutOptimiser.h>
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/GasMeter.h>
+#include <libevmasm/OptimiserStatistics.h>
+#include <libevmasm/SemanticInformation.h>
 
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <thread>
 #include <json/json.h>
 
 using namespace std;
@@ -52,6 +58,15 @@ void Assembly::append(Assembly const& _a)
 		case PushSubSize:
 			i.setData(i.data() + m_subs.size());
 			break;
+		case PushTagTable:
+		{
+			vector<size_t> tags = i.tagTableEntries();
+			for (size_t& tag: tags)
+				if (tag != 0)
+					tag += m_usedTags;
+			i.setTagTableEntries(tags);
+			break;
+		}
 		default:
 			break;
 		}
@@ -322,6 +337,9 @@ Json::Value Assembly::assemblyJSON(StringMap const& _sourceCodes) const
 		case PushData:
 			collection.append(createJsonValue("PUSH data", i.location().start, i.location().end, toStringInHex(i.data())));
 			break;
+		case PushTagTable:
+			collection.append(createJsonValue("PUSH [tagtable]", i.location().start, i.location().end, toStringInHex(i.data())));
+			break;
 		default:
 			BOOST_THROW_EXCEPTION(InvalidOpcode());
 		}
@@ -388,26 +406,135 @@ Assembly& Assembly::optimise(OptimiserSettings const& _settings)
 	return *this;
 }
 
+namespace
+{
+
+/// @returns the gas needed to run each of the items once. Instructions whose costs depend
+/// on their arguments or the state only contribute their fixed costs, if any.
+bigint estimatedRunGas(AssemblyItems const& _items, EVMVersion _evmVersion)
+{
+	bigint gas = 0;
+	for (AssemblyItem const& item: _items)
+		if (item.type() == Tag)
+			gas += GasMeter::runGas(Instruction::JUMPDEST);
+		else if (item.type() != Operation)
+			gas += GasMeter::runGas(Instruction::PUSH1);
+		else if (item.instruction() == Instruction::SLOAD)
+			gas += GasCosts::sloadGas(_evmVersion);
+		else if (item.instruction() == Instruction::EXP)
+			gas += GasCosts::expGas;
+		else if (item.instruction() == Instruction::KECCAK256)
+			gas += GasCosts::keccak256Gas;
+		else if (instructionInfo(item.instruction()).gasPriceTier < Tier::ExtCode)
+			gas += GasMeter::runGas(item.instruction());
+	return gas;
+}
+
+/// Records the effect of an optimiser step on the items in the statistics, if they are requested.
+class StepRecorder
+{
+public:
+	StepRecorder(
+		OptimiserStatistics* _statistics,
+		char const* _step,
+		AssemblyItems const& _items,
+		EVMVersion _evmVersion
+	):
+		m_statistics(_statistics), m_items(_items), m_evmVersion(_evmVersion)
+	{
+		if (!m_statistics)
+			return;
+		m_run.optimiser = "evmasm";
+		m_run.step = _step;
+		m_run.sizeBefore = m_items.size();
+		m_bytesBefore = bytesRequired(m_items, 3);
+		m_gasBefore = estimatedRunGas(m_items, m_evmVersion);
+		m_start = chrono::steady_clock::now();
+	}
+
+	/// Records the run, @a _changed specifies whether the step modified the items.
+	void stop(bool _changed)
+	{
+		if (!m_statistics)
+			return;
+		m_run.time = chrono::duration<double, milli>(chrono::steady_clock::now() - m_start).count();
+		m_run.sizeAfter = m_items.size();
+		m_run.bytesDelta = static_cast<long long>(bytesRequired(m_items, 3)) - static_cast<long long>(m_bytesBefore);
+		m_run.gasDelta = static_cast<long long>(estimatedRunGas(m_items, m_evmVersion) - m_gasBefore);
+		m_run.changed = _changed;
+		m_statistics->record(move(m_run));
+	}
+
+private:
+	OptimiserStatistics* m_statistics;
+	AssemblyItems const& m_items;
+	EVMVersion m_evmVersion;
+	OptimiserStepRun m_run;
+	size_t m_bytesBefore = 0;
+	bigint m_gasBefore;
+	chrono::steady_clock::time_point m_start;
+};
+
+}
+
 map<u256, u256> Assembly::optimiseInternal(
 	OptimiserSettings const& _settings,
 	std::set<size_t> _tagsReferencedFromOutside
 )
 {
 	// Run optimisation for sub-assemblies.
-	for (size_t subId = 0; subId < m_subs.size(); ++subId)
-	{
+	vector<map<u256, u256>> subTagReplacements(m_subs.size());
+	auto optimiseSub = [&](size_t _subId) {
 		OptimiserSettings settings = _settings;
 		// Disable creation mode for sub-assemblies.
 		settings.isCreation = false;
-		map<u256, u256> subTagReplacements = m_subs[subId]->optimiseInternal(
+		subTagReplacements[_subId] = m_subs[_subId]->optimiseInternal(
 			settings,
-			JumpdestRemover::referencedTags(m_items, subId)
+			JumpdestRemover::referencedTags(m_items, _subId)
 		);
-		// Apply the replacements (can be empty).
-		BlockDeduplicator::applyTagReplacement(m_items, subTagReplacements, subId);
+	};
+	set<Assembly const*> visited;
+	if (m_subs.size() > 1 && subAssembliesDistinct(visited))
+	{
+		// The sub-assemblies only read m_items, which is not modified until all of them are done.
+		vector<exception_ptr> exceptions(m_subs.size());
+		atomic<size_t> nextSub{0};
+		auto worker = [&]() {
+			for (size_t i = nextSub++; i < m_subs.size(); i = nextSub++)
+				try
+				{
+					optimiseSub(i);
+				}
+				catch (...)
+				{
+					exceptions[i] = current_exception();
+				}
+		};
+
+		size_t workers = min<size_t>(max(thread::hardware_concurrency(), 1u), m_subs.size());
+		vector<thread> threads;
+		for (size_t i = 1; i < workers; ++i)
+			threads.emplace_back(worker);
+		worker();
+		for (auto& thread: threads)
+			thread.join();
+
+		for (auto const& exception: exceptions)
+			if (exception)
+				rethrow_exception(exception);
 	}
+	else
+		for (size_t subId = 0; subId < m_subs.size(); ++subId)
+			optimiseSub(subId);
+	// Apply the replacements (can be empty). Each of them only touches the tags of its own sub-assembly.
+	for (size_t subId = 0; subId < m_subs.size(); ++subId)
+		BlockDeduplicator::applyTagReplacement(m_items, subTagReplacements[subId], subId);
 
 	map<u256, u256> tagReplacements;
+	// Blocks the CSE did not change in a previous iteration. Its result only depends
+	// on the block itself, so they are skipped unless they change.
+	set<AssemblyItems> blocksUnchangedByCSE;
+	bool blocksUnchangedUseMSize = false;
 	// Iterate until no new optimisation possibilities are found.
 	for (unsigned count = 1; count > 0;)
 	{
@@ -415,26 +542,43 @@ map<u256, u256> Assembly::optimiseInternal(
 
 		if (_settings.runJumpdestRemover)
 		{
+			StepRecorder recorder{_settings.statistics, "jumpdestRemover", m_items, _settings.evmVersion};
 			JumpdestRemover jumpdestOpt{m_items};
-			if (jumpdestOpt.optimise(_tagsReferencedFromOutside))
+			bool changed = jumpdestOpt.optimise(_tagsReferencedFromOutside);
+			recorder.stop(changed);
+			if (changed)
+				count++;
+		}
+
+		// This only reorders the code, the peephole optimiser removes the jumps.
+		if (_settings.runBlockLayout)
+		{
+			StepRecorder recorder{_settings.statistics, "blockLayout", m_items, _settings.evmVersion};
+			BlockLayoutOptimiser layoutOpt{m_items};
+			bool changed = layoutOpt.optimise();
+			recorder.stop(changed);
+			if (changed)
 				count++;
 		}
 
 		if (_settings.runPeephole)
 		{
+			StepRecorder recorder{_settings.statistics, "peephole", m_items, _settings.evmVersion};
 			PeepholeOptimiser peepOpt{m_items};
-			while (peepOpt.optimise())
-			{
+			bool changed = peepOpt.optimise();
+			recorder.stop(changed);
+			if (changed)
 				count++;
-				assertThrow(count < 64000, OptimizerException, "Peephole optimizer seems to be stuck.");
-			}
 		}
 
 		// This only modifies PushTags, we have to run again to actually remove code.
 		if (_settings.runDeduplicate)
 		{
+			StepRecorder recorder{_settings.statistics, "deduplicate", m_items, _settings.evmVersion};
 			BlockDeduplicator dedup{m_items};
-			if (dedup.deduplicate())
+			bool changed = dedup.deduplicate();
+			recorder.stop(changed);
+			if (changed)
 			{
 				for (auto const& replacement: dedup.replacedTags())
 				{
@@ -461,13 +605,33 @@ map<u256, u256> Assembly::optimiseInternal(
 			// Control flow graph optimization has been here before but is disabled because it
 			// assumes we only jump to tags that are pushed. This is not the case anymore with
 			// function types that can be stored in storage.
+			StepRecorder recorder{_settings.statistics, "cse", m_items, _settings.evmVersion};
+			unsigned countBefore = count;
 			AssemblyItems optimisedItems;
 
 			bool usesMSize = (find(m_items.begin(), m_items.end(), AssemblyItem{Instruction::MSIZE}) != m_items.end());
+			if (usesMSize != blocksUnchangedUseMSize)
+			{
+				blocksUnchangedByCSE.clear();
+				blocksUnchangedUseMSize = usesMSize;
+			}
 
 			auto iter = m_items.begin();
 			while (iter != m_items.end())
 			{
+				auto blockEnd = find_if(iter, m_items.end(), [&](AssemblyItem const& _item) {
+					return SemanticInformation::breaksCSEAnalysisBlock(_item, usesMSize);
+				});
+				if (blockEnd != m_items.end())
+					++blockEnd;
+				AssemblyItems block(iter, blockEnd);
+				if (blocksUnchangedByCSE.count(block))
+				{
+					copy(iter, blockEnd, back_inserter(optimisedItems));
+					iter = blockEnd;
+					continue;
+				}
+
 				KnownState emptyState;
 				CommonSubexpressionEliminator eliminator{emptyState};
 				auto orig = iter;
@@ -490,42 +654,185 @@ map<u256, u256> Assembly::optimiseInternal(
 					// reorganise the expression tree, but not all leaves are available.
 				}
 
+				assertThrow(iter == blockEnd, OptimizerException, "Unexpected end of CSE block.");
 				if (shouldReplace)
 				{
 					count++;
 					optimisedItems += optimisedChunk;
 				}
 				else
+				{
 					copy(orig, iter, back_inserter(optimisedItems));
+					blocksUnchangedByCSE.insert(move(block));
+				}
 			}
 			if (optimisedItems.size() < m_items.size())
 			{
 				m_items = move(optimisedItems);
 				count++;
 			}
+			recorder.stop(count > countBefore);
 		}
 	}
 
 	if (_settings.runConstantOptimiser)
-		ConstantOptimisationMethod::optimiseConstants(
+	{
+		StepRecorder recorder{_settings.statistics, "constantOptimizer", m_items, _settings.evmVersion};
+		unsigned optimisations = ConstantOptimisationMethod::optimiseConstants(
 			_settings.isCreation,
 			_settings.isCreation ? 1 : _settings.expectedExecutionsPerDeployment,
 			_settings.evmVersion,
 			*this
 		);
+		recorder.stop(optimisations > 0);
+	}
 
 	return tagReplacements;
 }
 
-LinkerObject const& Assembly::assemble() const
+bool Assembly::subAssembliesDistinct(set<Assembly const*>& _visited) const
+{
+	for (auto const& sub: m_subs)
+		if (!_visited.insert(sub.get()).second || !sub->subAssembliesDistinct(_visited))
+			return false;
+	return true;
+}
+
+namespace
+{
+
+/**
+ * Appends the compressed source mapping entries of assembly items to a string.
+ * Each entry is of the form "start:length:sourceIndex:jump", components equal to the
+ * previous entry are left out and trailing empty components are removed.
+ */
+class SourceMappingEncoder
+{
+public:
+	SourceMappingEncoder(map<string, unsigned> const& _sourceIndices, string& _target, size_t _items):
+		m_sourceIndices(_sourceIndices), m_target(_target)
+	{
+		// Most entries only consist of a separator or of a few short numbers.
+		m_target.reserve(m_target.size() + 8 * _items);
+	}
+
+	void append(AssemblyItem const& _item)
+	{
+		if (!m_first)
+			m_target += ';';
+		m_first = false;
+
+		AssemblyItem::InternedLocation const& location = _item.internedLocation();
+		int length = location.start != -1 && location.end != -1 ? location.end - location.start : -1;
+		int sourceIndex = this->sourceIndex(location.source);
+		char jump = '-';
+		if (_item.getJumpType() == AssemblyItem::JumpType::IntoFunction)
+			jump = 'i';
+		else if (_item.getJumpType() == AssemblyItem::JumpType::OutOfFunction)
+			jump = 'o';
+
+		unsigned components = 4;
+		if (jump == m_prevJump)
+		{
+			components--;
+			if (sourceIndex == m_prevSourceIndex)
+			{
+				components--;
+				if (length == m_prevLength)
+				{
+					components--;
+					if (location.start == m_prevStart)
+						components--;
+				}
+			}
+		}
+
+		if (components-- > 0)
+		{
+			if (location.start != m_prevStart)
+				m_target += to_string(location.start);
+			if (components-- > 0)
+			{
+				m_target += ':';
+				if (length != m_prevLength)
+					m_target += to_string(length);
+				if (components-- > 0)
+				{
+					m_target += ':';
+					if (sourceIndex != m_prevSourceIndex)
+						m_target += to_string(sourceIndex);
+					if (components-- > 0)
+					{
+						m_target += ':';
+						if (jump != m_prevJump)
+							m_target += jump;
+					}
+				}
+			}
+		}
+
+		m_prevStart = location.start;
+		m_prevLength = length;
+		m_prevSourceIndex = sourceIndex;
+		m_prevJump = jump;
+	}
+
+private:
+	/// @returns the index of the interned source @a _source in the source mapping or -1 if it is unknown.
+	/// Consecutive items mostly stem from the same source, so the last lookup is cached.
+	int sourceIndex(uint32_t _source)
+	{
+		if (_source != m_lastSource)
+		{
+			m_lastSource = _source;
+			m_lastSourceIndex = -1;
+			if (shared_ptr<CharStream> source = AssemblyItem::internedSource(_source))
+			{
+				auto it = m_sourceIndices.find(source->name());
+				if (it != m_sourceIndices.end())
+					m_lastSourceIndex = int(it->second);
+			}
+		}
+		return m_lastSourceIndex;
+	}
+
+	map<string, unsigned> const& m_sourceIndices;
+	string& m_target;
+	bool m_first = true;
+	int m_prevStart = -1;
+	int m_prevLength = -1;
+	int m_prevSourceIndex = -1;
+	char m_prevJump = 0;
+	/// Zero is the interned index of a missing source.
+	uint32_t m_lastSource = 0;
+	int m_lastSourceIndex = -1;
+};
+
+}
+
+LinkerObject const& Assembly::assemble(map<string, unsigned> const* _sourceIndices) const
 {
 	if (!m_assembledObject.bytecode.empty())
+	{
+		if (_sourceIndices)
+		{
+			// Assembled before without source indices, generate the mappings separately.
+			if (m_sourceMapping.empty() && !m_items.empty())
+			{
+				SourceMappingEncoder encoder(*_sourceIndices, m_sourceMapping, m_items.size());
+				for (AssemblyItem const& item: m_items)
+					encoder.append(item);
+			}
+			for (auto const& sub: m_subs)
+				sub->assemble(_sourceIndices);
+		}
 		return m_assembledObject;
+	}
 
 	size_t subTagSize = 1;
 	for (auto const& sub: m_subs)
 	{
-		sub->assemble();
+		sub->assemble(_sourceIndices);
 		for (size_t tagPos: sub->m_tagPositionsInBytecode)
 			if (tagPos != size_t(-1) && tagPos > subTagSize)
 				subTagSize = tagPos;
@@ -535,7 +842,9 @@ LinkerObject const& Assembly::assemble() const
 
 	size_t bytesRequiredForCode = bytesRequired(subTagSize);
 	m_tagPositionsInBytecode = vector<size_t>(m_usedTags, -1);
-	map<size_t, pair<size_t, size_t>> tagRef;
+	// Positions are only appended in increasing order, so vectors suffice.
+	vector<pair<size_t, pair<size_t, size_t>>> tagRef;
+	vector<pair<size_t, vector<size_t>>> tagTableRef;
 	multimap<h256, unsigned> dataRef;
 	multimap<size_t, size_t> subRef;
 	vector<unsigned> sizeRef; ///< Pointers to code locations where the size of the program is inserted
@@ -544,14 +853,22 @@ LinkerObject const& Assembly::assemble() const
 
 	unsigned bytesRequiredIncludingData = bytesRequiredForCode + 1 + m_auxiliaryData.size();
 	for (auto const& sub: m_subs)
-		bytesRequiredIncludingData += sub->assemble().bytecode.size();
+		bytesRequiredIncludingData += sub->m_assembledObject.bytecode.size();
 
 	unsigned bytesPerDataRef = dev::bytesRequired(bytesRequiredIncludingData);
 	uint8_t dataRefPush = (uint8_t)Instruction::PUSH1 - 1 + bytesPerDataRef;
 	ret.bytecode.reserve(bytesRequiredIncludingData);
 
+	unique_ptr<SourceMappingEncoder> sourceMappingEncoder;
+	m_sourceMapping.clear();
+	if (_sourceIndices)
+		sourceMappingEncoder = make_unique<SourceMappingEncoder>(*_sourceIndices, m_sourceMapping, m_items.size());
+
 	for (AssemblyItem const& i: m_items)
 	{
+		if (sourceMappingEncoder)
+			sourceMappingEncoder->append(i);
+
 		// store position of the invalid jump destination
 		if (i.type() != Tag && m_tagPositionsInBytecode[0] == size_t(-1))
 			m_tagPositionsInBytecode[0] = ret.bytecode.size();
@@ -586,10 +903,15 @@ LinkerObject const& Assembly::assemble() const
 		case PushTag:
 		{
 			ret.bytecode.push_back(tagPush);
-			tagRef[ret.bytecode.size()] = i.splitForeignPushTag();
+			tagRef.emplace_back(ret.bytecode.size(), i.splitForeignPushTag());
 			ret.bytecode.resize(ret.bytecode.size() + bytesPerTag);
 			break;
 		}
+		case PushTagTable:
+			ret.bytecode.push_back(uint8_t(Instruction::PUSH32));
+			tagTableRef.emplace_back(ret.bytecode.size(), i.tagTableEntries());
+			ret.bytecode.resize(ret.bytecode.size() + 32);
+			break;
 		case PushData:
 			ret.bytecode.push_back(dataRefPush);
 			dataRef.insert(make_pair((h256)i.data(), ret.bytecode.size()));
@@ -602,7 +924,7 @@ LinkerObject const& Assembly::assemble() const
 			break;
 		case PushSubSize:
 		{
-			auto s = m_subs.at(size_t(i.data()))->assemble().bytecode.size();
+			auto s = m_subs.at(size_t(i.data()))->m_assembledObject.bytecode.size();
 			i.setPushedValue(u256(s));
 			uint8_t b = max<unsigned>(1, dev::bytesRequired(s));
 			ret.bytecode.push_back((uint8_t)Instruction::PUSH1 - 1 + b);
@@ -654,7 +976,7 @@ LinkerObject const& Assembly::assemble() const
 			bytesRef r(ret.bytecode.data() + ref->second, bytesPerDataRef);
 			toBigEndian(ret.bytecode.size(), r);
 		}
-		ret.append(m_subs[i]->assemble());
+		ret.append(m_subs[i]->m_assembledObject);
 	}
 	for (auto const& i: tagRef)
 	{
@@ -673,6 +995,23 @@ LinkerObject const& Assembly::assemble() const
 		bytesRef r(ret.bytecode.data() + i.first, bytesPerTag);
 		toBigEndian(pos, r);
 	}
+	for (auto const& i: tagTableRef)
+	{
+		u256 table;
+		for (size_t entry = 0; entry < i.second.size(); ++entry)
+		{
+			size_t tagId = i.second[entry];
+			if (tagId == 0)
+				continue;
+			assertThrow(tagId < m_tagPositionsInBytecode.size(), AssemblyException, "Reference to non-existing tag.");
+			size_t pos = m_tagPositionsInBytecode[tagId];
+			assertThrow(pos != size_t(-1), AssemblyException, "Reference to tag without position.");
+			assertThrow(pos < 0x10000, AssemblyException, "Tag too large for tag table.");
+			table |= u256(pos) << (16 * entry);
+		}
+		bytesRef r(ret.bytecode.data() + i.first, 32);
+		toBigEndian(table, r);
+	}
 	for (auto const& dataItem: m_data)
 	{
 		auto references = dataRef.equal_range(dataItem.first);
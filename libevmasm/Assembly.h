@@ -40,6 +40,7 @@ namespace dev
 namespace eth
 {
 
+class OptimiserStatistics;
 using AssemblyPointer = std::shared_ptr<Assembly>;
 
 class Assembly
@@ -97,7 +98,12 @@ public:
 	void setSourceLocation(langutil::SourceLocation const& _location) { m_currentSourceLocation = _location; }
 
 	/// Assembles the assembly into bytecode. The assembly should not be modified after this call, since the assembled version is cached.
-	LinkerObject const& assemble() const;
+	/// If @a _sourceIndices is given, the compressed source mappings of this assembly and its sub-assemblies
+	/// are generated in the same pass, using the given indices for the source names.
+	LinkerObject const& assemble(std::map<std::string, unsigned> const* _sourceIndices = nullptr) const;
+	/// @returns the compressed source mapping (one entry per assembly item) generated by assemble
+	/// or an empty string if assemble was not called with source indices.
+	std::string const& sourceMapping() const { return m_sourceMapping; }
 
 	struct OptimiserSettings
 	{
@@ -107,10 +113,13 @@ public:
 		bool runDeduplicate = false;
 		bool runCSE = false;
 		bool runConstantOptimiser = false;
+		bool runBlockLayout = false;
 		langutil::EVMVersion evmVersion;
 		/// This specifies an estimate on how often each opcode in this assembly will be executed,
 		/// i.e. use a small value to optimise for size and a large value to optimise for runtime gas usage.
 		size_t expectedExecutionsPerDeployment = 200;
+		/// If set, the effect of each optimiser step is recorded here.
+		OptimiserStatistics* statistics = nullptr;
 	};
 
 	/// Modify and return the current assembly such that creation and execution gas usage
@@ -156,6 +165,9 @@ protected:
 	/// returns the replaced tags. Also takes an argument containing the tags of this assembly
 	/// that are referenced in a super-assembly.
 	std::map<u256, u256> optimiseInternal(OptimiserSettings const& _settings, std::set<size_t> _tagsReferencedFromOutside);
+	/// @returns false if an assembly occurs more than once among the (nested) sub-assemblies
+	/// or in @a _visited, in which case they cannot be optimised concurrently.
+	bool subAssembliesDistinct(std::set<Assembly const*>& _visited) const;
 
 	unsigned bytesRequired(unsigned subTagSize) const;
 
@@ -176,6 +188,7 @@ protected:
 	std::map<h256, std::string> m_libraries; ///< Identifiers of libraries to be linked.
 
 	mutable LinkerObject m_assembledObject;
+	mutable std::string m_sourceMapping;
 	mutable std::vector<size_t> m_tagPositionsInBytecode;
 
 	int m_deposit = 0;
@@ -20,7 +20,13 @@
 #include <libdevcore/CommonData.h>
 #include <libdevcore/FixedHash.h>
 
+#include <boost/algorithm/string/join.hpp>
+#include <boost/functional/hash.hpp>
+
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 using namespace std;
 using namespace dev;
@@ -28,6 +34,234 @@ using namespace dev::eth;
 
 static_assert(sizeof(size_t) <= 8, "size_t must be at most 64-bits wide");
 
+namespace
+{
+
+/**
+ * Storage whose elements never move, so that they can be read without a lock
+ * while new elements are appended under the lock of the location pool.
+ */
+template <class T>
+class ChunkedStorage
+{
+public:
+	T& operator[](size_t _index) { return m_chunks[_index >> c_chunkBits][_index & (c_chunkSize - 1)]; }
+	T const& operator[](size_t _index) const { return m_chunks[_index >> c_chunkBits][_index & (c_chunkSize - 1)]; }
+
+	/// Appends a default-constructed element and @returns its index.
+	uint32_t append()
+	{
+		assertThrow(m_size < c_chunkSize * c_maxChunks, AssemblyException, "Too many source locations.");
+		if (m_size % c_chunkSize == 0)
+			m_chunks[m_size >> c_chunkBits].reset(new T[c_chunkSize]);
+		return uint32_t(m_size++);
+	}
+
+private:
+	static size_t const c_chunkBits = 12;
+	static size_t const c_chunkSize = size_t(1) << c_chunkBits;
+	static size_t const c_maxChunks = 4096;
+
+	std::unique_ptr<T[]> m_chunks[c_maxChunks];
+	size_t m_size = 0;
+};
+
+struct InternedSource
+{
+	weak_ptr<langutil::CharStream> source;
+	/// Address of the source, only used to compare with live sources.
+	langutil::CharStream const* sourcePointer = nullptr;
+};
+
+/**
+ * Pool of the source locations of all assembly items, such that items only have to store
+ * a 32-bit index. Locations do not keep their source alive. Once a source has been freed,
+ * its locations and its index are reused, so items must not outlive the source of their location.
+ * Index zero stands for an empty location without source and for no source, respectively.
+ */
+class LocationPool
+{
+public:
+	LocationPool()
+	{
+		m_locations[m_locations.append()] = AssemblyItem::InternedLocation{-1, -1, 0};
+		m_sources.append();
+	}
+
+	uint32_t intern(langutil::SourceLocation const& _location)
+	{
+		if (_location.isEmpty() && !_location.source)
+			return 0;
+
+		lock_guard<mutex> lock(m_mutex);
+		// Locations of freed sources are dropped whenever the pool has doubled in size since the last time.
+		if (m_locationIndices.size() > 2 * m_prunedSize)
+			prune();
+		uint32_t source = internSource(_location.source);
+		uint32_t& index = m_locationIndices[Key{_location.start, _location.end, source}];
+		if (index == 0)
+		{
+			index = allocate(m_locations, m_freeLocations);
+			m_locations[index] = AssemblyItem::InternedLocation{_location.start, _location.end, source};
+		}
+		return index;
+	}
+
+	AssemblyItem::InternedLocation const& location(uint32_t _index) const { return m_locations[_index]; }
+	shared_ptr<langutil::CharStream> source(uint32_t _index) const { return m_sources[_index].source.lock(); }
+
+private:
+	using Key = tuple<int, int, uint32_t>;
+
+	uint32_t internSource(shared_ptr<langutil::CharStream> const& _source)
+	{
+		if (!_source)
+			return 0;
+		auto it = m_sourceIndices.find(_source.get());
+		if (it != m_sourceIndices.end() && m_sources[it->second].source.expired())
+		{
+			// The address of a freed source has been reused by a new source.
+			prune();
+			it = m_sourceIndices.find(_source.get());
+		}
+		if (it != m_sourceIndices.end())
+			return it->second;
+		uint32_t index = allocate(m_sources, m_freeSources);
+		m_sources[index] = InternedSource{_source, _source.get()};
+		m_sourceIndices[_source.get()] = index;
+		return index;
+	}
+
+	/// Frees the locations and indices of all sources that have been freed.
+	void prune()
+	{
+		for (auto it = m_locationIndices.begin(); it != m_locationIndices.end();)
+		{
+			uint32_t source = get<2>(it->first);
+			if (source != 0 && m_sources[source].source.expired())
+			{
+				m_freeLocations.push_back(it->second);
+				it = m_locationIndices.erase(it);
+			}
+			else
+				++it;
+		}
+		for (auto it = m_sourceIndices.begin(); it != m_sourceIndices.end();)
+			if (m_sources[it->second].source.expired())
+			{
+				m_sources[it->second] = InternedSource{};
+				m_freeSources.push_back(it->second);
+				it = m_sourceIndices.erase(it);
+			}
+			else
+				++it;
+		m_prunedSize = m_locationIndices.size();
+	}
+
+	template <class T>
+	static uint32_t allocate(ChunkedStorage<T>& _storage, vector<uint32_t>& _free)
+	{
+		if (_free.empty())
+			return _storage.append();
+		uint32_t index = _free.back();
+		_free.pop_back();
+		return index;
+	}
+
+	mutex m_mutex;
+	ChunkedStorage<AssemblyItem::InternedLocation> m_locations;
+	ChunkedStorage<InternedSource> m_sources;
+	map<Key, uint32_t> m_locationIndices;
+	map<langutil::CharStream const*, uint32_t> m_sourceIndices;
+	vector<uint32_t> m_freeLocations;
+	vector<uint32_t> m_freeSources;
+	size_t m_prunedSize = 0;
+};
+
+LocationPool& locationPool()
+{
+	static LocationPool pool;
+	return pool;
+}
+
+}
+
+void AssemblyItem::setLocation(langutil::SourceLocation const& _location)
+{
+	// Consecutive items mostly have the same location, so look at the last
+	// location of this thread first. As long as its source is alive, its index is valid.
+	struct LastLocation
+	{
+		uint32_t index = 0;
+		int start = -1;
+		int end = -1;
+		langutil::CharStream const* sourcePointer = nullptr;
+		weak_ptr<langutil::CharStream> source;
+	};
+	static thread_local LastLocation last;
+	if (
+		last.index != 0 &&
+		last.start == _location.start &&
+		last.end == _location.end &&
+		last.sourcePointer == _location.source.get() &&
+		(!_location.source || !last.source.expired())
+	)
+	{
+		m_location = last.index;
+		return;
+	}
+	m_location = locationPool().intern(_location);
+	last = LastLocation{m_location, _location.start, _location.end, _location.source.get(), _location.source};
+}
+
+langutil::SourceLocation AssemblyItem::location() const
+{
+	InternedLocation const& interned = internedLocation();
+	langutil::SourceLocation location;
+	location.start = interned.start;
+	location.end = interned.end;
+	location.source = internedSource(interned.source);
+	return location;
+}
+
+AssemblyItem::InternedLocation const& AssemblyItem::internedLocation() const
+{
+	return locationPool().location(m_location);
+}
+
+shared_ptr<langutil::CharStream> AssemblyItem::internedSource(uint32_t _source)
+{
+	return locationPool().source(_source);
+}
+
+void AssemblyItem::setData(u256 const& _data)
+{
+	assertThrow(m_type != Operation, Exception, "");
+	if (_data >> 64 == 0)
+	{
+		m_smallData = uint64_t(_data);
+		m_bigData.reset();
+	}
+	else
+		m_bigData = make_shared<u256 const>(_data);
+}
+
+size_t AssemblyItem::hash() const
+{
+	size_t seed = size_t(m_type);
+	if (m_type == Operation)
+		boost::hash_combine(seed, uint8_t(m_instruction));
+	else if (!m_bigData)
+		boost::hash_combine(seed, m_smallData);
+	else
+	{
+		// Only hash the lowest and highest bits, which is enough to distinguish most values.
+		boost::hash_combine(seed, uint64_t(*m_bigData & u256(numeric_limits<uint64_t>::max())));
+		boost::hash_combine(seed, uint64_t(*m_bigData >> 192));
+	}
+	return seed;
+}
+
 AssemblyItem AssemblyItem::toSubAssemblyTag(size_t _subId) const
 {
 	assertThrow(data() < (u256(1) << 64), Exception, "Tag already has subassembly set.");
@@ -57,6 +291,35 @@ void AssemblyItem::setPushTagSubIdAndTag(size_t _subId, size_t _tag)
 	setData(data);
 }
 
+AssemblyItem AssemblyItem::tagTable(vector<size_t> const& _tags, langutil::SourceLocation const& _location)
+{
+	AssemblyItem table(PushTagTable, 0, _location);
+	table.setTagTableEntries(_tags);
+	return table;
+}
+
+vector<size_t> AssemblyItem::tagTableEntries() const
+{
+	assertThrow(m_type == PushTagTable, Exception, "");
+	vector<size_t> tags;
+	for (size_t i = 0; i < tagTableSize; ++i)
+		tags.push_back(size_t((data() >> (16 * i)) & 0xffff));
+	return tags;
+}
+
+void AssemblyItem::setTagTableEntries(vector<size_t> const& _tags)
+{
+	assertThrow(m_type == PushTagTable, Exception, "");
+	assertThrow(_tags.size() <= tagTableSize, Exception, "Too many tags for tag table.");
+	u256 data;
+	for (size_t i = 0; i < _tags.size(); ++i)
+	{
+		assertThrow(_tags[i] < 0x10000, Exception, "Tag id too large for tag table.");
+		data |= u256(_tags[i]) << (16 * i);
+	}
+	setData(data);
+}
+
 unsigned AssemblyItem::bytesRequired(unsigned _addressLength) const
 {
 	switch (m_type)
@@ -65,6 +328,7 @@ unsigned AssemblyItem::bytesRequired(unsigned _addressLength) const
 	case Tag: // 1 byte for the JUMPDEST
 		return 1;
 	case PushString:
+	case PushTagTable:
 		return 1 + 32;
 	case Push:
 		return 1 + max<unsigned>(1, dev::bytesRequired(data()));
@@ -107,6 +371,7 @@ int AssemblyItem::returnValues() const
 	case PushProgramSize:
 	case PushLibraryAddress:
 	case PushDeployTimeAddress:
+	case PushTagTable:
 		return 1;
 	case Tag:
 		return 0;
@@ -133,6 +398,7 @@ bool AssemblyItem::canBeFunctional() const
 	case PushProgramSize:
 	case PushLibraryAddress:
 	case PushDeployTimeAddress:
+	case PushTagTable:
 		return true;
 	case Tag:
 		return false;
@@ -208,6 +474,15 @@ string AssemblyItem::toAssemblyText() const
 	case PushDeployTimeAddress:
 		text = string("deployTimeAddress()");
 		break;
+	case PushTagTable:
+	{
+		vector<string> tags;
+		for (size_t tag: tagTableEntries())
+			if (tag != 0)
+				tags.push_back("tag_" + to_string(tag));
+		text = "tagTable(" + boost::algorithm::join(tags, ", ") + ")";
+		break;
+	}
 	case UndefinedItem:
 		assertThrow(false, AssemblyException, "Invalid assembly item.");
 		break;
@@ -273,6 +548,12 @@ ostream& dev::eth::operator<<(ostream& _out, AssemblyItem const& _item)
 	case PushDeployTimeAddress:
 		_out << " PushDeployTimeAddress";
 		break;
+	case PushTagTable:
+		_out << " PushTagTable";
+		for (size_t tag: _item.tagTableEntries())
+			if (tag != 0)
+				_out << " " << tag;
+		break;
 	case UndefinedItem:
 		_out << " ???";
 		break;
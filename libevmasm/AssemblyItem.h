@@ -46,7 +46,8 @@ enum AssemblyItemType {
 	Tag,
 	PushData,
 	PushLibraryAddress, ///< Push a currently unknown address of another (library) contract.
-	PushDeployTimeAddress ///< Push an address to be filled at deploy time. Should not be touched by the optimizer.
+	PushDeployTimeAddress, ///< Push an address to be filled at deploy time. Should not be touched by the optimizer.
+	PushTagTable ///< Push the positions of up to 16 tags, 16 bits each, the first tag in the lowest bits.
 };
 
 class Assembly;
@@ -56,21 +57,22 @@ class AssemblyItem
 public:
 	enum class JumpType { Ordinary, IntoFunction, OutOfFunction };
 
-	AssemblyItem(u256 _push, langutil::SourceLocation _location = langutil::SourceLocation()):
-		AssemblyItem(Push, std::move(_push), std::move(_location)) { }
-	AssemblyItem(Instruction _i, langutil::SourceLocation _location = langutil::SourceLocation()):
+	AssemblyItem(u256 _push, langutil::SourceLocation const& _location = langutil::SourceLocation()):
+		AssemblyItem(Push, std::move(_push), _location) { }
+	AssemblyItem(Instruction _i, langutil::SourceLocation const& _location = langutil::SourceLocation()):
 		m_type(Operation),
-		m_instruction(_i),
-		m_location(std::move(_location))
-	{}
-	AssemblyItem(AssemblyItemType _type, u256 _data = 0, langutil::SourceLocation _location = langutil::SourceLocation()):
-		m_type(_type),
-		m_location(std::move(_location))
+		m_instruction(_i)
+	{
+		setLocation(_location);
+	}
+	AssemblyItem(AssemblyItemType _type, u256 _data = 0, langutil::SourceLocation const& _location = langutil::SourceLocation()):
+		m_type(_type)
 	{
 		if (m_type == Operation)
 			m_instruction = Instruction(uint8_t(_data));
 		else
-			m_data = std::make_shared<u256>(std::move(_data));
+			setData(_data);
+		setLocation(_location);
 	}
 	AssemblyItem(AssemblyItem const&) = default;
 	AssemblyItem(AssemblyItem&&) = default;
@@ -88,9 +90,23 @@ public:
 	/// Sets sub-assembly part and tag for a push tag.
 	void setPushTagSubIdAndTag(size_t _subId, size_t _tag);
 
+	/// Maximal number of tags in a tag table.
+	static size_t const tagTableSize = 16;
+	/// @returns a tag table item pushing the positions of the (local) tags @a _tags.
+	/// The ids of the tags have to be smaller than 2**16.
+	static AssemblyItem tagTable(std::vector<size_t> const& _tags, langutil::SourceLocation const& _location = langutil::SourceLocation());
+	/// @returns the ids of the tags of a tag table, including zero for unused entries at the end.
+	std::vector<size_t> tagTableEntries() const;
+	/// Replaces the tags of a tag table.
+	void setTagTableEntries(std::vector<size_t> const& _tags);
+
 	AssemblyItemType type() const { return m_type; }
-	u256 const& data() const { assertThrow(m_type != Operation, Exception, ""); return *m_data; }
-	void setData(u256 const& _data) { assertThrow(m_type != Operation, Exception, ""); m_data = std::make_shared<u256>(_data); }
+	u256 data() const
+	{
+		assertThrow(m_type != Operation, Exception, "");
+		return m_bigData ? *m_bigData : u256(m_smallData);
+	}
+	void setData(u256 const& _data);
 
 	/// @returns the instruction of this item (only valid if type() == Operation)
 	Instruction instruction() const { assertThrow(m_type == Operation, Exception, ""); return m_instruction; }
@@ -102,10 +118,14 @@ public:
 			return false;
 		if (type() == Operation)
 			return instruction() == _other.instruction();
+		else if (!m_bigData && !_other.m_bigData)
+			return m_smallData == _other.m_smallData;
 		else
 			return data() == _other.data();
 	}
 	bool operator!=(AssemblyItem const& _other) const { return !operator==(_other); }
+	/// @returns a hash value compatible with operator==.
+	size_t hash() const;
 	/// Less-than operator compatible with operator==.
 	bool operator<(AssemblyItem const& _other) const
 	{
@@ -113,6 +133,8 @@ public:
 			return type() < _other.type();
 		else if (type() == Operation)
 			return instruction() < _other.instruction();
+		else if (!m_bigData && !_other.m_bigData)
+			return m_smallData < _other.m_smallData;
 		else
 			return data() < _other.data();
 	}
@@ -134,14 +156,31 @@ public:
 	/// @returns true if the assembly item can be used in a functional context.
 	bool canBeFunctional() const;
 
-	void setLocation(langutil::SourceLocation const& _location) { m_location = _location; }
-	langutil::SourceLocation const& location() const { return m_location; }
+	/// Source location as stored in the pool of interned locations. The source is referred
+	/// to by an index that is unique among the sources that are still alive, zero means no source.
+	struct InternedLocation
+	{
+		int start;
+		int end;
+		uint32_t source;
+	};
+
+	void setLocation(langutil::SourceLocation const& _location);
+	langutil::SourceLocation location() const;
+	/// @returns start, end and source index of the location without looking up the source itself.
+	InternedLocation const& internedLocation() const;
+	/// @returns the source with index @a _source as used by internedLocation().
+	static std::shared_ptr<langutil::CharStream> internedSource(uint32_t _source);
+	/// @returns true if the items have the same source location.
+	bool hasSameLocation(AssemblyItem const& _other) const { return m_location == _other.m_location; }
+	/// Sets the source location to the one of @a _other.
+	void copyLocation(AssemblyItem const& _other) { m_location = _other.m_location; }
 
 	void setJumpType(JumpType _jumpType) { m_jumpType = _jumpType; }
 	JumpType getJumpType() const { return m_jumpType; }
 	std::string getJumpTypeAsString() const;
 
-	void setPushedValue(u256 const& _value) const { m_pushedValue = std::make_shared<u256>(_value); }
+	void setPushedValue(u256 const& _value) const { m_pushedValue = std::make_shared<u256 const>(_value); }
 	u256 const* pushedValue() const { return m_pushedValue.get(); }
 
 	std::string toAssemblyText() const;
@@ -149,12 +188,18 @@ public:
 private:
 	AssemblyItemType m_type;
 	Instruction m_instruction; ///< Only valid if m_type == Operation
-	std::shared_ptr<u256> m_data; ///< Only valid if m_type != Operation
-	langutil::SourceLocation m_location;
 	JumpType m_jumpType = JumpType::Ordinary;
+	/// Data of the item if it fits into 64 bits, only valid if m_type != Operation.
+	uint64_t m_smallData = 0;
+	/// Data of the item if it does not fit into 64 bits. It is never modified
+	/// and shared by all copies of the item.
+	std::shared_ptr<u256 const> m_bigData;
+	/// Index of the source location in the pool of interned locations, such that items
+	/// with the same location have the same index, or zero for an empty location without source.
+	uint32_t m_location = 0;
 	/// Pushed value for operations with data to be determined during assembly stage,
 	/// e.g. PushSubSize, PushTag, PushSub, etc.
-	mutable std::shared_ptr<u256> m_pushedValue;
+	mutable std::shared_ptr<u256 const> m_pushedValue;
 };
 
 using AssemblyItems = std::vector<AssemblyItem>;
@@ -26,8 +26,8 @@
 #include <libevmasm/AssemblyItem.h>
 #include <libevmasm/SemanticInformation.h>
 
-#include <functional>
-#include <set>
+#include <algorithm>
+#include <unordered_map>
 
 using namespace std;
 using namespace dev;
@@ -36,8 +36,9 @@ using namespace dev::eth;
 
 bool BlockDeduplicator::deduplicate()
 {
-	// Compares indices based on the suffix that starts there, ignoring tags and stopping at
-	// opcodes that stop the control flow.
+	// Compares blocks based on the suffix that starts at their tag, ignoring tags and stopping at
+	// opcodes that stop the control flow. Candidates are found via a hash of that suffix and
+	// only compared item by item if their hashes are equal.
 
 	// Virtual tag that signifies "the current block" and which is used to optimise loops.
 	// We abort if this virtual tag actually exists.
@@ -48,45 +49,106 @@ bool BlockDeduplicator::deduplicate()
 	)
 		return false;
 
-	function<bool(size_t, size_t)> comparator = [&](size_t _i, size_t _j)
+	// To compare recursive loops, we have to already unify PushTag opcodes of the
+	// block's own tag.
+	auto blockBegin = [&](size_t _i, AssemblyItem& _pushOwnTag)
 	{
-		if (_i == _j)
-			return false;
+		_pushOwnTag = m_items.at(_i).pushTag();
+		// Skip the block's own tag.
+		return ++BlockIterator{m_items.begin() + _i, m_items.end(), &_pushOwnTag, &pushSelf};
+	};
+	BlockIterator end{m_items.end(), m_items.end()};
+
+	// Hashes of the suffixes that start at the tags, compatible with blocksEqual.
+	// The hash of the items x_0, x_1, ... of a suffix is h(x_0) + h(x_1) B + h(x_2) B^2 + ...,
+	// so the hashes of all suffixes are computed in a single pass from back to front.
+	// The pushes of a block's own tag are accounted for afterwards via the sum of B^k
+	// over their positions k.
+	auto suffixHashes = [&]()
+	{
+		uint64_t const base = 0x100000001b3;
+		// Inverse of the (odd) base modulo 2^64, via Newton iteration.
+		uint64_t inverseBase = base;
+		for (size_t i = 0; i < 5; ++i)
+			inverseBase *= 2 - base * inverseBase;
+
+		// Number of items before each position that are not tags, i.e. the exponent
+		// of the item at that position relative to the start of the code.
+		vector<size_t> positions(m_items.size() + 1, 0);
+		for (size_t i = 0; i < m_items.size(); ++i)
+			positions[i + 1] = positions[i] + (m_items[i].type() == Tag ? 0 : 1);
+		vector<uint64_t> powers(positions.back() + 1, 1);
+		vector<uint64_t> inversePowers(positions.back() + 1, 1);
+		for (size_t k = 1; k < powers.size(); ++k)
+		{
+			powers[k] = powers[k - 1] * base;
+			inversePowers[k] = inversePowers[k - 1] * inverseBase;
+		}
 
-		// To compare recursive loops, we have to already unify PushTag opcodes of the
-		// block's own tag.
+		// Indices of the pushes of each tag and prefix sums of their powers.
+		map<u256, pair<vector<size_t>, vector<uint64_t>>> pushes;
+		for (size_t i = 0; i < m_items.size(); ++i)
+			if (m_items[i].type() == PushTag)
+			{
+				auto& tagPushes = pushes[m_items[i].data()];
+				if (tagPushes.second.empty())
+					tagPushes.second.push_back(0);
+				tagPushes.first.push_back(i);
+				tagPushes.second.push_back(tagPushes.second.back() + powers[positions[i]]);
+			}
+
+		vector<uint64_t> hashes(m_items.size(), 0);
+		// Hash and end of the suffix starting at the next item that is not a tag.
+		uint64_t hash = 0;
+		size_t suffixEnd = m_items.size();
+		uint64_t const selfHash = pushSelf.hash();
+		for (size_t i = m_items.size(); i-- > 0;)
+		{
+			AssemblyItem const& item = m_items[i];
+			if (item.type() != Tag)
+			{
+				if (SemanticInformation::altersControlFlow(item) && item != AssemblyItem{Instruction::JUMPI})
+				{
+					hash = 0;
+					suffixEnd = i + 1;
+				}
+				hash = uint64_t(item.hash()) + base * hash;
+				continue;
+			}
+			hashes[i] = hash;
+			auto tagPushes = pushes.find(item.data());
+			if (tagPushes == pushes.end())
+				continue;
+			vector<size_t> const& indices = tagPushes->second.first;
+			vector<uint64_t> const& sums = tagPushes->second.second;
+			size_t first = size_t(lower_bound(indices.begin(), indices.end(), i) - indices.begin());
+			size_t last = size_t(lower_bound(indices.begin(), indices.end(), suffixEnd) - indices.begin());
+			uint64_t ownPushes = (sums[last] - sums[first]) * inversePowers[positions[i]];
+			hashes[i] += (selfHash - uint64_t(item.pushTag().hash())) * ownPushes;
+		}
+		return hashes;
+	};
+	auto blocksEqual = [&](size_t _i, size_t _j)
+	{
 		AssemblyItem pushFirstTag{pushSelf};
 		AssemblyItem pushSecondTag{pushSelf};
-
-		if (_i < m_items.size() && m_items.at(_i).type() == Tag)
-			pushFirstTag = m_items.at(_i).pushTag();
-		if (_j < m_items.size() && m_items.at(_j).type() == Tag)
-			pushSecondTag = m_items.at(_j).pushTag();
-
-		BlockIterator first{m_items.begin() + _i, m_items.end(), &pushFirstTag, &pushSelf};
-		BlockIterator second{m_items.begin() + _j, m_items.end(), &pushSecondTag, &pushSelf};
-		BlockIterator end{m_items.end(), m_items.end()};
-
-		if (first != end && (*first).type() == Tag)
-			++first;
-		if (second != end && (*second).type() == Tag)
-			++second;
-
-		return std::lexicographical_compare(first, end, second, end);
+		return std::equal(blockBegin(_i, pushFirstTag), end, blockBegin(_j, pushSecondTag), end);
 	};
 
 	size_t iterations = 0;
 	for (; ; ++iterations)
 	{
-		//@todo this should probably be optimized.
-		set<size_t, function<bool(size_t, size_t)>> blocksSeen(comparator);
+		vector<uint64_t> hashes = suffixHashes();
+		// Indices of the first tag of each distinct block, grouped by hash.
+		unordered_map<uint64_t, vector<size_t>> blocksSeen;
 		for (size_t i = 0; i < m_items.size(); ++i)
 		{
 			if (m_items.at(i).type() != Tag)
 				continue;
-			auto it = blocksSeen.find(i);
-			if (it == blocksSeen.end())
-				blocksSeen.insert(i);
+			vector<size_t>& candidates = blocksSeen[hashes[i]];
+			auto it = find_if(candidates.begin(), candidates.end(), [&](size_t _j) { return blocksEqual(i, _j); });
+			if (it == candidates.end())
+				candidates.push_back(i);
 			else
 				m_replacedTags[m_items.at(i).data()] = m_items.at(*it).data();
 		}
@@ -119,6 +181,20 @@ bool BlockDeduplicator::applyTagReplacement(
 				item.setPushTagSubIdAndTag(subId, size_t(it->second));
 			}
 		}
+		else if (item.type() == PushTagTable && _subId == size_t(-1))
+		{
+			vector<size_t> tags = item.tagTableEntries();
+			for (size_t& tag: tags)
+			{
+				auto it = _replacements.find(tag);
+				if (tag != 0 && it != _replacements.end())
+				{
+					changed = true;
+					tag = size_t(it->second);
+				}
+			}
+			item.setTagTableEntries(tags);
+		}
 	return changed;
 }
 
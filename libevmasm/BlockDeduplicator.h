@@ -51,7 +51,7 @@ public:
 	/// @returns the tags that were replaced.
 	std::map<u256, u256> const& replacedTags() const { return m_replacedTags; }
 
-	/// Replaces all PushTag operations insied @a _items that match a key in
+	/// Replaces all PushTag operations and tag table entries insied @a _items that match a key in
 	/// @a _replacements by the respective value. If @a _subID is not -1, only
 	/// apply the replacement for foreign tags from this sub id.
 	/// @returns true iff a replacement was performed.
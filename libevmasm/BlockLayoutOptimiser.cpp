@@ -0,0 +1,173 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Reorders the basic blocks of an assembly to turn jumps into fall-throughs.
+ */
+
+#include <libevmasm/BlockLayoutOptimiser.h>
+
+#include <libevmasm/AssemblyItem.h>
+#include <libevmasm/SemanticInformation.h>
+
+#include <boost/optional.hpp>
+
+#include <map>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+/// Sequence of basic blocks that can only be entered at its start, apart from falling through
+/// from one of its blocks into the next one. It has to stay contiguous.
+struct Chain
+{
+	size_t begin = 0;
+	size_t end = 0;
+	/// Tag at the start of the chain, if any.
+	boost::optional<u256> tag;
+	/// Tag the chain jumps to at its end, if it ends in an unconditional jump to a pushed tag.
+	boost::optional<u256> jumpTarget;
+	/// True if the chain ends in REVERT or INVALID.
+	bool cold = false;
+	/// True if control can flow out of the end of the chain, i.e. it has to stay the last chain.
+	bool fallsOffEnd = false;
+};
+
+/// @returns true if the code depends on the positions of its instructions.
+/// Tag tables count as such, since they only hold 16 bit positions, which the code
+/// generator only ensures for the order it has chosen.
+bool usesCodePositions(AssemblyItems const& _items)
+{
+	for (size_t i = 0; i < _items.size(); ++i)
+		if (_items[i] == Instruction::PC || _items[i].type() == PushTagTable)
+			return true;
+		else if (
+			(_items[i] == Instruction::JUMP || _items[i] == Instruction::JUMPI) &&
+			i > 0 &&
+			_items[i - 1].type() == Push
+		)
+			return true;
+	return false;
+}
+
+vector<Chain> splitIntoChains(AssemblyItems const& _items)
+{
+	vector<Chain> chains(1);
+	bool reachable = true;
+	for (size_t i = 0; i < _items.size(); ++i)
+	{
+		AssemblyItem const& item = _items[i];
+		if (item.type() == Tag && !reachable)
+		{
+			chains.back().end = i;
+			chains.emplace_back();
+			chains.back().begin = i;
+			chains.back().tag = item.data();
+			reachable = true;
+		}
+		else if (reachable && (item == Instruction::JUMP || SemanticInformation::terminatesControlFlow(item)))
+		{
+			// Items up to the next tag are unreachable and stay with the chain.
+			reachable = false;
+			Chain& chain = chains.back();
+			chain.cold = item == Instruction::REVERT || item == Instruction::INVALID;
+			if (item == Instruction::JUMP && i > chain.begin && _items[i - 1].type() == PushTag)
+				chain.jumpTarget = _items[i - 1].data();
+		}
+	}
+	chains.back().end = _items.size();
+	chains.back().fallsOffEnd = reachable;
+	return chains;
+}
+
+}
+
+bool BlockLayoutOptimiser::optimise()
+{
+	if (m_items.empty() || usesCodePositions(m_items))
+		return false;
+
+	vector<Chain> chains = splitIntoChains(m_items);
+	if (chains.size() < 3)
+		return false;
+	map<u256, size_t> chainByTag;
+	for (size_t i = 1; i < chains.size(); ++i)
+		if (chains[i].tag)
+			chainByTag[*chains[i].tag] = i;
+
+	// The entry chain stays first and a chain that control flows out of stays last.
+	vector<bool> placed(chains.size(), false);
+	size_t lastChain = chains.size() - 1;
+	bool keepLast = chains[lastChain].fallsOffEnd;
+	if (keepLast)
+		placed[lastChain] = true;
+
+	vector<size_t> order;
+	// Places the chain and then the chain it jumps to as long as that one is not placed yet.
+	// Hot chains do not continue into cold ones.
+	auto place = [&](size_t _chain)
+	{
+		bool cold = chains[_chain].cold;
+		while (true)
+		{
+			placed[_chain] = true;
+			order.push_back(_chain);
+			if (!chains[_chain].jumpTarget || !chainByTag.count(*chains[_chain].jumpTarget))
+				break;
+			size_t target = chainByTag.at(*chains[_chain].jumpTarget);
+			if (placed[target] || (chains[target].cold && !cold))
+				break;
+			_chain = target;
+		}
+	};
+	place(0);
+	for (size_t i = 1; i < chains.size(); ++i)
+		if (!placed[i] && !chains[i].cold)
+			place(i);
+	for (size_t i = 1; i < chains.size(); ++i)
+		if (!placed[i])
+			place(i);
+	if (keepLast)
+		order.push_back(lastChain);
+
+	AssemblyItems items;
+	items.reserve(m_items.size());
+	for (size_t chain: order)
+		items.insert(items.end(), m_items.begin() + chains[chain].begin, m_items.begin() + chains[chain].end);
+
+	if (jumpsToNextTag(items) <= jumpsToNextTag(m_items))
+		return false;
+	m_items = move(items);
+	return true;
+}
+
+size_t BlockLayoutOptimiser::jumpsToNextTag(AssemblyItems const& _items)
+{
+	size_t count = 0;
+	for (size_t i = 0; i + 2 < _items.size(); ++i)
+		if (
+			_items[i].type() == PushTag &&
+			_items[i + 1] == Instruction::JUMP &&
+			_items[i + 2].type() == Tag &&
+			_items[i].data() == _items[i + 2].data()
+		)
+			++count;
+	return count;
+}
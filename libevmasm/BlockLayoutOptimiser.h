@@ -0,0 +1,58 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Reorders the basic blocks of an assembly to turn jumps into fall-throughs.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+class AssemblyItem;
+using AssemblyItems = std::vector<AssemblyItem>;
+
+/**
+ * Reorders the basic blocks of an assembly such that blocks that end in an unconditional jump
+ * to a tag are followed by that tag where possible. These jumps are then removed by the
+ * peephole optimiser. Blocks that end in REVERT or INVALID are moved to the end of the code.
+ *
+ * Blocks that are entered by falling through from the previous block are kept together
+ * and the code is not changed at all if it depends on the positions of instructions
+ * (PC or jumps to literal positions).
+ */
+class BlockLayoutOptimiser
+{
+public:
+	explicit BlockLayoutOptimiser(AssemblyItems& _items): m_items(_items) {}
+
+	/// Reorders the blocks if that increases the number of jumps to the immediately following tag.
+	/// @returns true if the items were changed.
+	bool optimise();
+
+	/// @returns the number of unconditional jumps to the immediately following tag.
+	static size_t jumpsToNextTag(AssemblyItems const& _items);
+
+private:
+	AssemblyItems& m_items;
+};
+
+}
+}
@@ -22,6 +22,9 @@
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/Assembly.h>
 #include <libevmasm/GasMeter.h>
+
+#include <tuple>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -185,6 +188,49 @@ AssemblyItems const& CodeCopyMethod::copyRoutine()
 	return copyRoutine;
 }
 
+namespace
+{
+/// Representations depend on the parameters used to compare their costs, so all of them are part of the key.
+using ComputeMethodCache = ConstantRepresentationCache<
+	tuple<u256, bool, size_t, size_t, langutil::EVMVersion>,
+	AssemblyItems
+>;
+
+ComputeMethodCache& computeMethodCache()
+{
+	static ComputeMethodCache cache;
+	return cache;
+}
+}
+
+ComputeMethod::ComputeMethod(Params const& _params, u256 const& _value):
+	ConstantOptimisationMethod(_params, _value)
+{
+	auto key = make_tuple(m_value, m_params.isCreation, m_params.runs, m_params.multiplicity, m_params.evmVersion);
+	if (boost::optional<AssemblyItems> routine = computeMethodCache().find(key))
+		m_routine = move(*routine);
+	else
+	{
+		m_routine = findRepresentation(m_value);
+		assertThrow(
+			checkRepresentation(m_value, m_routine),
+			OptimizerException,
+			"Invalid constant expression created."
+		);
+		computeMethodCache().store(key, m_routine);
+	}
+}
+
+ConstantCacheStatistics ComputeMethod::cacheStatistics()
+{
+	return computeMethodCache().statistics();
+}
+
+void ComputeMethod::clearCache()
+{
+	computeMethodCache().clear();
+}
+
 AssemblyItems ComputeMethod::findRepresentation(u256 const& _value)
 {
 	if (_value < 0x10000)
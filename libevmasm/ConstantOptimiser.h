@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <libevmasm/ConstantRepresentationCache.h>
 #include <libevmasm/Exceptions.h>
 
 #include <liblangutil/EVMVersion.h>
@@ -134,16 +135,9 @@ protected:
 class ComputeMethod: public ConstantOptimisationMethod
 {
 public:
-	explicit ComputeMethod(Params const& _params, u256 const& _value):
-		ConstantOptimisationMethod(_params, _value)
-	{
-		m_routine = findRepresentation(m_value);
-		assertThrow(
-			checkRepresentation(m_value, m_routine),
-			OptimizerException,
-			"Invalid constant expression created."
-		);
-	}
+	/// Looks up the representation of @a _value in a process-wide cache and
+	/// searches for it if it is not found.
+	explicit ComputeMethod(Params const& _params, u256 const& _value);
 
 	bigint gasNeeded() const override { return gasNeeded(m_routine); }
 	AssemblyItems execute(Assembly&) const override
@@ -151,6 +145,11 @@ public:
 		return m_routine;
 	}
 
+	/// @returns the number of representations taken from and not found in the cache.
+	static ConstantCacheStatistics cacheStatistics();
+	/// Empties the cache of representations and resets its statistics.
+	static void clearCache();
+
 protected:
 	/// Tries to recursively find a way to compute @a _value.
 	AssemblyItems findRepresentation(u256 const& _value);
@@ -0,0 +1,105 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Process-wide cache for the representations found by the constant optimiser.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+namespace dev
+{
+namespace eth
+{
+
+/// Number of lookups in a ConstantRepresentationCache.
+struct ConstantCacheStatistics
+{
+	size_t hits = 0;
+	size_t misses = 0;
+
+	/// @returns the fraction of lookups that were answered from the cache.
+	double hitRate() const { return hits + misses == 0 ? 0.0 : double(hits) / double(hits + misses); }
+};
+
+/**
+ * Process-wide cache for the representations of constants. The same constants (masks,
+ * function selectors, ...) appear in most contracts of a project and searching for their
+ * cheapest representation is expensive.
+ *
+ * The key has to contain everything the representation depends on (the value, the EVM version,
+ * the runs parameter, ...), so that a cached value is identical to the one a new search would find.
+ * Searches whose result also depends on state outside of the key, like a step budget shared with
+ * other searches, must not use the cache, since their output would depend on earlier compilations.
+ * Can be used from multiple threads.
+ */
+template <class Key, class Value>
+class ConstantRepresentationCache
+{
+public:
+	/// @returns the value stored for @a _key, if any, and counts the lookup.
+	boost::optional<Value> find(Key const& _key)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_values.find(_key);
+		if (it == m_values.end())
+		{
+			m_statistics.misses++;
+			return boost::none;
+		}
+		m_statistics.hits++;
+		return it->second;
+	}
+
+	/// Stores @a _value for @a _key. The cache is emptied if it grows too large.
+	void store(Key const& _key, Value _value)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_values.size() >= c_maxEntries)
+			m_values.clear();
+		m_values.emplace(_key, std::move(_value));
+	}
+
+	ConstantCacheStatistics statistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_statistics;
+	}
+
+	/// Removes all values and resets the statistics.
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_values.clear();
+		m_statistics = {};
+	}
+
+private:
+	static size_t constexpr c_maxEntries = 0x10000;
+
+	mutable std::mutex m_mutex;
+	std::map<Key, Value> m_values;
+	ConstantCacheStatistics m_statistics;
+};
+
+}
+}
@@ -65,6 +65,9 @@ void ControlFlowGraph::findLargestTag()
 			BlockId(item.data());
 			m_lastUsedId = max(unsigned(item.data()), m_lastUsedId);
 		}
+		else if (item.type() == PushTagTable)
+			for (size_t tag: item.tagTableEntries())
+				m_lastUsedId = max(unsigned(tag), m_lastUsedId);
 }
 
 void ControlFlowGraph::splitBlocks()
@@ -88,6 +91,10 @@ void ControlFlowGraph::splitBlocks()
 		}
 		if (item.type() == PushTag)
 			m_blocks[id].pushedTags.emplace_back(item.data());
+		else if (item.type() == PushTagTable)
+			for (size_t tag: item.tagTableEntries())
+				if (tag != 0)
+					m_blocks[id].pushedTags.emplace_back(tag);
 		if (SemanticInformation::altersControlFlow(item))
 		{
 			m_blocks[id].end = index + 1;
@@ -27,6 +27,7 @@
 #include <functional>
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/functional/hash.hpp>
 #include <libevmasm/Assembly.h>
 #include <libevmasm/CommonSubexpressionEliminator.h>
 #include <libevmasm/SimplificationRules.h>
@@ -36,23 +37,19 @@ using namespace dev;
 using namespace dev::eth;
 using namespace langutil;
 
-bool ExpressionClasses::Expression::operator<(ExpressionClasses::Expression const& _other) const
+bool ExpressionClasses::Expression::operator==(ExpressionClasses::Expression const& _other) const
 {
 	assertThrow(!!item && !!_other.item, OptimizerException, "");
-	auto type = item->type();
-	auto otherType = _other.item->type();
-	if (type != otherType)
-		return type < otherType;
-	else if (type == Operation)
-	{
-		auto instr = item->instruction();
-		auto otherInstr = _other.item->instruction();
-		return std::tie(instr, arguments, sequenceNumber) <
-			std::tie(otherInstr, _other.arguments, _other.sequenceNumber);
-	}
-	else
-		return std::tie(item->data(), arguments, sequenceNumber) <
-			std::tie(_other.item->data(), _other.arguments, _other.sequenceNumber);
+	return *item == *_other.item && arguments == _other.arguments && sequenceNumber == _other.sequenceNumber;
+}
+
+size_t ExpressionClasses::Expression::hash() const
+{
+	assertThrow(!!item, OptimizerException, "");
+	size_t seed = item->hash();
+	boost::hash_range(seed, arguments.begin(), arguments.end());
+	boost::hash_combine(seed, sequenceNumber);
+	return seed;
 }
 
 ExpressionClasses::Id ExpressionClasses::find(
@@ -71,11 +68,12 @@ ExpressionClasses::Id ExpressionClasses::find(
 	if (SemanticInformation::isCommutativeOperation(_item))
 		sort(exp.arguments.begin(), exp.arguments.end());
 
-	if (SemanticInformation::isDeterministic(_item))
+	size_t hash = exp.hash();
+	if (SemanticInformation::isDeterministic(_item) && !m_expressionTable.empty())
 	{
-		auto it = m_expressions.find(exp);
-		if (it != m_expressions.end())
-			return it->id;
+		ExpressionSlot const& slot = m_expressionTable[findSlot(exp, hash)];
+		if (slot.index)
+			return m_expressions[slot.index - 1].id;
 	}
 
 	if (_copyItem)
@@ -89,7 +87,7 @@ ExpressionClasses::Id ExpressionClasses::find(
 		exp.id = m_representatives.size();
 		m_representatives.push_back(exp);
 	}
-	m_expressions.insert(exp);
+	insertExpression(exp, hash);
 	return exp.id;
 }
 
@@ -111,7 +109,7 @@ void ExpressionClasses::forceEqual(
 	if (_copyItem)
 		exp.item = storeItem(_item);
 
-	m_expressions.insert(exp);
+	insertExpression(exp, exp.hash());
 }
 
 ExpressionClasses::Id ExpressionClasses::newClass(SourceLocation const& _location)
@@ -120,7 +118,7 @@ ExpressionClasses::Id ExpressionClasses::newClass(SourceLocation const& _locatio
 	exp.id = m_representatives.size();
 	exp.item = storeItem(AssemblyItem(UndefinedItem, (u256(1) << 255) + exp.id, _location));
 	m_representatives.push_back(exp);
-	m_expressions.insert(exp);
+	insertExpression(exp, exp.hash());
 	return exp.id;
 }
 
@@ -150,12 +148,15 @@ bool ExpressionClasses::knownNonZero(Id _c)
 
 u256 const* ExpressionClasses::knownConstant(Id _c)
 {
-	map<unsigned, Expression const*> matchGroups;
+	auto known = m_knownConstants.find(_c);
+	if (known != m_knownConstants.end())
+		return &known->second;
+	MatchGroups<Expression> matchGroups{};
 	Pattern constant(Push);
 	constant.setMatchGroup(1, matchGroups);
 	if (!constant.matches(representative(_c), *this))
 		return nullptr;
-	return &constant.d();
+	return &m_knownConstants.emplace(_c, constant.d()).first->second;
 }
 
 AssemblyItem const* ExpressionClasses::storeItem(AssemblyItem const& _item)
@@ -164,6 +165,44 @@ AssemblyItem const* ExpressionClasses::storeItem(AssemblyItem const& _item)
 	return m_spareAssemblyItems.back().get();
 }
 
+size_t ExpressionClasses::findSlot(Expression const& _expression, size_t _hash) const
+{
+	assertThrow(!m_expressionTable.empty(), OptimizerException, "");
+	size_t mask = m_expressionTable.size() - 1;
+	for (size_t slot = _hash & mask; ; slot = (slot + 1) & mask)
+	{
+		ExpressionSlot const& entry = m_expressionTable[slot];
+		if (!entry.index || (entry.hash == _hash && m_expressions[entry.index - 1] == _expression))
+			return slot;
+	}
+}
+
+void ExpressionClasses::insertExpression(Expression const& _expression, size_t _hash)
+{
+	if (2 * (m_expressions.size() + 1) > m_expressionTable.size())
+		rehashExpressions(max<size_t>(64, 2 * m_expressionTable.size()));
+	ExpressionSlot& slot = m_expressionTable[findSlot(_expression, _hash)];
+	if (slot.index)
+		return;
+	m_expressions.push_back(_expression);
+	slot = ExpressionSlot{_hash, m_expressions.size()};
+}
+
+void ExpressionClasses::rehashExpressions(size_t _size)
+{
+	vector<ExpressionSlot> table(_size);
+	size_t mask = _size - 1;
+	for (ExpressionSlot const& entry: m_expressionTable)
+		if (entry.index)
+		{
+			size_t slot = entry.hash & mask;
+			while (table[slot].index)
+				slot = (slot + 1) & mask;
+			table[slot] = entry;
+		}
+	m_expressionTable = move(table);
+}
+
 string ExpressionClasses::fullDAGToString(ExpressionClasses::Id _id) const
 {
 	Expression const& expr = representative(_id);
@@ -183,7 +222,8 @@ string ExpressionClasses::fullDAGToString(ExpressionClasses::Id _id) const
 
 ExpressionClasses::Id ExpressionClasses::tryToSimplify(Expression const& _expr)
 {
-	static Rules rules;
+	// The rules store the match groups of the last match, so every thread needs its own copy.
+	static thread_local Rules rules;
 	assertThrow(rules.isInitialized(), OptimizerException, "Rule list not properly initialized.");
 
 	if (
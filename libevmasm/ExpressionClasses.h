@@ -62,7 +62,9 @@ public:
 		/// Storage modification sequence, only used for storage and memory operations.
 		unsigned sequenceNumber = 0;
 		/// Behaves as if this was a tuple of (item->type(), item->data(), arguments, sequenceNumber).
-		bool operator<(Expression const& _other) const;
+		bool operator==(Expression const& _other) const;
+		/// @returns a hash value compatible with operator==.
+		size_t hash() const;
 	};
 
 	/// Retrieves the id of the expression equivalence class resulting from the given item applied to the
@@ -120,11 +122,31 @@ private:
 
 	std::vector<std::pair<Pattern, std::function<Pattern()>>> createRules() const;
 
+	/// Slot of the hash table of expressions.
+	struct ExpressionSlot
+	{
+		size_t hash = 0;
+		/// One plus the index into m_expressions, zero for empty slots.
+		size_t index = 0;
+	};
+	/// @returns the index of the slot of m_expressionTable that contains an expression equal to
+	/// @a _expression or of the empty slot where it would be inserted. The table must not be empty.
+	size_t findSlot(Expression const& _expression, size_t _hash) const;
+	/// Adds @a _expression to the expressions unless an equal expression is already present.
+	void insertExpression(Expression const& _expression, size_t _hash);
+	/// Resizes the hash table to @a _size slots, which has to be a power of two.
+	void rehashExpressions(size_t _size);
+
 	/// Expression equivalence class representatives - we only store one item of an equivalence.
 	std::vector<Expression> m_representatives;
-	/// All expression ever encountered.
-	std::set<Expression> m_expressions;
+	/// All expression ever encountered, without duplicates.
+	std::vector<Expression> m_expressions;
+	/// Hash table over m_expressions using open addressing with linear probing. Its size is a
+	/// power of two and it is at most half full.
+	std::vector<ExpressionSlot> m_expressionTable;
 	std::vector<std::shared_ptr<AssemblyItem>> m_spareAssemblyItems;
+	/// Values of the classes known to be constants, referenced by knownConstant.
+	std::map<Id, u256> m_knownConstants;
 };
 
 }
@@ -53,6 +53,7 @@ GasMeter::GasConsumption GasMeter::estimateMax(AssemblyItem const& _item, bool _
 	case PushProgramSize:
 	case PushLibraryAddress:
 	case PushDeployTimeAddress:
+	case PushTagTable:
 		gas = runGas(Instruction::PUSH1);
 		break;
 	case Tag:
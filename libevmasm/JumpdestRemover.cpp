@@ -62,5 +62,12 @@ set<size_t> JumpdestRemover::referencedTags(AssemblyItems const& _items, size_t
 			if (subAndTag.first == _subId)
 				ret.insert(subAndTag.second);
 		}
+		else if (item.type() == PushTagTable && _subId == size_t(-1))
+		{
+			// Tag tables only refer to local tags.
+			for (size_t tag: item.tagTableEntries())
+				if (tag != 0)
+					ret.insert(tag);
+		}
 	return ret;
 }
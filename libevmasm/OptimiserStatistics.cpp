@@ -0,0 +1,71 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Collector for the effect of the individual steps of the optimisers.
+ */
+
+#include <libevmasm/OptimiserStatistics.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+void OptimiserStatistics::record(OptimiserStepRun _run)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_runs.emplace_back(move(_run));
+}
+
+vector<OptimiserStepRun> OptimiserStatistics::runs() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_runs;
+}
+
+Json::Value OptimiserStatistics::toJson() const
+{
+	Json::Value statistics{Json::objectValue};
+	for (OptimiserStepRun const& run: runs())
+	{
+		Json::Value& step = statistics[run.optimiser][run.step];
+		if (step.isNull())
+		{
+			step["runs"] = 0;
+			step["changedRuns"] = 0;
+			step["time"] = 0.0;
+			step["sizeBefore"] = Json::LargestUInt(0);
+			step["sizeAfter"] = Json::LargestUInt(0);
+			if (run.optimiser == "evmasm")
+			{
+				step["bytesDelta"] = Json::LargestInt(0);
+				step["gasDelta"] = Json::LargestInt(0);
+			}
+		}
+		step["runs"] = step["runs"].asUInt() + 1;
+		if (run.changed)
+			step["changedRuns"] = step["changedRuns"].asUInt() + 1;
+		step["time"] = step["time"].asDouble() + run.time;
+		step["sizeBefore"] = step["sizeBefore"].asLargestUInt() + Json::LargestUInt(run.sizeBefore);
+		step["sizeAfter"] = step["sizeAfter"].asLargestUInt() + Json::LargestUInt(run.sizeAfter);
+		if (run.optimiser == "evmasm")
+		{
+			step["bytesDelta"] = step["bytesDelta"].asLargestInt() + Json::LargestInt(run.bytesDelta);
+			step["gasDelta"] = step["gasDelta"].asLargestInt() + Json::LargestInt(run.gasDelta);
+		}
+	}
+	return statistics;
+}
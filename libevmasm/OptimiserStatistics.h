@@ -0,0 +1,77 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Collector for the effect of the individual steps of the optimisers.
+ */
+
+#pragma once
+
+#include <json/json.h>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+
+/// Effect of a single invocation of an optimiser step.
+struct OptimiserStepRun
+{
+	/// The optimiser the step belongs to, "evmasm" or "yul".
+	std::string optimiser;
+	std::string step;
+	/// Wall time in milliseconds.
+	double time = 0;
+	/// Number of assembly items or, for Yul, the code size in AST nodes (see yul::CodeSize).
+	size_t sizeBefore = 0;
+	size_t sizeAfter = 0;
+	/// Estimated change of the bytecode size in bytes and of the gas needed to run each item once.
+	/// Only available for the evmasm optimiser.
+	long long bytesDelta = 0;
+	long long gasDelta = 0;
+	/// True if the step modified the code.
+	bool changed = false;
+};
+
+/**
+ * Records how often the optimiser steps run, how much time they take and how they change the code,
+ * which helps finding steps that take time without having an effect.
+ * Can be used from multiple threads.
+ */
+class OptimiserStatistics
+{
+public:
+	void record(OptimiserStepRun _run);
+
+	/// @returns all recorded invocations in the order they were recorded.
+	std::vector<OptimiserStepRun> runs() const;
+
+	/// @returns the invocations summed up per optimiser and step, i.e. an object of the form
+	/// {optimiser: {step: {"runs", "changedRuns", "time", "sizeBefore", "sizeAfter", ...}}}.
+	Json::Value toJson() const;
+
+private:
+	mutable std::mutex m_mutex;
+	std::vector<OptimiserStepRun> m_runs;
+};
+
+}
+}
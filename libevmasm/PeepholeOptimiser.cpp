@@ -24,6 +24,10 @@
 #include <libevmasm/AssemblyItem.h>
 #include <libevmasm/SemanticInformation.h>
 
+#include <array>
+#include <deque>
+#include <limits>
+
 using namespace std;
 using namespace dev::eth;
 using namespace dev;
@@ -104,36 +108,46 @@ struct Identity: SimplePeepholeOptimizerMethod<Identity, 1>
 	}
 };
 
+// Every rule provides startsWith, which is used to precompute the rules that can match
+// at a position from the first item alone (see candidateRules below).
+
 struct PushPop: SimplePeepholeOptimizerMethod<PushPop, 2>
 {
-	static bool applySimple(AssemblyItem const& _push, AssemblyItem const& _pop, std::back_insert_iterator<AssemblyItems>)
+	static bool startsWith(AssemblyItem const& _push)
 	{
 		auto t = _push.type();
-		return _pop == Instruction::POP && (
+		return
 			SemanticInformation::isDupInstruction(_push) ||
 			t == Push || t == PushString || t == PushTag || t == PushSub ||
-			t == PushSubSize || t == PushProgramSize || t == PushData || t == PushLibraryAddress
-		);
+			t == PushSubSize || t == PushProgramSize || t == PushData || t == PushLibraryAddress ||
+			t == PushTagTable;
+	}
+	static bool applySimple(AssemblyItem const& _push, AssemblyItem const& _pop, std::back_insert_iterator<AssemblyItems>)
+	{
+		return _pop == Instruction::POP && startsWith(_push);
 	}
 };
 
 struct OpPop: SimplePeepholeOptimizerMethod<OpPop, 2>
 {
+	static bool startsWith(AssemblyItem const& _op)
+	{
+		if (_op.type() != Operation)
+			return false;
+		InstructionInfo info = instructionInfo(_op.instruction());
+		return info.ret == 1 && !info.sideEffects;
+	}
 	static bool applySimple(
 		AssemblyItem const& _op,
 		AssemblyItem const& _pop,
 		std::back_insert_iterator<AssemblyItems> _out
 	)
 	{
-		if (_pop == Instruction::POP && _op.type() == Operation)
+		if (_pop == Instruction::POP && startsWith(_op))
 		{
-			Instruction instr = _op.instruction();
-			if (instructionInfo(instr).ret == 1 && !instructionInfo(instr).sideEffects)
-			{
-				for (int j = 0; j < instructionInfo(instr).args; j++)
-					*_out = {Instruction::POP, _op.location()};
-				return true;
-			}
+			for (int j = 0; j < instructionInfo(_op.instruction()).args; j++)
+				*_out = {Instruction::POP, _op.location()};
+			return true;
 		}
 		return false;
 	}
@@ -141,17 +155,25 @@ struct OpPop: SimplePeepholeOptimizerMethod<OpPop, 2>
 
 struct DoubleSwap: SimplePeepholeOptimizerMethod<DoubleSwap, 2>
 {
+	static bool startsWith(AssemblyItem const& _s1)
+	{
+		return SemanticInformation::isSwapInstruction(_s1);
+	}
 	static size_t applySimple(AssemblyItem const& _s1, AssemblyItem const& _s2, std::back_insert_iterator<AssemblyItems>)
 	{
-		return _s1 == _s2 && SemanticInformation::isSwapInstruction(_s1);
+		return _s1 == _s2 && startsWith(_s1);
 	}
 };
 
 struct DoublePush: SimplePeepholeOptimizerMethod<DoublePush, 2>
 {
+	static bool startsWith(AssemblyItem const& _push1)
+	{
+		return _push1.type() == Push;
+	}
 	static bool applySimple(AssemblyItem const& _push1, AssemblyItem const& _push2, std::back_insert_iterator<AssemblyItems> _out)
 	{
-		if (_push1.type() == Push && _push2.type() == Push && _push1.data() == _push2.data())
+		if (startsWith(_push1) && _push2.type() == Push && _push1.data() == _push2.data())
 		{
 			*_out = _push1;
 			*_out = {Instruction::DUP1, _push2.location()};
@@ -164,6 +186,10 @@ struct DoublePush: SimplePeepholeOptimizerMethod<DoublePush, 2>
 
 struct CommutativeSwap: SimplePeepholeOptimizerMethod<CommutativeSwap, 2>
 {
+	static bool startsWith(AssemblyItem const& _swap)
+	{
+		return _swap == Instruction::SWAP1;
+	}
 	static bool applySimple(AssemblyItem const& _swap, AssemblyItem const& _op, std::back_insert_iterator<AssemblyItems> _out)
 	{
 		// Remove SWAP1 if following instruction is commutative
@@ -182,6 +208,10 @@ struct CommutativeSwap: SimplePeepholeOptimizerMethod<CommutativeSwap, 2>
 
 struct SwapComparison: SimplePeepholeOptimizerMethod<SwapComparison, 2>
 {
+	static bool startsWith(AssemblyItem const& _swap)
+	{
+		return _swap == Instruction::SWAP1;
+	}
 	static bool applySimple(AssemblyItem const& _swap, AssemblyItem const& _op, std::back_insert_iterator<AssemblyItems> _out)
 	{
 		static map<Instruction, Instruction> const swappableOps{
@@ -207,6 +237,10 @@ struct SwapComparison: SimplePeepholeOptimizerMethod<SwapComparison, 2>
 
 struct IsZeroIsZeroJumpI: SimplePeepholeOptimizerMethod<IsZeroIsZeroJumpI, 4>
 {
+	static bool startsWith(AssemblyItem const& _iszero1)
+	{
+		return _iszero1 == Instruction::ISZERO;
+	}
 	static size_t applySimple(
 		AssemblyItem const& _iszero1,
 		AssemblyItem const& _iszero2,
@@ -216,7 +250,7 @@ struct IsZeroIsZeroJumpI: SimplePeepholeOptimizerMethod<IsZeroIsZeroJumpI, 4>
 	)
 	{
 		if (
-			_iszero1 == Instruction::ISZERO &&
+			startsWith(_iszero1) &&
 			_iszero2 == Instruction::ISZERO &&
 			_pushTag.type() == PushTag &&
 			_jumpi == Instruction::JUMPI
@@ -233,6 +267,10 @@ struct IsZeroIsZeroJumpI: SimplePeepholeOptimizerMethod<IsZeroIsZeroJumpI, 4>
 
 struct JumpToNext: SimplePeepholeOptimizerMethod<JumpToNext, 3>
 {
+	static bool startsWith(AssemblyItem const& _pushTag)
+	{
+		return _pushTag.type() == PushTag;
+	}
 	static size_t applySimple(
 		AssemblyItem const& _pushTag,
 		AssemblyItem const& _jump,
@@ -241,7 +279,7 @@ struct JumpToNext: SimplePeepholeOptimizerMethod<JumpToNext, 3>
 	)
 	{
 		if (
-			_pushTag.type() == PushTag &&
+			startsWith(_pushTag) &&
 			(_jump == Instruction::JUMP || _jump == Instruction::JUMPI) &&
 			_tag.type() == Tag &&
 			_pushTag.data() == _tag.data()
@@ -259,6 +297,10 @@ struct JumpToNext: SimplePeepholeOptimizerMethod<JumpToNext, 3>
 
 struct TagConjunctions: SimplePeepholeOptimizerMethod<TagConjunctions, 3>
 {
+	static bool startsWith(AssemblyItem const& _pushTag)
+	{
+		return _pushTag.type() == PushTag;
+	}
 	static bool applySimple(
 		AssemblyItem const& _pushTag,
 		AssemblyItem const& _pushConstant,
@@ -267,7 +309,7 @@ struct TagConjunctions: SimplePeepholeOptimizerMethod<TagConjunctions, 3>
 	)
 	{
 		if (
-			_pushTag.type() == PushTag &&
+			startsWith(_pushTag) &&
 			_and == Instruction::AND &&
 			_pushConstant.type() == Push &&
 			(_pushConstant.data() & u256(0xFFFFFFFF)) == u256(0xFFFFFFFF)
@@ -283,6 +325,10 @@ struct TagConjunctions: SimplePeepholeOptimizerMethod<TagConjunctions, 3>
 
 struct TruthyAnd: SimplePeepholeOptimizerMethod<TruthyAnd, 3>
 {
+	static bool startsWith(AssemblyItem const& _push)
+	{
+		return _push.type() == Push;
+	}
 	static bool applySimple(
 		AssemblyItem const& _push,
 		AssemblyItem const& _not,
@@ -291,7 +337,7 @@ struct TruthyAnd: SimplePeepholeOptimizerMethod<TruthyAnd, 3>
 	)
 	{
 		return (
-			_push.type() == Push && _push.data() == 0 &&
+			startsWith(_push) && _push.data() == 0 &&
 			_not == Instruction::NOT &&
 			_and == Instruction::AND
 		);
@@ -301,20 +347,21 @@ struct TruthyAnd: SimplePeepholeOptimizerMethod<TruthyAnd, 3>
 /// Removes everything after a JUMP (or similar) until the next JUMPDEST.
 struct UnreachableCode
 {
+	static bool startsWith(AssemblyItem const& _item)
+	{
+		return
+			_item == Instruction::JUMP ||
+			_item == Instruction::RETURN ||
+			_item == Instruction::STOP ||
+			_item == Instruction::INVALID ||
+			_item == Instruction::SELFDESTRUCT ||
+			_item == Instruction::REVERT;
+	}
 	static bool apply(OptimiserState& _state)
 	{
 		auto it = _state.items.begin() + _state.i;
 		auto end = _state.items.end();
-		if (it == end)
-			return false;
-		if (
-			it[0] != Instruction::JUMP &&
-			it[0] != Instruction::RETURN &&
-			it[0] != Instruction::STOP &&
-			it[0] != Instruction::INVALID &&
-			it[0] != Instruction::SELFDESTRUCT &&
-			it[0] != Instruction::REVERT
-		)
+		if (it == end || !startsWith(it[0]))
 			return false;
 
 		size_t i = 1;
@@ -343,15 +390,248 @@ void applyMethods(OptimiserState& _state, Method, OtherMethods... _other)
 		applyMethods(_state, _other...);
 }
 
+using RuleApplication = bool(*)(OptimiserState&);
+
+/// Largest window any rule apart from UnreachableCode looks at.
+size_t constexpr c_maxWindowSize = 4;
+/// Bound on the number of sweeps, each sweep corresponds to one run of the optimiser before.
+size_t constexpr c_maxSweeps = 64000;
+size_t constexpr c_numberOfRuleKeys = 0x100 + PushTagTable + 1;
+
+/// @returns the key under which the candidate rules for windows starting with @a _item are stored:
+/// the opcode for operations and the item type for all other items.
+size_t ruleKey(AssemblyItem const& _item)
+{
+	return _item.type() == Operation ? size_t(_item.instruction()) : 0x100 + size_t(_item.type());
+}
+
+void addCandidateRules(array<vector<RuleApplication>, c_numberOfRuleKeys>&, AssemblyItem const&)
+{
+}
+
+template <typename Method, typename... OtherMethods>
+void addCandidateRules(
+	array<vector<RuleApplication>, c_numberOfRuleKeys>& _table,
+	AssemblyItem const& _item,
+	Method,
+	OtherMethods... _other
+)
+{
+	if (Method::startsWith(_item))
+		_table[ruleKey(_item)].push_back(&Method::apply);
+	addCandidateRules(_table, _item, _other...);
+}
+
+/// @returns the rules that can match a window starting with @a _item, in the order in
+/// which applyMethods tries them. The table is computed once from the startsWith
+/// functions of the rules.
+vector<RuleApplication> const& candidateRules(AssemblyItem const& _item)
+{
+	static array<vector<RuleApplication>, c_numberOfRuleKeys> const table = []()
+	{
+		array<vector<RuleApplication>, c_numberOfRuleKeys> table;
+		vector<AssemblyItem> keys;
+		for (size_t instruction = 0; instruction < 0x100; ++instruction)
+			keys.emplace_back(Instruction(instruction));
+		for (size_t type = 0; type <= PushTagTable; ++type)
+			if (type != Operation)
+				keys.emplace_back(AssemblyItemType(type), 0);
+		for (AssemblyItem const& key: keys)
+			addCandidateRules(
+				table,
+				key,
+				PushPop(), OpPop(), DoublePush(), DoubleSwap(), CommutativeSwap(), SwapComparison(),
+				IsZeroIsZeroJumpI(), JumpToNext(), UnreachableCode(),
+				TagConjunctions(), TruthyAnd()
+			);
+		return table;
+	}();
+	return table[ruleKey(_item)];
+}
+
 size_t numberOfPops(AssemblyItems const& _items)
 {
 	return std::count(_items.begin(), _items.end(), Instruction::POP);
 }
 
+/**
+ * Streams items through a chain of sweeps. Each sweep applies the rules once at every
+ * position of the output of the previous sweep, exactly like one call to
+ * PeepholeOptimiser::optimiseWithoutBacktracking. Since the items before the first rewrite
+ * of a sweep are not changed, the next sweep is only created at that point and steps back
+ * over the last items instead of starting from the beginning.
+ */
+class SweepChain
+{
+public:
+	explicit SweepChain(size_t _maxSweeps): m_maxSweeps(_maxSweeps) {}
+
+	/// @returns the output of the last sweep after feeding @a _items through the chain.
+	AssemblyItems run(AssemblyItems const& _items)
+	{
+		m_sweeps.clear();
+		m_sweeps.emplace_back();
+		m_result.clear();
+		for (AssemblyItem const& item: _items)
+		{
+			m_sweeps.front().items.push_back(item);
+			for (size_t sweep = 0; sweep < m_sweeps.size(); ++sweep)
+				while (step(sweep, false)) {}
+		}
+		for (size_t sweep = 0; sweep < m_sweeps.size(); ++sweep)
+			while (step(sweep, true)) {}
+		return std::move(m_result);
+	}
+
+	/// @returns the number of sweeps at the start of the chain that rewrote items and
+	/// improved them.
+	size_t improvingSweeps() const
+	{
+		size_t count = 0;
+		while (count < m_sweeps.size() && m_sweeps[count].rewritten && m_sweeps[count].improves())
+			count++;
+		return count;
+	}
+
+	/// @returns true if a sweep rewrote items without improving them, i.e. if the chain went
+	/// further than repeating optimiseWithoutBacktracking would have.
+	bool overshot() const
+	{
+		return any_of(m_sweeps.begin(), m_sweeps.end(), [](Sweep const& _sweep) {
+			return _sweep.rewritten && !_sweep.improves();
+		});
+	}
+
+private:
+	struct Sweep
+	{
+		/// Buffered input, the items before @a read have already been processed.
+		AssemblyItems items;
+		size_t read = 0;
+		/// True if UnreachableCode has to continue removing items up to the next tag.
+		bool removingUnreachable = false;
+		bool rewritten = false;
+		/// Differences in number of items, bytes and pops between output and input.
+		ptrdiff_t itemsDelta = 0;
+		ptrdiff_t bytesDelta = 0;
+		ptrdiff_t popsDelta = 0;
+
+		/// Same criterion as in PeepholeOptimiser::acceptOptimisedItems.
+		bool improves() const
+		{
+			return itemsDelta < 0 || (itemsDelta == 0 && (bytesDelta < 0 || popsDelta > 0));
+		}
+		void account(AssemblyItem const& _item, ptrdiff_t _sign)
+		{
+			itemsDelta += _sign;
+			bytesDelta += _sign * ptrdiff_t(_item.bytesRequired(3));
+			if (_item == Instruction::POP)
+				popsDelta += _sign;
+		}
+	};
+
+	/// Processes the next position of the given sweep.
+	/// @param _final if true, no further items will be fed to the sweep.
+	/// @returns false if more input is needed first.
+	bool step(size_t _sweep, bool _final)
+	{
+		Sweep& sweep = m_sweeps[_sweep];
+		AssemblyItems& items = sweep.items;
+		if (sweep.read == items.size())
+			return false;
+		if (sweep.removingUnreachable)
+		{
+			if (items[sweep.read].type() != Tag)
+			{
+				sweep.account(items[sweep.read++], -1);
+				return true;
+			}
+			sweep.removingUnreachable = false;
+		}
+		// All rules apart from UnreachableCode decide on at most c_maxWindowSize items
+		// and UnreachableCode only needs to know whether there is a next item.
+		if (!_final && items.size() - sweep.read < c_maxWindowSize)
+			return false;
+
+		m_replacement.clear();
+		OptimiserState state{items, sweep.read, std::back_inserter(m_replacement)};
+		auto const& rules = candidateRules(items[sweep.read]);
+		auto rule = find_if(rules.begin(), rules.end(), [&](RuleApplication _rule) { return _rule(state); });
+		if (rule == rules.end())
+			emit(_sweep, std::move(items[sweep.read++]));
+		else
+		{
+			for (size_t i = sweep.read; i < state.i; ++i)
+				sweep.account(items[i], -1);
+			for (AssemblyItem const& item: m_replacement)
+				sweep.account(item, 1);
+			if (*rule == &UnreachableCode::apply && state.i == items.size() && !_final)
+				sweep.removingUnreachable = true;
+			sweep.read = state.i;
+			if (!sweep.rewritten)
+			{
+				sweep.rewritten = true;
+				if (_sweep + 1 == m_sweeps.size() && _sweep + 1 < m_maxSweeps)
+				{
+					assertThrow(m_sweeps.size() < c_maxSweeps, OptimizerException, "Peephole optimizer seems to be stuck.");
+					// Everything emitted so far is unchanged, so the next sweep can start with
+					// the last window that does not reach into the rewritten items.
+					m_sweeps.emplace_back();
+					size_t stepBack = min(m_result.size(), c_maxWindowSize - 1);
+					m_sweeps.back().items.assign(
+						make_move_iterator(m_result.end() - stepBack),
+						make_move_iterator(m_result.end())
+					);
+					m_result.erase(m_result.end() - stepBack, m_result.end());
+				}
+			}
+			for (AssemblyItem& item: m_replacement)
+				emit(_sweep, std::move(item));
+		}
+
+		if (sweep.read > 0x100 && sweep.read * 2 > items.size())
+		{
+			items.erase(items.begin(), items.begin() + sweep.read);
+			sweep.read = 0;
+		}
+		return true;
+	}
+
+	void emit(size_t _sweep, AssemblyItem&& _item)
+	{
+		if (_sweep + 1 < m_sweeps.size())
+			m_sweeps[_sweep + 1].items.push_back(std::move(_item));
+		else
+			m_result.push_back(std::move(_item));
+	}
+
+	size_t const m_maxSweeps;
+	/// Deque, so that references to sweeps stay valid when a sweep is added.
+	deque<Sweep> m_sweeps;
+	AssemblyItems m_result;
+	AssemblyItems m_replacement;
+};
+
 }
 
 bool PeepholeOptimiser::optimise()
 {
+	SweepChain chain(numeric_limits<size_t>::max());
+	m_optimisedItems = chain.run(m_items);
+	size_t sweeps = chain.improvingSweeps();
+	if (sweeps == 0)
+		return false;
+	if (chain.overshot())
+		// Repeating optimiseWithoutBacktracking would have stopped at the first sweep that
+		// is not an improvement, so we have to drop that sweep and all further sweeps.
+		m_optimisedItems = SweepChain(sweeps).run(m_items);
+	m_items = std::move(m_optimisedItems);
+	return true;
+}
+
+bool PeepholeOptimiser::optimiseWithoutBacktracking()
+{
+	m_optimisedItems.clear();
 	OptimiserState state {m_items, 0, std::back_inserter(m_optimisedItems)};
 	while (state.i < m_items.size())
 		applyMethods(
@@ -360,6 +640,11 @@ bool PeepholeOptimiser::optimise()
 			IsZeroIsZeroJumpI(), JumpToNext(), UnreachableCode(),
 			TagConjunctions(), TruthyAnd(), Identity()
 		);
+	return acceptOptimisedItems();
+}
+
+bool PeepholeOptimiser::acceptOptimisedItems()
+{
 	if (m_optimisedItems.size() < m_items.size() || (
 		m_optimisedItems.size() == m_items.size() && (
 			eth::bytesRequired(m_optimisedItems, 3) < eth::bytesRequired(m_items, 3) ||
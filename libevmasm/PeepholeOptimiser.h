@@ -45,9 +45,20 @@ public:
 	explicit PeepholeOptimiser(AssemblyItems& _items): m_items(_items) {}
 	virtual ~PeepholeOptimiser() = default;
 
+	/// Applies the rules in a single sweep over the items, which steps back over the items
+	/// before a rewrite to also apply the rules that only match because of it. The result is
+	/// the same as that of repeating optimiseWithoutBacktracking until it returns false.
+	/// @returns true if the items were improved.
 	bool optimise();
+	/// Applies the rules once at each position, without revisiting rewritten items.
+	/// It has to be repeated until it returns false and serves as the reference for @a optimise.
+	bool optimiseWithoutBacktracking();
 
 private:
+	/// Replaces m_items by m_optimisedItems if they are an improvement.
+	/// @returns true if the items were replaced.
+	bool acceptOptimisedItems();
+
 	AssemblyItems& m_items;
 	AssemblyItems m_optimisedItems;
 };
@@ -0,0 +1,213 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Decision tree that selects the simplification rules that can match an expression.
+ */
+
+#pragma once
+
+#include <libevmasm/Instruction.h>
+#include <libevmasm/SimplificationRule.h>
+
+#include <libdevcore/Common.h>
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * Root of a pattern or of an expression, as far as it is relevant for selecting rules.
+ * For patterns, Any matches everything. For expressions, it denotes anything that is
+ * neither an operation nor a constant.
+ */
+struct MatchRoot
+{
+	enum class Kind { Any, Constant, Operation };
+
+	static MatchRoot any() { return {}; }
+	static MatchRoot constant(boost::optional<u256> _value) { return {Kind::Constant, Instruction::STOP, std::move(_value)}; }
+	static MatchRoot operation(Instruction _instruction) { return {Kind::Operation, _instruction, {}}; }
+
+	Kind kind = Kind::Any;
+	/// Only valid for operations.
+	Instruction instruction = Instruction::STOP;
+	/// Only valid for constants. Not set for patterns that match any constant.
+	boost::optional<u256> value;
+};
+
+/**
+ * Decision tree over the instruction of an expression and the roots of its arguments.
+ * Each leaf stores the rules that can match expressions reaching it, in the order in which
+ * they were given. Those are the only rules that have to be tried, which is important since
+ * some instructions have hundreds of rules.
+ *
+ * Pattern has to provide the functions instruction(), arguments() and root(), the latter
+ * returning the MatchRoot of the pattern.
+ */
+template <class Pattern>
+class RuleDecisionTree
+{
+public:
+	using Rule = SimplificationRule<Pattern>;
+
+	RuleDecisionTree() = default;
+	RuleDecisionTree(RuleDecisionTree const&) = delete;
+	RuleDecisionTree(RuleDecisionTree&&) = default;
+	RuleDecisionTree& operator=(RuleDecisionTree const&) = delete;
+	RuleDecisionTree& operator=(RuleDecisionTree&&) = default;
+	explicit RuleDecisionTree(std::vector<Rule> _rules): m_rules(std::move(_rules))
+	{
+		std::array<std::vector<Rule const*>, 0x100> rulesByInstruction;
+		for (Rule const& rule: m_rules)
+			rulesByInstruction[uint8_t(rule.pattern.instruction())].push_back(&rule);
+		// Node zero is the empty leaf for instructions without rules.
+		m_nodes.emplace_back();
+		for (size_t instruction = 0; instruction < 0x100; ++instruction)
+			if (!rulesByInstruction[instruction].empty())
+				m_roots[instruction] = build(rulesByInstruction[instruction], 0);
+	}
+
+	bool empty() const { return m_rules.empty(); }
+
+	/// @returns the rules that can match an expression with the given instruction, in the
+	/// order in which they were given.
+	/// @param _argumentRoot function that returns the MatchRoot of the argument with the given index.
+	/// It is only called for the arguments the decision depends on.
+	template <class ArgumentRoot>
+	std::vector<Rule const*> const& candidates(Instruction _instruction, ArgumentRoot const& _argumentRoot) const
+	{
+		Node const* node = &m_nodes[m_roots[uint8_t(_instruction)]];
+		for (size_t argument = 0; !node->leaf; ++argument)
+			node = &m_nodes[node->child(_argumentRoot(argument))];
+		return node->rules;
+	}
+
+private:
+	struct Node
+	{
+		bool leaf = true;
+		std::vector<Rule const*> rules;
+		std::map<Instruction, size_t> operations;
+		std::map<u256, size_t> constants;
+		/// Child for constants that are not in @a constants.
+		size_t otherConstant = 0;
+		/// Child for everything else.
+		size_t other = 0;
+
+		size_t child(MatchRoot const& _root) const
+		{
+			if (_root.kind == MatchRoot::Kind::Operation)
+			{
+				auto it = operations.find(_root.instruction);
+				return it == operations.end() ? other : it->second;
+			}
+			else if (_root.kind == MatchRoot::Kind::Constant)
+			{
+				auto it = constants.find(*_root.value);
+				return it == constants.end() ? otherConstant : it->second;
+			}
+			return other;
+		}
+	};
+
+	/// @returns the root of the argument @a _argument of the pattern of @a _rule.
+	static MatchRoot argumentRoot(Rule const& _rule, size_t _argument)
+	{
+		std::vector<Pattern> arguments = _rule.pattern.arguments();
+		return _argument < arguments.size() ? arguments[_argument].root() : MatchRoot::any();
+	}
+
+	/// @returns true if a pattern with root @a _pattern can match an expression with root @a _expression.
+	static bool compatible(MatchRoot const& _pattern, MatchRoot const& _expression)
+	{
+		switch (_pattern.kind)
+		{
+		case MatchRoot::Kind::Any:
+			return true;
+		case MatchRoot::Kind::Constant:
+			return
+				_expression.kind == MatchRoot::Kind::Constant &&
+				(!_pattern.value || (_expression.value && *_pattern.value == *_expression.value));
+		case MatchRoot::Kind::Operation:
+			return _expression.kind == MatchRoot::Kind::Operation && _pattern.instruction == _expression.instruction;
+		}
+		return true;
+	}
+
+	/// Builds the subtree for @a _rules that decides on the arguments starting from @a _argument.
+	/// @returns the index of its root node.
+	size_t build(std::vector<Rule const*> const& _rules, size_t _argument)
+	{
+		if (_rules.empty())
+			return 0;
+		size_t index = m_nodes.size();
+		m_nodes.emplace_back();
+		bool argumentsLeft = false;
+		for (Rule const* rule: _rules)
+			if (_argument < rule->pattern.arguments().size())
+				argumentsLeft = true;
+		if (!argumentsLeft)
+		{
+			m_nodes[index].rules = _rules;
+			return index;
+		}
+
+		auto subtree = [&](MatchRoot const& _expression)
+		{
+			std::vector<Rule const*> rules;
+			for (Rule const* rule: _rules)
+				if (compatible(argumentRoot(*rule, _argument), _expression))
+					rules.push_back(rule);
+			return build(rules, _argument + 1);
+		};
+
+		std::map<Instruction, size_t> operations;
+		std::map<u256, size_t> constants;
+		for (Rule const* rule: _rules)
+		{
+			MatchRoot root = argumentRoot(*rule, _argument);
+			if (root.kind == MatchRoot::Kind::Operation && !operations.count(root.instruction))
+				operations[root.instruction] = subtree(root);
+			else if (root.kind == MatchRoot::Kind::Constant && root.value && !constants.count(*root.value))
+				constants[*root.value] = subtree(root);
+		}
+		size_t otherConstant = subtree(MatchRoot::constant({}));
+		size_t other = subtree(MatchRoot::any());
+
+		Node& node = m_nodes[index];
+		node.leaf = false;
+		node.operations = std::move(operations);
+		node.constants = std::move(constants);
+		node.otherConstant = otherConstant;
+		node.other = other;
+		return index;
+	}
+
+	std::vector<Rule> m_rules;
+	std::vector<Node> m_nodes;
+	std::array<size_t, 0x100> m_roots{};
+};
+
+}
+}
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
 
 namespace dev
@@ -54,5 +55,10 @@ struct SimplificationRule
 	std::function<bool()> feasible;
 };
 
+/// Expressions matched by the patterns of a rule, indexed by their match group.
+/// Index zero is not used, since it denotes patterns without match group.
+template <class Expression>
+using MatchGroups = std::array<Expression const*, 6>;
+
 }
 }
@@ -45,34 +45,32 @@ SimplificationRule<Pattern> const* Rules::findFirstMatch(
 	ExpressionClasses const& _classes
 )
 {
-	resetMatchGroups();
-
 	assertThrow(_expr.item, OptimizerException, "");
-	for (auto const& rule: m_rules[uint8_t(_expr.item->instruction())])
+	auto argumentRoot = [&](size_t _argument)
+	{
+		if (_argument >= _expr.arguments.size())
+			return MatchRoot::any();
+		AssemblyItem const* item = _classes.representative(_expr.arguments[_argument]).item;
+		if (item && item->type() == Operation)
+			return MatchRoot::operation(item->instruction());
+		else if (item && item->type() == Push)
+			return MatchRoot::constant(item->data());
+		else
+			return MatchRoot::any();
+	};
+	for (auto const* rule: m_rules.candidates(_expr.item->instruction(), argumentRoot))
 	{
-		if (rule.pattern.matches(_expr, _classes))
-			if (!rule.feasible || rule.feasible())
-				return &rule;
-
 		resetMatchGroups();
+		if (rule->pattern.matches(_expr, _classes))
+			if (!rule->feasible || rule->feasible())
+				return rule;
 	}
 	return nullptr;
 }
 
 bool Rules::isInitialized() const
 {
-	return !m_rules[uint8_t(Instruction::ADD)].empty();
-}
-
-void Rules::addRules(std::vector<SimplificationRule<Pattern>> const& _rules)
-{
-	for (auto const& r: _rules)
-		addRule(r);
-}
-
-void Rules::addRule(SimplificationRule<Pattern> const& _rule)
-{
-	m_rules[uint8_t(_rule.pattern.instruction())].push_back(_rule);
+	return !m_rules.empty();
 }
 
 Rules::Rules()
@@ -91,7 +89,7 @@ Rules::Rules()
 	X.setMatchGroup(4, m_matchGroups);
 	Y.setMatchGroup(5, m_matchGroups);
 
-	addRules(simplificationRuleList(A, B, C, X, Y));
+	m_rules = RuleDecisionTree<Pattern>(simplificationRuleList(A, B, C, X, Y));
 	assertThrow(isInitialized(), OptimizerException, "Rule list not properly initialized.");
 }
 
@@ -102,8 +100,9 @@ Pattern::Pattern(Instruction _instruction, std::vector<Pattern> const& _argument
 {
 }
 
-void Pattern::setMatchGroup(unsigned _group, map<unsigned, Expression const*>& _matchGroups)
+void Pattern::setMatchGroup(unsigned _group, MatchGroups<Expression>& _matchGroups)
 {
+	assertThrow(_group > 0 && _group < _matchGroups.size(), OptimizerException, "Invalid match group.");
 	m_matchGroup = _group;
 	m_matchGroups = &_matchGroups;
 }
@@ -114,7 +113,7 @@ bool Pattern::matches(Expression const& _expr, ExpressionClasses const& _classes
 		return false;
 	if (m_matchGroup)
 	{
-		if (!m_matchGroups->count(m_matchGroup))
+		if (!(*m_matchGroups)[m_matchGroup])
 			(*m_matchGroups)[m_matchGroup] = &_expr;
 		else if ((*m_matchGroups)[m_matchGroup]->id != _expr.id)
 			return false;
@@ -126,6 +125,17 @@ bool Pattern::matches(Expression const& _expr, ExpressionClasses const& _classes
 	return true;
 }
 
+MatchRoot Pattern::root() const
+{
+	if (m_type == Operation)
+		return MatchRoot::operation(m_instruction);
+	else if (m_type == Push)
+		return MatchRoot::constant(m_requireDataMatch ? boost::make_optional(data()) : boost::none);
+	else
+		// Other item types are not distinguished by the decision tree.
+		return MatchRoot::any();
+}
+
 AssemblyItem Pattern::toAssemblyItem(SourceLocation const& _location) const
 {
 	if (m_type == Operation)
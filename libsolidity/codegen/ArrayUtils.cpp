@@ -57,6 +57,12 @@ void ArrayUtils::copyArrayToStorage(ArrayType const& _targetType, ArrayType cons
 	bool haveByteOffsetSource = !directCopy && sourceIsStorage && sourceBaseType->storageBytes() <= 16;
 	bool haveByteOffsetTarget = !directCopy && targetBaseType->storageBytes() <= 16;
 	unsigned byteOffsetSize = (haveByteOffsetSource ? 1 : 0) + (haveByteOffsetTarget ? 1 : 0);
+	// Value types from memory or calldata are combined into whole slots of the target.
+	bool packedValueCopy =
+		!sourceIsStorage &&
+		haveByteOffsetTarget &&
+		sourceBaseType->isValueType() &&
+		targetBaseType->category() != Type::Category::Function;
 
 	// stack: source_ref [source_length] target_ref
 	// store target_ref
@@ -167,121 +173,129 @@ void ArrayUtils::copyArrayToStorage(ArrayType const& _targetType, ArrayType cons
 			utils.convertLengthToSize(_sourceType);
 			_context << Instruction::DUP3 << Instruction::ADD;
 			// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end
-			if (haveByteOffsetTarget)
-				_context << u256(0);
-			if (haveByteOffsetSource)
-				_context << u256(0);
-			// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
-			eth::AssemblyItem copyLoopStart = _context.newTag();
-			_context << copyLoopStart;
-			// check for loop condition
-			_context
-				<< dupInstruction(3 + byteOffsetSize) << dupInstruction(2 + byteOffsetSize)
-				<< Instruction::GT << Instruction::ISZERO;
-			eth::AssemblyItem copyLoopEnd = _context.appendConditionalJump();
-			// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
-			// copy
-			if (sourceBaseType->category() == Type::Category::Array)
-			{
-				solAssert(byteOffsetSize == 0, "Byte offset for array as base type.");
-				auto const& sourceBaseArrayType = dynamic_cast<ArrayType const&>(*sourceBaseType);
-				_context << Instruction::DUP3;
-				if (sourceBaseArrayType.location() == DataLocation::Memory)
-					_context << Instruction::MLOAD;
-				_context << Instruction::DUP3;
-				utils.copyArrayToStorage(dynamic_cast<ArrayType const&>(*targetBaseType), sourceBaseArrayType);
-				_context << Instruction::POP;
-			}
-			else if (directCopy)
-			{
-				solAssert(byteOffsetSize == 0, "Byte offset for direct copy.");
-				_context
-					<< Instruction::DUP3 << Instruction::SLOAD
-					<< Instruction::DUP3 << Instruction::SSTORE;
-			}
+			if (packedValueCopy)
+				utils.copyValueArrayToPackedStorage(_sourceType, *sourceBaseType, *targetBaseType);
 			else
 			{
-				// Note that we have to copy each element on its own in case conversion is involved.
-				// We might copy too much if there is padding at the last element, but this way end
-				// checking is easier.
+				if (haveByteOffsetTarget)
+					_context << u256(0);
+				if (haveByteOffsetSource)
+					_context << u256(0);
 				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
-				_context << dupInstruction(3 + byteOffsetSize);
-				if (_sourceType.location() == DataLocation::Storage)
+				eth::AssemblyItem copyLoopStart = _context.newTag();
+				_context << copyLoopStart;
+				// check for loop condition
+				_context
+					<< dupInstruction(3 + byteOffsetSize) << dupInstruction(2 + byteOffsetSize)
+					<< Instruction::GT << Instruction::ISZERO;
+				eth::AssemblyItem copyLoopEnd = _context.appendConditionalJump();
+				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
+				// copy
+				if (sourceBaseType->category() == Type::Category::Array)
+				{
+					solAssert(byteOffsetSize == 0, "Byte offset for array as base type.");
+					auto const& sourceBaseArrayType = dynamic_cast<ArrayType const&>(*sourceBaseType);
+					_context << Instruction::DUP3;
+					if (sourceBaseArrayType.location() == DataLocation::Memory)
+						_context << Instruction::MLOAD;
+					_context << Instruction::DUP3;
+					utils.copyArrayToStorage(dynamic_cast<ArrayType const&>(*targetBaseType), sourceBaseArrayType);
+					_context << Instruction::POP;
+				}
+				else if (directCopy)
+				{
+					solAssert(byteOffsetSize == 0, "Byte offset for direct copy.");
+					_context
+						<< Instruction::DUP3 << Instruction::SLOAD
+						<< Instruction::DUP3 << Instruction::SSTORE;
+				}
+				else
 				{
-					if (haveByteOffsetSource)
-						_context << Instruction::DUP2;
+					// Note that we have to copy each element on its own in case conversion is involved.
+					// We might copy too much if there is padding at the last element, but this way end
+					// checking is easier.
+					// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
+					_context << dupInstruction(3 + byteOffsetSize);
+					if (_sourceType.location() == DataLocation::Storage)
+					{
+						if (haveByteOffsetSource)
+							_context << Instruction::DUP2;
+						else
+							_context << u256(0);
+						StorageItem(_context, *sourceBaseType).retrieveValue(SourceLocation(), true);
+					}
+					else if (sourceBaseType->isValueType())
+						CompilerUtils(_context).loadFromMemoryDynamic(*sourceBaseType, fromCalldata, true, false);
+					else
+						solUnimplemented("Copying of type " + _sourceType.toString(false) + " to storage not yet supported.");
+					// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset] <source_value>...
+					solAssert(
+						2 + byteOffsetSize + sourceBaseType->sizeOnStack() <= 16,
+						"Stack too deep, try removing local variables."
+					);
+					// fetch target storage reference
+					_context << dupInstruction(2 + byteOffsetSize + sourceBaseType->sizeOnStack());
+					if (haveByteOffsetTarget)
+						_context << dupInstruction(1 + byteOffsetSize + sourceBaseType->sizeOnStack());
 					else
 						_context << u256(0);
-					StorageItem(_context, *sourceBaseType).retrieveValue(SourceLocation(), true);
+					StorageItem(_context, *targetBaseType).storeValue(*sourceBaseType, SourceLocation(), true);
 				}
-				else if (sourceBaseType->isValueType())
-					CompilerUtils(_context).loadFromMemoryDynamic(*sourceBaseType, fromCalldata, true, false);
+				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
+				// increment source
+				if (haveByteOffsetSource)
+					utils.incrementByteOffset(sourceBaseType->storageBytes(), 1, haveByteOffsetTarget ? 5 : 4);
 				else
-					solUnimplemented("Copying of type " + _sourceType.toString(false) + " to storage not yet supported.");
-				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset] <source_value>...
-				solAssert(
-					2 + byteOffsetSize + sourceBaseType->sizeOnStack() <= 16,
-					"Stack too deep, try removing local variables."
-				);
-				// fetch target storage reference
-				_context << dupInstruction(2 + byteOffsetSize + sourceBaseType->sizeOnStack());
+				{
+					_context << swapInstruction(2 + byteOffsetSize);
+					if (sourceIsStorage)
+						_context << sourceBaseType->storageSize();
+					else if (_sourceType.location() == DataLocation::Memory)
+						_context << sourceBaseType->memoryHeadSize();
+					else
+						_context << sourceBaseType->calldataEncodedSize(true);
+					_context
+						<< Instruction::ADD
+						<< swapInstruction(2 + byteOffsetSize);
+				}
+				// increment target
 				if (haveByteOffsetTarget)
-					_context << dupInstruction(1 + byteOffsetSize + sourceBaseType->sizeOnStack());
-				else
-					_context << u256(0);
-				StorageItem(_context, *targetBaseType).storeValue(*sourceBaseType, SourceLocation(), true);
-			}
-			// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
-			// increment source
-			if (haveByteOffsetSource)
-				utils.incrementByteOffset(sourceBaseType->storageBytes(), 1, haveByteOffsetTarget ? 5 : 4);
-			else
-			{
-				_context << swapInstruction(2 + byteOffsetSize);
-				if (sourceIsStorage)
-					_context << sourceBaseType->storageSize();
-				else if (_sourceType.location() == DataLocation::Memory)
-					_context << sourceBaseType->memoryHeadSize();
+					utils.incrementByteOffset(targetBaseType->storageBytes(), byteOffsetSize, byteOffsetSize + 2);
 				else
-					_context << sourceBaseType->calldataEncodedSize(true);
-				_context
-					<< Instruction::ADD
-					<< swapInstruction(2 + byteOffsetSize);
-			}
-			// increment target
-			if (haveByteOffsetTarget)
-				utils.incrementByteOffset(targetBaseType->storageBytes(), byteOffsetSize, byteOffsetSize + 2);
-			else
-				_context
-					<< swapInstruction(1 + byteOffsetSize)
-					<< targetBaseType->storageSize()
-					<< Instruction::ADD
-					<< swapInstruction(1 + byteOffsetSize);
-			_context.appendJumpTo(copyLoopStart);
-			_context << copyLoopEnd;
-			if (haveByteOffsetTarget)
-			{
-				// clear elements that might be left over in the current slot in target
-				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end target_byte_offset [source_byte_offset]
-				_context << dupInstruction(byteOffsetSize) << Instruction::ISZERO;
-				eth::AssemblyItem copyCleanupLoopEnd = _context.appendConditionalJump();
-				_context << dupInstruction(2 + byteOffsetSize) << dupInstruction(1 + byteOffsetSize);
-				StorageItem(_context, *targetBaseType).setToZero(SourceLocation(), true);
-				utils.incrementByteOffset(targetBaseType->storageBytes(), byteOffsetSize, byteOffsetSize + 2);
-				_context.appendJumpTo(copyLoopEnd);
-
-				_context << copyCleanupLoopEnd;
-				_context << Instruction::POP; // might pop the source, but then target is popped next
+					_context
+						<< swapInstruction(1 + byteOffsetSize)
+						<< targetBaseType->storageSize()
+						<< Instruction::ADD
+						<< swapInstruction(1 + byteOffsetSize);
+				_context.appendJumpTo(copyLoopStart);
+				_context << copyLoopEnd;
+				if (haveByteOffsetTarget)
+				{
+					// clear elements that might be left over in the current slot in target
+					// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end target_byte_offset [source_byte_offset]
+					_context << dupInstruction(byteOffsetSize) << Instruction::ISZERO;
+					eth::AssemblyItem copyCleanupLoopEnd = _context.appendConditionalJump();
+					_context << dupInstruction(2 + byteOffsetSize) << dupInstruction(1 + byteOffsetSize);
+					StorageItem(_context, *targetBaseType).setToZero(SourceLocation(), true);
+					utils.incrementByteOffset(targetBaseType->storageBytes(), byteOffsetSize, byteOffsetSize + 2);
+					_context.appendJumpTo(copyLoopEnd);
+
+					_context << copyCleanupLoopEnd;
+					_context << Instruction::POP; // might pop the source, but then target is popped next
+				}
+				if (haveByteOffsetSource)
+					_context << Instruction::POP;
 			}
-			if (haveByteOffsetSource)
-				_context << Instruction::POP;
 			_context << copyLoopEndWithoutByteOffset;
 
 			// zero-out leftovers in target
 			// stack: target_ref target_data_end source_data_pos target_data_pos_updated source_data_end
 			_context << Instruction::POP << Instruction::SWAP1 << Instruction::POP;
 			// stack: target_ref target_data_end target_data_pos_updated
-			utils.clearStorageLoop(targetBaseType);
+			if (targetBaseType->storageBytes() < 32)
+				utils.clearStorageLoop(TypeProvider::uint256());
+			else
+				utils.clearStorageLoop(targetBaseType);
 			_context << Instruction::POP;
 		}
 	);
@@ -1175,6 +1189,69 @@ void ArrayUtils::accessCallDataArrayElement(ArrayType const& _arrayType, bool _d
 	}
 }
 
+void ArrayUtils::copyValueArrayToPackedStorage(
+	ArrayType const& _sourceType,
+	Type const& _sourceBaseType,
+	Type const& _targetBaseType
+) const
+{
+	solAssert(_sourceType.location() != DataLocation::Storage, "");
+	solAssert(_sourceBaseType.isValueType() && _targetBaseType.isValueType(), "");
+	unsigned byteSize = _targetBaseType.storageBytes();
+	solAssert(byteSize <= 16, "");
+	unsigned elementsPerSlot = 32 / byteSize;
+	u256 elementMultiplier = u256(1) << (8 * byteSize);
+	// The multiplier after the last element of a slot, zero (after overflow) for completely used slots.
+	u256 slotEndMultiplier = elementsPerSlot * byteSize == 32 ? u256(0) : u256(1) << (8 * byteSize * elementsPerSlot);
+	bool fromCalldata = _sourceType.location() == DataLocation::CallData;
+	u256 sourceElementSize = fromCalldata ?
+		_sourceBaseType.calldataEncodedSize(true) :
+		_sourceBaseType.memoryHeadSize();
+
+	// stack: target_data_end source_data_pos target_data_pos source_data_end
+	eth::AssemblyItem slotLoopStart = m_context.newTag();
+	m_context << slotLoopStart;
+	m_context << Instruction::DUP3 << Instruction::DUP2 << Instruction::GT << Instruction::ISZERO;
+	eth::AssemblyItem slotLoopEnd = m_context.appendConditionalJump();
+	// stack: target_data_end source_data_pos target_data_pos source_data_end slot_value multiplier
+	m_context << u256(0) << u256(1);
+	eth::AssemblyItem elementLoopStart = m_context.newTag();
+	eth::AssemblyItem elementLoopEnd = m_context.newTag();
+	m_context << elementLoopStart;
+	m_context << Instruction::DUP5;
+	CompilerUtils(m_context).loadFromMemoryDynamic(_sourceBaseType, fromCalldata, true, false);
+	// Convert to the storage representation as in StorageItem::storeValue.
+	if (_targetBaseType.category() == Type::Category::FixedBytes)
+	{
+		solAssert(_sourceBaseType.category() == Type::Category::FixedBytes, "source not fixed bytes");
+		CompilerUtils(m_context).rightShiftNumberOnStack(256 - 8 * dynamic_cast<FixedBytesType const&>(_targetBaseType).numBytes());
+	}
+	else
+		CompilerUtils(m_context).convertType(_sourceBaseType, _targetBaseType, true, true);
+	// stack: target_data_end source_data_pos target_data_pos source_data_end slot_value multiplier value
+	m_context << Instruction::DUP2 << Instruction::MUL << Instruction::DUP3 << Instruction::OR;
+	m_context << Instruction::SWAP2 << Instruction::POP;
+	// increment source
+	m_context << Instruction::DUP5 << sourceElementSize << Instruction::ADD << Instruction::SWAP5 << Instruction::POP;
+	m_context << elementMultiplier << Instruction::MUL;
+	// continue with the next element if the slot is not full and the source not exhausted
+	m_context << Instruction::DUP1;
+	if (slotEndMultiplier == 0)
+		m_context << Instruction::ISZERO;
+	else
+		m_context << slotEndMultiplier << Instruction::EQ;
+	m_context.appendConditionalJumpTo(elementLoopEnd);
+	m_context << Instruction::DUP5 << Instruction::DUP4 << Instruction::GT;
+	m_context.appendConditionalJumpTo(elementLoopStart);
+	m_context << elementLoopEnd;
+	// stack: target_data_end source_data_pos target_data_pos source_data_end slot_value multiplier
+	m_context << Instruction::POP << Instruction::DUP3 << Instruction::SSTORE;
+	m_context << Instruction::SWAP1 << u256(1) << Instruction::ADD << Instruction::SWAP1;
+	m_context.appendJumpTo(slotLoopStart);
+	m_context << slotLoopEnd;
+	// stack: target_data_end source_data_pos target_data_pos source_data_end
+}
+
 void ArrayUtils::incrementByteOffset(unsigned _byteSize, unsigned _byteOffsetPosition, unsigned _storageOffsetPosition) const
 {
 	solAssert(_byteSize < 32, "");
@@ -110,6 +110,16 @@ public:
 	void accessCallDataArrayElement(ArrayType const& _arrayType, bool _doBoundsCheck = true) const;
 
 private:
+	/// Copies the value type elements of a memory or calldata array to a storage array of packed
+	/// value types. The elements of each slot are combined on the stack, so that every slot is
+	/// written exactly once.
+	/// Stack pre: target_data_end source_data_pos target_data_pos source_data_end
+	/// Stack post: target_data_end source_data_pos_updated target_data_pos_updated source_data_end
+	void copyValueArrayToPackedStorage(
+		ArrayType const& _sourceType,
+		Type const& _sourceBaseType,
+		Type const& _targetBaseType
+	) const;
 	/// Adds the given number of bytes to a storage byte offset counter and also increments
 	/// the storage offset if adding this number again would increase the counter over 32.
 	/// @param byteOffsetPosition the stack offset of the storage byte offset
@@ -35,10 +35,16 @@ namespace solidity {
 class Compiler
 {
 public:
-	explicit Compiler(langutil::EVMVersion _evmVersion, OptimiserSettings _optimiserSettings):
+	/// @param _yulFunctionCache if non-null, Yul helper functions are shared with the
+	/// compilers of other contracts using the same cache.
+	explicit Compiler(
+		langutil::EVMVersion _evmVersion,
+		OptimiserSettings _optimiserSettings,
+		std::shared_ptr<YulFunctionCache> _yulFunctionCache = nullptr
+	):
 		m_optimiserSettings(std::move(_optimiserSettings)),
-		m_runtimeContext(_evmVersion),
-		m_context(_evmVersion, &m_runtimeContext)
+		m_runtimeContext(_evmVersion, nullptr, _yulFunctionCache),
+		m_context(_evmVersion, &m_runtimeContext, _yulFunctionCache)
 	{ }
 
 	/// Compiles a contract.
@@ -55,9 +61,18 @@ public:
 	/// @returns Runtime assembly.
 	std::shared_ptr<eth::Assembly> runtimeAssemblyPtr() const;
 	/// @returns The entire assembled object (with constructor).
-	eth::LinkerObject assembledObject() const { return m_context.assembledObject(); }
+	/// If @a _sourceIndices is given, the source mappings are generated while assembling,
+	/// see sourceMapping() and runtimeSourceMapping().
+	eth::LinkerObject assembledObject(std::map<std::string, unsigned> const* _sourceIndices = nullptr) const
+	{
+		return m_context.assembledObject(_sourceIndices);
+	}
 	/// @returns Only the runtime object (without constructor).
 	eth::LinkerObject runtimeObject() const { return m_context.assembledRuntimeObject(m_runtimeSub); }
+	/// @returns the compressed source mapping of the entire assembly.
+	std::string const& sourceMapping() const { return m_context.assembly().sourceMapping(); }
+	/// @returns the compressed source mapping of the runtime assembly.
+	std::string const& runtimeSourceMapping() const { return m_context.assembly().sub(m_runtimeSub).sourceMapping(); }
 	/// @arg _sourceCodes is the map of input files to source code strings
 	std::string assemblyString(StringMap const& _sourceCodes = StringMap()) const
 	{
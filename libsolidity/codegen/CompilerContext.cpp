@@ -380,10 +380,61 @@ void CompilerContext::appendInlineAssembly(
 		}
 	};
 
+	// The parsed block only depends on its source, the names of the local variables,
+	// the EVM version and the settings, so repeated snippets are parsed and analysed only once.
+	// Their stack positions are resolved by identifierAccess during assembly.
+	string cacheKey = _assembly + "\n";
+	for (auto const& var: _localVariables)
+		cacheKey += var + ",";
+	cacheKey += "\n";
+	for (auto const& fun: _externallyUsedFunctions)
+		cacheKey += fun + ",";
+	cacheKey += "\n" + to_string(_system) + "\n" + m_evmVersion.name();
+	if (_optimiserSettings.runYulOptimiser && _localVariables.empty())
+		cacheKey +=
+			"\n" + to_string(m_runtimeContext != nullptr) +
+			"\n" + to_string(_optimiserSettings.optimizeStackAllocation) +
+			"\n" + to_string(_optimiserSettings.expectedExecutionsPerDeployment);
+	YulFunctionCache::ParsedBlock parsed = m_yulFunctionCache->parsedBlock(cacheKey);
+
+	if (!parsed.code)
+	{
+		parsed = parseInlineAssembly(
+			_assembly,
+			_localVariables,
+			externallyUsedIdentifiers,
+			identifierAccess,
+			_optimiserSettings
+		);
+		m_yulFunctionCache->storeParsedBlock(move(cacheKey), parsed);
+	}
+
+	yul::CodeGenerator::assemble(
+		*parsed.code,
+		*parsed.analysisInfo,
+		*m_asm,
+		m_evmVersion,
+		identifierAccess,
+		_system,
+		_optimiserSettings.optimizeStackAllocation
+	);
+
+	// Reset the source location to the one of the node (instead of the CODEGEN source location)
+	updateSourceLocation();
+}
+
+YulFunctionCache::ParsedBlock CompilerContext::parseInlineAssembly(
+	string const& _assembly,
+	vector<string> const& _localVariables,
+	set<yul::YulString> const& _externallyUsedIdentifiers,
+	yul::ExternalIdentifierAccess const& _identifierAccess,
+	OptimiserSettings const& _optimiserSettings
+)
+{
+	yul::EVMDialect const& dialect = yul::EVMDialect::strictAssemblyForEVM(m_evmVersion);
 	ErrorList errors;
 	ErrorReporter errorReporter(errors);
 	auto scanner = make_shared<langutil::Scanner>(langutil::CharStream(_assembly, "--CODEGEN--"));
-	yul::EVMDialect const& dialect = yul::EVMDialect::strictAssemblyForEVM(m_evmVersion);
 	auto parserResult = yul::Parser(errorReporter, dialect).parse(scanner, false);
 #ifdef SOL_OUTPUT_ASM
 	cout << yul::AsmPrinter()(*parserResult) << endl;
@@ -412,7 +463,7 @@ void CompilerContext::appendInlineAssembly(
 			errorReporter,
 			boost::none,
 			dialect,
-			identifierAccess.resolve
+			_identifierAccess.resolve
 		).analyze(*parserResult);
 	if (!parserResult || !errorReporter.errors().empty() || !analyzerResult)
 		reportError("Invalid assembly generated by code generator.");
@@ -429,7 +480,8 @@ void CompilerContext::appendInlineAssembly(
 			*parserResult,
 			analysisInfo,
 			_optimiserSettings.optimizeStackAllocation,
-			externallyUsedIdentifiers
+			_externallyUsedIdentifiers,
+			_optimiserSettings.statistics.get()
 		);
 		analysisInfo = yul::AsmAnalysisInfo{};
 		if (!yul::AsmAnalyzer(
@@ -437,7 +489,7 @@ void CompilerContext::appendInlineAssembly(
 			errorReporter,
 			boost::none,
 			dialect,
-			identifierAccess.resolve
+			_identifierAccess.resolve
 		).analyze(*parserResult))
 			reportError("Optimizer introduced error into inline assembly.");
 #ifdef SOL_OUTPUT_ASM
@@ -450,18 +502,7 @@ void CompilerContext::appendInlineAssembly(
 		reportError("Failed to analyze inline assembly block.");
 
 	solAssert(errorReporter.errors().empty(), "Failed to analyze inline assembly block.");
-	yul::CodeGenerator::assemble(
-		*parserResult,
-		analysisInfo,
-		*m_asm,
-		m_evmVersion,
-		identifierAccess,
-		_system,
-		_optimiserSettings.optimizeStackAllocation
-	);
-
-	// Reset the source location to the one of the node (instead of the CODEGEN source location)
-	updateSourceLocation();
+	return {parserResult, make_shared<yul::AsmAnalysisInfo>(move(analysisInfo))};
 }
 
 FunctionDefinition const& CompilerContext::resolveVirtualFunction(
@@ -500,15 +541,17 @@ void CompilerContext::updateSourceLocation()
 eth::Assembly::OptimiserSettings CompilerContext::translateOptimiserSettings(OptimiserSettings const& _settings)
 {
 	// Constructing it this way so that we notice changes in the fields.
-	eth::Assembly::OptimiserSettings asmSettings{false, false, false, false, false, false, m_evmVersion, 0};
+	eth::Assembly::OptimiserSettings asmSettings{false, false, false, false, false, false, false, m_evmVersion, 0, nullptr};
 	asmSettings.isCreation = true;
 	asmSettings.runJumpdestRemover = _settings.runJumpdestRemover;
 	asmSettings.runPeephole = _settings.runPeephole;
 	asmSettings.runDeduplicate = _settings.runDeduplicate;
 	asmSettings.runCSE = _settings.runCSE;
 	asmSettings.runConstantOptimiser = _settings.runConstantOptimiser;
+	asmSettings.runBlockLayout = _settings.runBlockLayout;
 	asmSettings.expectedExecutionsPerDeployment = _settings.expectedExecutionsPerDeployment;
 	asmSettings.evmVersion = m_evmVersion;
+	asmSettings.statistics = _settings.statistics.get();
 	return asmSettings;
 }
 
@@ -26,6 +26,7 @@
 #include <libsolidity/ast/ASTForward.h>
 #include <libsolidity/ast/Types.h>
 #include <libsolidity/codegen/ABIFunctions.h>
+#include <libsolidity/codegen/YulFunctionCache.h>
 
 #include <libsolidity/interface/OptimiserSettings.h>
 
@@ -40,6 +41,12 @@
 #include <queue>
 #include <utility>
 
+namespace yul
+{
+struct ExternalIdentifierAccess;
+class YulString;
+}
+
 namespace dev {
 namespace solidity {
 
@@ -52,11 +59,18 @@ class Compiler;
 class CompilerContext
 {
 public:
-	explicit CompilerContext(langutil::EVMVersion _evmVersion, CompilerContext* _runtimeContext = nullptr):
+	/// @param _yulFunctionCache if non-null, generated Yul helper functions and parsed
+	/// inline assembly blocks are shared with other contexts using the same cache.
+	explicit CompilerContext(
+		langutil::EVMVersion _evmVersion,
+		CompilerContext* _runtimeContext = nullptr,
+		std::shared_ptr<YulFunctionCache> _yulFunctionCache = nullptr
+	):
 		m_asm(std::make_shared<eth::Assembly>()),
 		m_evmVersion(_evmVersion),
 		m_runtimeContext(_runtimeContext),
-		m_abiFunctions(m_evmVersion)
+		m_yulFunctionCache(_yulFunctionCache ? std::move(_yulFunctionCache) : std::make_shared<YulFunctionCache>()),
+		m_abiFunctions(m_evmVersion, std::make_shared<MultiUseYulFunctionCollector>(m_yulFunctionCache, m_evmVersion))
 	{
 		if (m_runtimeContext)
 			m_runtimeSub = size_t(m_asm->newSub(m_runtimeContext->m_asm).data());
@@ -212,6 +226,8 @@ public:
 	/// @param _localVariables assigns stack positions to variables with the last one being the stack top
 	/// @param _externallyUsedFunctions a set of function names that are not to be renamed or removed.
 	/// @param _system if true, this is a "system-level" assembly where all functions use named labels.
+	/// Blocks are parsed, analysed and optimised only once per Yul function cache
+	/// and combination of source, local variables and settings.
 	void appendInlineAssembly(
 		std::string const& _assembly,
 		std::vector<std::string> const& _localVariables = std::vector<std::string>(),
@@ -249,7 +265,10 @@ public:
 		return m_asm->assemblyJSON(_sourceCodes);
 	}
 
-	eth::LinkerObject const& assembledObject() const { return m_asm->assemble(); }
+	eth::LinkerObject const& assembledObject(std::map<std::string, unsigned> const* _sourceIndices = nullptr) const
+	{
+		return m_asm->assemble(_sourceIndices);
+	}
 	eth::LinkerObject const& assembledRuntimeObject(size_t _subIndex) const { return m_asm->sub(_subIndex).assemble(); }
 
 	/**
@@ -273,6 +292,14 @@ private:
 	std::vector<ContractDefinition const*>::const_iterator superContract(ContractDefinition const& _contract) const;
 	/// Updates source location set in the assembly.
 	void updateSourceLocation();
+	/// Parses, analyses and optimises the inline assembly block for appendInlineAssembly.
+	YulFunctionCache::ParsedBlock parseInlineAssembly(
+		std::string const& _assembly,
+		std::vector<std::string> const& _localVariables,
+		std::set<yul::YulString> const& _externallyUsedIdentifiers,
+		yul::ExternalIdentifierAccess const& _identifierAccess,
+		OptimiserSettings const& _optimiserSettings
+	);
 
 	eth::Assembly::OptimiserSettings translateOptimiserSettings(OptimiserSettings const& _settings);
 
@@ -332,6 +359,8 @@ private:
 	size_t m_runtimeSub = -1;
 	/// An index of low-level function labels by name.
 	std::map<std::string, eth::AssemblyItem> m_lowLevelFunctions;
+	/// Cache of Yul helper functions and parsed inline assembly blocks, possibly shared with other contracts.
+	std::shared_ptr<YulFunctionCache> m_yulFunctionCache;
 	/// Container for ABI functions to be generated.
 	ABIFunctions m_abiFunctions;
 	/// The queue of low-level functions to generate.
@@ -34,8 +34,10 @@
 
 #include <liblangutil/ErrorReporter.h>
 
+#include <boost/optional.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 #include <algorithm>
+#include <set>
 
 using namespace std;
 using namespace dev;
@@ -264,6 +266,113 @@ void ContractCompiler::appendDelegatecallCheck()
 	// "We have not been called via DELEGATECALL".
 }
 
+namespace
+{
+
+// Code for selecting from n functions without split:
+//   n times: dup1, push4 <id_i>, eq, push2/3 <tag_i>, jumpi
+//   push2/3 <notfound> jump
+// (called SELECT[n])
+// Code for selecting from n functions with split:
+//   dup1, push4 <pivot>, gt, push2/3<tag_less>, jumpi
+//     SELECT[n/2]
+//   tag_less:
+//     SELECT[n/2]
+//
+// This means each split adds 16-18 bytes of additional code (note the additional jump out!)
+// The average execution cost if we do not split at all are:
+//   (3 + 3 + 3 + 3 + 10) * n/2 = 24 * n/2 = 12 * n
+// If we split once:
+//    (3 + 3 + 3 + 3 + 10) + 24 * n/4 = 24 * (n/4 + 1) = 6 * n + 24;
+//
+// We should split if
+//     _runs * 12 * n > _runs * (6 * n + 24) + 17 * createDataGas
+// <=> _runs * 6 * (n - 4) > 17 * createDataGas
+//
+// Which also means that the execution itself is not profitable
+// unless we have at least 5 functions.
+bool splitSelector(size_t _count, size_t _runs)
+{
+	// Start with some comparisons to avoid overflow, then do the actual comparison.
+	if (_count <= 4)
+		return false;
+	else if (_runs > (17 * eth::GasCosts::createDataGas) / 6)
+		return true;
+	else
+		return _runs * 6 * (_count - 4) > 17 * eth::GasCosts::createDataGas;
+}
+
+/// Execution gas summed over all selected functions and code size of a selector.
+struct SelectorCosts
+{
+	bigint gas;
+	bigint bytes;
+};
+
+/// @returns the costs of selecting from @a _count functions by comparisons, assuming
+/// two byte tags and not counting the jumpdests of the entry points.
+SelectorCosts comparisonSelectorCosts(size_t _count, size_t _runs)
+{
+	if (!splitSelector(_count, _runs))
+		// The i-th function is reached after i comparisons of 22 gas and 11 bytes each.
+		return SelectorCosts{22 * bigint(_count) * (_count + 1) / 2, 11 * bigint(_count) + 4};
+
+	// Every function pays for the pivot comparison, the smaller half also for tag_less.
+	SelectorCosts larger = comparisonSelectorCosts(_count - _count / 2, _runs);
+	SelectorCosts smaller = comparisonSelectorCosts(_count / 2, _runs);
+	return SelectorCosts{
+		22 * bigint(_count) + _count / 2 + larger.gas + smaller.gas,
+		12 + larger.bytes + smaller.bytes
+	};
+}
+
+// Code for selecting from n functions using a tag table:
+//   push32 <table>, push1 <modulus>, dup3, [push1 <shift>, shr,]
+//   mod, push1 4, shl, shr, push2 0xffff, and, jump
+// where the table contains the position of a check for each function:
+//   tag_check_i: dup1, push4 <id_i>, eq, push2 <entry_i>, jumpi, push2 <notfound>, jump
+// which directly follows the dispatch code.
+//
+// The dispatch costs 37 gas (43 with shift) and 46 bytes (49 with shift),
+// the check 23 gas and 16 bytes per function.
+SelectorCosts tagTableSelectorCosts(size_t _count, unsigned _shift)
+{
+	return SelectorCosts{
+		bigint(_count) * (_shift == 0 ? 37 + 23 : 43 + 23),
+		bigint(_shift == 0 ? 46 : 49) + 16 * _count
+	};
+}
+
+/// Upper bound for the positions of the checks jumped to from a tag table. Tag tables
+/// hold 16 bit positions, the remaining range is left for the optimiser, which can
+/// make the code in front of the checks slightly larger.
+size_t constexpr c_maxTagTablePosition = 0x8000;
+
+/// @returns the index of @a _id in a tag table for the given shift and modulus.
+size_t tagTableIndex(FixedHash<4> const& _id, unsigned _shift, size_t _modulus)
+{
+	return (unsigned(FixedHash<4>::Arith(_id)) >> _shift) % _modulus;
+}
+
+/// @returns a shift and modulus that map the identifiers @a _ids to different indices
+/// of a tag table, preferring no shift, or nothing if there are none.
+boost::optional<pair<unsigned, size_t>> tagTableHash(vector<FixedHash<4>> const& _ids)
+{
+	for (unsigned shift = 0; shift <= 28; ++shift)
+		for (size_t modulus = _ids.size(); modulus <= eth::AssemblyItem::tagTableSize; ++modulus)
+		{
+			set<size_t> indices;
+			for (auto const& id: _ids)
+				if (!indices.insert(tagTableIndex(id, shift, modulus)).second)
+					break;
+			if (indices.size() == _ids.size())
+				return make_pair(shift, modulus);
+		}
+	return {};
+}
+
+}
+
 void ContractCompiler::appendInternalSelector(
 	map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
 	vector<FixedHash<4>> const& _ids,
@@ -271,39 +380,26 @@ void ContractCompiler::appendInternalSelector(
 	size_t _runs
 )
 {
-	// Code for selecting from n functions without split:
-	//   n times: dup1, push4 <id_i>, eq, push2/3 <tag_i>, jumpi
-	//   push2/3 <notfound> jump
-	// (called SELECT[n])
-	// Code for selecting from n functions with split:
-	//   dup1, push4 <pivot>, gt, push2/3<tag_less>, jumpi
-	//     SELECT[n/2]
-	//   tag_less:
-	//     SELECT[n/2]
-	//
-	// This means each split adds 16-18 bytes of additional code (note the additional jump out!)
-	// The average execution cost if we do not split at all are:
-	//   (3 + 3 + 3 + 3 + 10) * n/2 = 24 * n/2 = 12 * n
-	// If we split once:
-	//    (3 + 3 + 3 + 3 + 10) + 24 * n/4 = 24 * (n/4 + 1) = 6 * n + 24;
-	//
-	// We should split if
-	//     _runs * 12 * n > _runs * (6 * n + 24) + 17 * createDataGas
-	// <=> _runs * 6 * (n - 4) > 17 * createDataGas
-	//
-	// Which also means that the execution itself is not profitable
-	// unless we have at least 5 functions.
-
-	// Start with some comparisons to avoid overflow, then do the actual comparison.
-	bool split = false;
-	if (_ids.size() <= 4)
-		split = false;
-	else if (_runs > (17 * eth::GasCosts::createDataGas) / 6)
-		split = true;
-	else
-		split = (_runs * 6 * (_ids.size() - 4) > 17 * eth::GasCosts::createDataGas);
+	// A tag table is used if the gas saved by all runs outweighs the additional
+	// code deposit costs.
+	if (
+		m_context.evmVersion().hasBitwiseShifting() &&
+		_ids.size() > 2 &&
+		_ids.size() <= eth::AssemblyItem::tagTableSize
+	)
+		if (auto hash = tagTableHash(_ids))
+		{
+			SelectorCosts comparisons = comparisonSelectorCosts(_ids.size(), _runs);
+			SelectorCosts table = tagTableSelectorCosts(_ids.size(), hash->first);
+			if (
+				bigint(_runs) * (comparisons.gas - table.gas) >
+				bigint(_ids.size()) * (table.bytes - comparisons.bytes) * eth::GasCosts::createDataGas &&
+				appendTagTableSelector(_entryPoints, _ids, _notFoundTag, hash->first, hash->second)
+			)
+				return;
+		}
 
-	if (split)
+	if (splitSelector(_ids.size(), _runs))
 	{
 		size_t pivotIndex = _ids.size() / 2;
 		FixedHash<4> pivot{_ids.at(pivotIndex)};
@@ -328,6 +424,57 @@ void ContractCompiler::appendInternalSelector(
 	}
 }
 
+bool ContractCompiler::appendTagTableSelector(
+	map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
+	vector<FixedHash<4>> const& _ids,
+	eth::AssemblyItem const& _notFoundTag,
+	unsigned _shift,
+	size_t _modulus
+)
+{
+	solAssert(_modulus <= eth::AssemblyItem::tagTableSize, "");
+	solAssert(!_ids.empty(), "");
+
+	// The checks directly follow the dispatch code, so their positions are bounded by the
+	// size of the code so far, assuming four bytes for every pushed tag.
+	size_t checksEnd =
+		eth::bytesRequired(m_context.assembly().items(), 4) +
+		size_t(tagTableSelectorCosts(_ids.size(), _shift).bytes) +
+		4 * _ids.size();
+	if (checksEnd >= c_maxTagTablePosition)
+		return false;
+
+	vector<eth::AssemblyItem> checks;
+	for (size_t i = 0; i < _ids.size(); ++i)
+		checks.emplace_back(m_context.newTag());
+	// The table also holds 16 bit tag ids. Leaving the new tags unused is harmless.
+	if (checks.back().data() >= 0x10000)
+		return false;
+
+	// Unused entries jump to the first check, which fails for all their identifiers.
+	vector<size_t> tags(_modulus, size_t(checks.front().data()));
+	for (size_t i = 0; i < _ids.size(); ++i)
+		tags[tagTableIndex(_ids[i], _shift, _modulus)] = size_t(checks[i].data());
+
+	// stack: <funhash>
+	m_context << eth::AssemblyItem::tagTable(tags) << u256(_modulus) << dupInstruction(3);
+	if (_shift > 0)
+		m_context << u256(_shift) << Instruction::SHR;
+	m_context << Instruction::MOD << u256(4) << Instruction::SHL << Instruction::SHR;
+	m_context << u256(0xffff) << Instruction::AND;
+	m_context.appendJump();
+
+	// Tag tables do not compare the function identifier, so we have to check it here.
+	for (size_t i = 0; i < _ids.size(); ++i)
+	{
+		m_context << checks[i];
+		m_context << dupInstruction(1) << u256(FixedHash<4>::Arith(_ids[i])) << Instruction::EQ;
+		m_context.appendConditionalJumpTo(_entryPoints.at(_ids[i]));
+		m_context.appendJumpTo(_notFoundTag);
+	}
+	return true;
+}
+
 namespace
 {
 
@@ -386,7 +533,12 @@ void ContractCompiler::appendFunctionSelector(ContractDefinition const& _contrac
 			sortedIDs.emplace_back(it.first);
 		}
 		std::sort(sortedIDs.begin(), sortedIDs.end());
-		appendInternalSelector(callDataUnpackerEntryPoints, sortedIDs, notFound, m_optimiserSettings.expectedExecutionsPerDeployment);
+		appendInternalSelector(
+			callDataUnpackerEntryPoints,
+			sortedIDs,
+			notFound,
+			m_optimiserSettings.expectedExecutionsPerDeployment
+		);
 	}
 
 	m_context << notFound;
@@ -87,13 +87,25 @@ private:
 	/// whose data will be modified in memory at deploy time.
 	void appendDelegatecallCheck();
 	/// Appends the function selector. Is called recursively to create a binary search tree.
-	/// @a _runs the number of intended executions of the contract to tune the split point.
+	/// @a _runs the number of intended executions of the contract to tune the split point
+	/// and the use of tag tables.
 	void appendInternalSelector(
 		std::map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
 		std::vector<FixedHash<4>> const& _ids,
 		eth::AssemblyItem const& _notFoundTag,
 		size_t _runs
 	);
+	/// Appends a function selector that jumps via a tag table indexed by
+	/// (id >> @a _shift) % @a _modulus, which has to be different for all @a _ids.
+	/// @returns false without appending any code if the tags or the positions in the
+	/// table might not fit into 16 bits.
+	bool appendTagTableSelector(
+		std::map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
+		std::vector<FixedHash<4>> const& _ids,
+		eth::AssemblyItem const& _notFoundTag,
+		unsigned _shift,
+		size_t _modulus
+	);
 	void appendFunctionSelector(ContractDefinition const& _contract);
 	void appendCallValueCheck();
 	void appendReturnValuePacker(TypePointers const& _typeParameters, bool _isLibrary);
@@ -23,6 +23,8 @@
 
 #include <liblangutil/Exceptions.h>
 
+#include <libdevcore/Common.h>
+
 #include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
@@ -41,12 +43,37 @@ string MultiUseYulFunctionCollector::requestedFunctions()
 
 string MultiUseYulFunctionCollector::createFunction(string const& _name, function<string ()> const& _creator)
 {
+	if (!m_dependencies.empty())
+		m_dependencies.back().push_back(_name);
 	if (!m_requestedFunctions.count(_name))
 	{
+		if (m_cache)
+			if (YulFunctionCache::Function const* cached = m_cache->function(m_evmVersion, _name))
+			{
+				addCachedFunction(_name, *cached);
+				return _name;
+			}
+
+		m_dependencies.emplace_back();
+		ScopeGuard dependenciesGuard([&]() { m_dependencies.pop_back(); });
 		string fun = _creator();
 		solAssert(!fun.empty(), "");
 		solAssert(fun.find("function " + _name) != string::npos, "Function not properly named.");
+		if (m_cache)
+			m_cache->storeFunction(m_evmVersion, _name, YulFunctionCache::Function{fun, m_dependencies.back()});
 		m_requestedFunctions[_name] = std::move(fun);
 	}
 	return _name;
 }
+
+void MultiUseYulFunctionCollector::addCachedFunction(string const& _name, YulFunctionCache::Function const& _function)
+{
+	m_requestedFunctions[_name] = _function.code;
+	for (string const& dependency: _function.dependencies)
+		if (!m_requestedFunctions.count(dependency))
+		{
+			YulFunctionCache::Function const* cached = m_cache->function(m_evmVersion, dependency);
+			solAssert(cached, "Dependency of cached function not cached.");
+			addCachedFunction(dependency, *cached);
+		}
+}
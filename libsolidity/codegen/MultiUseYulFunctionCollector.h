@@ -21,9 +21,13 @@
 
 #pragma once
 
+#include <libsolidity/codegen/YulFunctionCache.h>
+
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace dev
 {
@@ -37,9 +41,22 @@ namespace solidity
 class MultiUseYulFunctionCollector
 {
 public:
+	/// @param _cache if non-null, functions are taken from and added to this cache,
+	/// which can be shared with other collectors.
+	/// @param _evmVersion the EVM version the functions are generated for.
+	explicit MultiUseYulFunctionCollector(
+		std::shared_ptr<YulFunctionCache> _cache = nullptr,
+		langutil::EVMVersion _evmVersion = langutil::EVMVersion{}
+	):
+		m_cache(std::move(_cache)),
+		m_evmVersion(_evmVersion)
+	{}
+
 	/// Helper function that uses @a _creator to create a function and add it to
 	/// @a m_requestedFunctions if it has not been created yet and returns @a _name in both
 	/// cases.
+	/// If the function is in the cache, it is added together with the functions it
+	/// calls without invoking @a _creator.
 	std::string createFunction(std::string const& _name, std::function<std::string()> const& _creator);
 
 	/// @returns concatenation of all generated functions.
@@ -48,8 +65,16 @@ public:
 	std::string requestedFunctions();
 
 private:
+	/// Adds the cached function @a _name and the functions it calls.
+	void addCachedFunction(std::string const& _name, YulFunctionCache::Function const& _function);
+
 	/// Map from function name to code for a multi-use function.
 	std::map<std::string, std::string> m_requestedFunctions;
+	std::shared_ptr<YulFunctionCache> m_cache;
+	langutil::EVMVersion m_evmVersion;
+	/// Functions called by the functions that are currently being created,
+	/// the innermost one last.
+	std::vector<std::vector<std::string>> m_dependencies;
 };
 
 }
@@ -0,0 +1,56 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Cache of generated Yul helper functions shared by all contracts of a compilation.
+ */
+
+#include <libsolidity/codegen/YulFunctionCache.h>
+
+#include <libyul/AsmAnalysisInfo.h>
+#include <libyul/AsmData.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+YulFunctionCache::Function const* YulFunctionCache::function(langutil::EVMVersion _evmVersion, string const& _name)
+{
+	auto it = m_functions.find(make_pair(_evmVersion, _name));
+	if (it == m_functions.end())
+		return nullptr;
+	++m_functionHits;
+	return &it->second;
+}
+
+void YulFunctionCache::storeFunction(langutil::EVMVersion _evmVersion, string const& _name, Function _function)
+{
+	m_functions[make_pair(_evmVersion, _name)] = move(_function);
+}
+
+YulFunctionCache::ParsedBlock YulFunctionCache::parsedBlock(string const& _key)
+{
+	auto it = m_parsedBlocks.find(_key);
+	if (it == m_parsedBlocks.end())
+		return {};
+	++m_blockHits;
+	return it->second;
+}
+
+void YulFunctionCache::storeParsedBlock(string _key, ParsedBlock _block)
+{
+	m_parsedBlocks[move(_key)] = move(_block);
+}
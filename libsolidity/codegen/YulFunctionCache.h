@@ -0,0 +1,94 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Cache of generated Yul helper functions shared by all contracts of a compilation.
+ */
+
+#pragma once
+
+#include <liblangutil/EVMVersion.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace yul
+{
+struct AsmAnalysisInfo;
+struct Block;
+}
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Cache of Yul helper functions (ABI encoding and decoding functions and utility
+ * functions) shared by the compilers of all contracts of a compilation, so that
+ * helpers used by several contracts are only generated, parsed, analysed and
+ * optimised once.
+ * It also holds the parsed and analysed inline assembly snippets of the code generator.
+ * Helper functions are identified by their name and the EVM version, which together
+ * have to determine their code.
+ */
+class YulFunctionCache: public boost::noncopyable
+{
+public:
+	/// The code of a helper function and the helper functions it calls.
+	struct Function
+	{
+		std::string code;
+		std::vector<std::string> dependencies;
+	};
+
+	/// A parsed and analysed (and possibly optimised) block of helper functions.
+	/// Both are not modified by code generation and can be assembled repeatedly.
+	struct ParsedBlock
+	{
+		std::shared_ptr<yul::Block> code;
+		std::shared_ptr<yul::AsmAnalysisInfo> analysisInfo;
+	};
+
+	/// @returns the function called @a _name generated for @a _evmVersion or nullptr
+	/// if it was not generated yet.
+	Function const* function(langutil::EVMVersion _evmVersion, std::string const& _name);
+	void storeFunction(langutil::EVMVersion _evmVersion, std::string const& _name, Function _function);
+
+	/// @returns the block stored under @a _key or an empty block if there is none.
+	/// The key has to contain the source of the block and all settings that influence
+	/// its analysis and optimisation.
+	ParsedBlock parsedBlock(std::string const& _key);
+	void storeParsedBlock(std::string _key, ParsedBlock _block);
+
+	/// @returns the number of functions that were taken from the cache instead of generated.
+	size_t functionHits() const { return m_functionHits; }
+	/// @returns the number of blocks that were taken from the cache instead of parsed.
+	size_t blockHits() const { return m_blockHits; }
+
+private:
+	std::map<std::pair<langutil::EVMVersion, std::string>, Function> m_functions;
+	std::map<std::string, ParsedBlock> m_parsedBlocks;
+	size_t m_functionHits = 0;
+	size_t m_blockHits = 0;
+};
+
+}
+}
@@ -22,15 +22,55 @@
 
 #include <boost/algorithm/string/replace.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 using namespace std;
 using namespace dev;
 using namespace langutil;
 using namespace dev::solidity;
 
-BMC::BMC(smt::EncodingContext& _context, ErrorReporter& _errorReporter, map<h256, string> const& _smtlib2Responses):
+namespace
+{
+
+string checkResultName(smt::CheckResult _result)
+{
+	switch (_result)
+	{
+	case smt::CheckResult::SATISFIABLE:
+		return "sat";
+	case smt::CheckResult::UNSATISFIABLE:
+		return "unsat";
+	case smt::CheckResult::UNKNOWN:
+		return "unknown";
+	case smt::CheckResult::CONFLICTING:
+		return "conflicting";
+	case smt::CheckResult::ERROR:
+		return "error";
+	}
+	solAssert(false, "");
+}
+
+}
+
+BMC::BMC(
+	smt::EncodingContext& _context,
+	ErrorReporter& _errorReporter,
+	map<h256, string> const& _smtlib2Responses,
+	shared_ptr<smt::SMTQueryCache> _queryCache,
+	shared_ptr<VerificationResultCache> _resultCache,
+	shared_ptr<smt::SolverProcessPool> _solverProcesses,
+	ModelCheckerSettings const& _settings
+):
 	SMTEncoder(_context),
 	m_outerErrorReporter(_errorReporter),
-	m_interface(make_shared<smt::SMTPortfolio>(_smtlib2Responses))
+	m_smtlib2Responses(_smtlib2Responses),
+	m_settings(_settings),
+	m_queryCache(move(_queryCache)),
+	m_resultCache(move(_resultCache)),
+	m_solverProcesses(move(_solverProcesses))
 {
 #if defined (HAVE_Z3) || defined (HAVE_CVC4)
 	if (!_smtlib2Responses.empty())
@@ -49,17 +89,35 @@ void BMC::analyze(SourceUnit const& _source, shared_ptr<Scanner> const& _scanner
 
 	m_scanner = _scanner;
 
-	m_context.setSolver(m_interface);
 	m_context.clear();
 	m_variableUsage.setFunctionInlining(true);
 
 	_source.accept(*this);
+	runJobs();
+
+	size_t solvers = 0;
+	size_t skippedQueries = 0;
+	for (auto const& job: m_jobs)
+	{
+		m_unhandledQueries += job.unhandledQueries;
+		solvers = max(solvers, job.solvers);
+		skippedQueries += job.statistics.skippedQueries;
+		m_statistics += job.statistics;
+	}
+	m_checks.clear();
+	m_jobs.clear();
+
+	if (skippedQueries > 0)
+		m_outerErrorReporter.warning(
+			SourceLocation(),
+			"SMTChecker time budget of " + to_string(m_settings.timeBudget) + " ms exhausted. " +
+			to_string(skippedQueries) + " queries were not solved and their results are unknown."
+		);
 
-	solAssert(m_interface->solvers() > 0, "");
 	// If this check is true, Z3 and CVC4 are not available
 	// and the query answers were not provided, since SMTPortfolio
 	// guarantees that SmtLib2Interface is the first solver.
-	if (!m_interface->unhandledQueries().empty() && m_interface->solvers() == 1)
+	if (!m_unhandledQueries.empty() && solvers == 1)
 	{
 		if (!m_noSolverWarning)
 		{
@@ -123,11 +181,13 @@ FunctionDefinition const* BMC::inlinedFunctionCallToDefinition(FunctionCall cons
 
 bool BMC::visit(ContractDefinition const& _contract)
 {
+	m_currentContract = &_contract;
+	startJob();
 	SMTEncoder::visit(_contract);
 
 	/// Check targets created by state variable initialization.
 	smt::Expression constraints = m_context.assertions();
-	checkVerificationTargets(constraints);
+	checkVerificationTargets(_contract, constraints);
 	m_verificationTargets.clear();
 
 	return true;
@@ -136,7 +196,12 @@ bool BMC::visit(ContractDefinition const& _contract)
 bool BMC::visit(FunctionDefinition const& _function)
 {
 	if (m_callStack.empty())
+	{
 		reset();
+		startJob();
+		if (m_resultCache && m_currentContract)
+			m_jobs.back().encoding = VerificationResultCache::encodingInputs(_function, *m_currentContract);
+	}
 
 	/// Already visits the children.
 	SMTEncoder::visit(_function);
@@ -149,7 +214,7 @@ void BMC::endVisit(FunctionDefinition const& _function)
 	if (isRootFunction())
 	{
 		smt::Expression constraints = m_context.assertions();
-		checkVerificationTargets(constraints);
+		checkVerificationTargets(_function, constraints);
 		m_verificationTargets.clear();
 	}
 
@@ -555,46 +620,161 @@ pair<vector<smt::Expression>, vector<string>> BMC::modelExpressions()
 
 /// Verification targets.
 
-void BMC::checkVerificationTargets(smt::Expression const& _constraints)
+void BMC::checkVerificationTargets(ASTNode const& _scope, smt::Expression const& _constraints)
 {
-	for (auto& target: m_verificationTargets)
-		checkVerificationTarget(target, _constraints);
+	if (m_verificationTargets.empty())
+		return;
+
+	scheduleCheck([this, scope = _scope.location(), targets = m_verificationTargets, _constraints](CheckContext& _check) mutable {
+		checkVerificationTargets(_check, scope, targets, _constraints);
+	});
 }
 
-void BMC::checkVerificationTarget(VerificationTarget& _target, smt::Expression const& _constraints)
+void BMC::checkVerificationTargets(
+	CheckContext& _check,
+	SourceLocation const& _scope,
+	vector<VerificationTarget>& _targets,
+	smt::Expression const& _constraints
+)
 {
-	switch (_target.type)
+	// Most targets are expected to hold, so all of them are first checked in a
+	// single query that is satisfiable iff at least one of them can be violated.
+	// Only if that is the case (or the query could not be answered),
+	// the targets are checked one by one to produce precise warnings.
+	size_t individualQueries = 0;
+	vector<smt::Expression> violations;
+	for (auto const& target: _targets)
 	{
-		case VerificationTarget::Type::ConstantCondition:
-			checkConstantCondition(_target);
-			break;
+		smt::Expression path = pathConstraints(target, _constraints);
+		for (auto property: checkedProperties(target))
+		{
+			// Slicing preserves unsatisfiability, which is all this query is used for.
+			smt::Expression violation = propertyViolation(target, property);
+			auto sliced = _check.coneOfInfluence.slice(path, violation);
+			_check.statistics.droppedConstraints += sliced.second;
+			violations.emplace_back(move(sliced.first) && move(violation));
+			++individualQueries;
+		}
+	}
+
+	if (individualQueries > 1)
+	{
+		startTarget(_check, "all targets", _scope);
+		smt::Expression anyViolation = violations.front();
+		for (size_t i = 1; i < violations.size(); ++i)
+			anyViolation = anyViolation || violations[i];
+
+		_check.solver.push();
+		_check.solver.addAssertion(anyViolation);
+		auto result = checkSatisfiable(_check);
+		_check.solver.pop();
+
+		if (result == smt::CheckResult::UNSATISFIABLE)
+		{
+			_check.statistics.batchSavedQueries += individualQueries - 1;
+			return;
+		}
+	}
+
+	for (auto& target: _targets)
+		checkVerificationTarget(_check, target, _constraints);
+}
+
+void BMC::checkVerificationTarget(
+	CheckContext& _check,
+	VerificationTarget& _target,
+	smt::Expression const& _constraints
+)
+{
+	if (_target.type == VerificationTarget::Type::ConstantCondition)
+	{
+		startTarget(_check, targetTypeName(_target.type), _target.expression->location());
+		checkConstantCondition(_check, _target);
+		return;
+	}
+
+	// All properties of a target share its path constraints,
+	// so they are only asserted once.
+	_check.solver.push();
+	_check.solver.addAssertion(pathConstraints(_target, _constraints));
+	for (auto property: checkedProperties(_target))
+	{
+		startTarget(_check, targetTypeName(property), _target.expression->location());
+		switch (property)
+		{
 		case VerificationTarget::Type::Underflow:
-			checkUnderflow(_target, _constraints);
+			checkUnderflow(_check, _target);
 			break;
 		case VerificationTarget::Type::Overflow:
-			checkOverflow(_target, _constraints);
-			break;
-		case VerificationTarget::Type::UnderOverflow:
-			checkUnderflow(_target, _constraints);
-			checkOverflow(_target, _constraints);
+			checkOverflow(_check, _target);
 			break;
 		case VerificationTarget::Type::DivByZero:
-			checkDivByZero(_target);
+			checkDivByZero(_check, _target);
 			break;
 		case VerificationTarget::Type::Balance:
-			checkBalance(_target);
+			checkBalance(_check, _target);
 			break;
 		case VerificationTarget::Type::Assert:
-			checkAssert(_target);
+			checkAssert(_check, _target);
 			break;
 		default:
 			solAssert(false, "");
+		}
+	}
+	_check.solver.pop();
+}
+
+vector<BMC::VerificationTarget::Type> BMC::checkedProperties(VerificationTarget const& _target)
+{
+	solAssert(_target.type != VerificationTarget::Type::ConstantCondition, "");
+	if (_target.type == VerificationTarget::Type::UnderOverflow)
+		return {VerificationTarget::Type::Underflow, VerificationTarget::Type::Overflow};
+	return {_target.type};
+}
+
+smt::Expression BMC::pathConstraints(VerificationTarget const& _target, smt::Expression const& _constraints)
+{
+	// Only arithmetic targets take the constraints of the whole function into account.
+	switch (_target.type)
+	{
+	case VerificationTarget::Type::Underflow:
+	case VerificationTarget::Type::Overflow:
+	case VerificationTarget::Type::UnderOverflow:
+		return _target.constraints && _constraints;
+	default:
+		return _target.constraints;
+	}
+}
+
+smt::Expression BMC::propertyViolation(VerificationTarget const& _target, VerificationTarget::Type _property)
+{
+	switch (_property)
+	{
+	case VerificationTarget::Type::Underflow:
+	case VerificationTarget::Type::Overflow:
+	{
+		auto intType = dynamic_cast<IntegerType const*>(_target.expression->annotation().type);
+		solAssert(intType, "");
+		if (_property == VerificationTarget::Type::Underflow)
+			return _target.value < smt::minValue(*intType);
+		else
+			return _target.value > smt::maxValue(*intType);
+	}
+	case VerificationTarget::Type::DivByZero:
+		return _target.value == 0;
+	case VerificationTarget::Type::Balance:
+		return _target.value;
+	case VerificationTarget::Type::Assert:
+		return !_target.value;
+	default:
+		solAssert(false, "");
 	}
 }
 
-void BMC::checkConstantCondition(VerificationTarget& _target)
+void BMC::checkConstantCondition(CheckContext& _check, VerificationTarget& _target)
 {
 	checkBooleanNotConstant(
+		_check,
 		*_target.expression,
 		_target.constraints,
 		_target.value,
@@ -603,7 +783,7 @@ void BMC::checkConstantCondition(VerificationTarget& _target)
 	);
 }
 
-void BMC::checkUnderflow(VerificationTarget& _target, smt::Expression const& _constraints)
+void BMC::checkUnderflow(CheckContext& _check, VerificationTarget& _target)
 {
 	solAssert(
 		_target.type == VerificationTarget::Type::Underflow ||
@@ -613,7 +793,8 @@ void BMC::checkUnderflow(VerificationTarget& _target, smt::Expression const& _co
 	auto intType = dynamic_cast<IntegerType const*>(_target.expression->annotation().type);
 	solAssert(intType, "");
 	checkCondition(
-		_target.constraints && _constraints && _target.value < smt::minValue(*intType),
+		_check,
+		propertyViolation(_target, VerificationTarget::Type::Underflow),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -623,7 +804,7 @@ void BMC::checkUnderflow(VerificationTarget& _target, smt::Expression const& _co
 	);
 }
 
-void BMC::checkOverflow(VerificationTarget& _target, smt::Expression const& _constraints)
+void BMC::checkOverflow(CheckContext& _check, VerificationTarget& _target)
 {
 	solAssert(
 		_target.type == VerificationTarget::Type::Overflow ||
@@ -633,7 +814,8 @@ void BMC::checkOverflow(VerificationTarget& _target, smt::Expression const& _con
 	auto intType = dynamic_cast<IntegerType const*>(_target.expression->annotation().type);
 	solAssert(intType, "");
 	checkCondition(
-		_target.constraints && _constraints && _target.value > smt::maxValue(*intType),
+		_check,
+		propertyViolation(_target, VerificationTarget::Type::Overflow),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -643,11 +825,12 @@ void BMC::checkOverflow(VerificationTarget& _target, smt::Expression const& _con
 	);
 }
 
-void BMC::checkDivByZero(VerificationTarget& _target)
+void BMC::checkDivByZero(CheckContext& _check, VerificationTarget& _target)
 {
 	solAssert(_target.type == VerificationTarget::Type::DivByZero, "");
 	checkCondition(
-		_target.constraints && (_target.value == 0),
+		_check,
+		propertyViolation(_target, VerificationTarget::Type::DivByZero),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -657,11 +840,12 @@ void BMC::checkDivByZero(VerificationTarget& _target)
 	);
 }
 
-void BMC::checkBalance(VerificationTarget& _target)
+void BMC::checkBalance(CheckContext& _check, VerificationTarget& _target)
 {
 	solAssert(_target.type == VerificationTarget::Type::Balance, "");
 	checkCondition(
-		_target.constraints && _target.value,
+		_check,
+		propertyViolation(_target, VerificationTarget::Type::Balance),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -670,11 +854,12 @@ void BMC::checkBalance(VerificationTarget& _target)
 	);
 }
 
-void BMC::checkAssert(VerificationTarget& _target)
+void BMC::checkAssert(CheckContext& _check, VerificationTarget& _target)
 {
 	solAssert(_target.type == VerificationTarget::Type::Assert, "");
 	checkCondition(
-		_target.constraints && !_target.value,
+		_check,
+		propertyViolation(_target, VerificationTarget::Type::Assert),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -697,7 +882,9 @@ void BMC::addVerificationTarget(
 		modelExpressions()
 	};
 	if (_type == VerificationTarget::Type::ConstantCondition)
-		checkVerificationTarget(target);
+		scheduleCheck([this, target](CheckContext& _check) mutable {
+			checkVerificationTarget(_check, target);
+		});
 	else
 		m_verificationTargets.emplace_back(move(target));
 }
@@ -705,6 +892,7 @@ void BMC::addVerificationTarget(
 /// Solving.
 
 void BMC::checkCondition(
+	CheckContext& _check,
 	smt::Expression _condition,
 	vector<SMTEncoder::CallStackEntry> const& callStack,
 	pair<vector<smt::Expression>, vector<string>> const& _modelExpressions,
@@ -714,8 +902,8 @@ void BMC::checkCondition(
 	smt::Expression const* _additionalValue
 )
 {
-	m_interface->push();
-	m_interface->addAssertion(_condition);
+	_check.solver.push();
+	_check.solver.addAssertion(_condition);
 
 	vector<smt::Expression> expressionsToEvaluate;
 	vector<string> expressionNames;
@@ -731,22 +919,10 @@ void BMC::checkCondition(
 	}
 	smt::CheckResult result;
 	vector<string> values;
-	tie(result, values) = checkSatisfiableAndGenerateModel(expressionsToEvaluate);
-
-	string extraComment = SMTEncoder::extraComment();
-	if (m_loopExecutionHappened)
-		extraComment +=
-			"\nNote that some information is erased after the execution of loops.\n"
-			"You can re-introduce information using require().";
-	if (m_externalFunctionCallHappened)
-		extraComment+=
-			"\nNote that external function calls are not inlined,"
-			" even if the source code of the function is available."
-			" This is due to the possibility that the actual called contract"
-			" has the same ABI but implements the function differently.";
+	tie(result, values) = checkSatisfiableAndGenerateModel(_check, expressionsToEvaluate);
 
 	SecondarySourceLocation secondaryLocation{};
-	secondaryLocation.append(extraComment, SourceLocation{});
+	secondaryLocation.append(_check.abstractionComment, SourceLocation{});
 
 	switch (result)
 	{
@@ -761,12 +937,12 @@ void BMC::checkCondition(
 			solAssert(values.size() == expressionNames.size(), "");
 			map<string, string> sortedModel;
 			for (size_t i = 0; i < values.size(); ++i)
-				if (expressionsToEvaluate.at(i).name != values.at(i))
+				if (expressionsToEvaluate.at(i).name() != values.at(i))
 					sortedModel[expressionNames.at(i)] = values.at(i);
 
 			for (auto const& eval: sortedModel)
 				modelMessage << "  " << eval.first << " = " << eval.second << "\n";
-			m_errorReporter.warning(
+			_check.errorReporter.warning(
 				_location,
 				message.str(),
 				SecondarySourceLocation().append(modelMessage.str(), SourceLocation{})
@@ -777,27 +953,28 @@ void BMC::checkCondition(
 		else
 		{
 			message << ".";
-			m_errorReporter.warning(_location, message.str(), secondaryLocation);
+			_check.errorReporter.warning(_location, message.str(), secondaryLocation);
 		}
 		break;
 	}
 	case smt::CheckResult::UNSATISFIABLE:
 		break;
 	case smt::CheckResult::UNKNOWN:
-		m_errorReporter.warning(_location, _description + " might happen here.", secondaryLocation);
+		_check.errorReporter.warning(_location, _description + " might happen here.", secondaryLocation);
 		break;
 	case smt::CheckResult::CONFLICTING:
-		m_errorReporter.warning(_location, "At least two SMT solvers provided conflicting answers. Results might not be sound.");
+		_check.errorReporter.warning(_location, "At least two SMT solvers provided conflicting answers. Results might not be sound.");
 		break;
 	case smt::CheckResult::ERROR:
-		m_errorReporter.warning(_location, "Error trying to invoke SMT solver.");
+		_check.errorReporter.warning(_location, "Error trying to invoke SMT solver.");
 		break;
 	}
 
-	m_interface->pop();
+	_check.solver.pop();
 }
 
 void BMC::checkBooleanNotConstant(
+	CheckContext& _check,
 	Expression const& _condition,
 	smt::Expression const& _constraints,
 	smt::Expression const& _value,
@@ -809,20 +986,20 @@ void BMC::checkBooleanNotConstant(
 	if (dynamic_cast<Literal const*>(&_condition))
 		return;
 
-	m_interface->push();
-	m_interface->addAssertion(_constraints && _value);
-	auto positiveResult = checkSatisfiable();
-	m_interface->pop();
+	_check.solver.push();
+	_check.solver.addAssertion(_constraints && _value);
+	auto positiveResult = checkSatisfiable(_check);
+	_check.solver.pop();
 
-	m_interface->push();
-	m_interface->addAssertion(_constraints && !_value);
-	auto negatedResult = checkSatisfiable();
-	m_interface->pop();
+	_check.solver.push();
+	_check.solver.addAssertion(_constraints && !_value);
+	auto negatedResult = checkSatisfiable(_check);
+	_check.solver.pop();
 
 	if (positiveResult == smt::CheckResult::ERROR || negatedResult == smt::CheckResult::ERROR)
-		m_errorReporter.warning(_condition.location(), "Error trying to invoke SMT solver.");
+		_check.errorReporter.warning(_condition.location(), "Error trying to invoke SMT solver.");
 	else if (positiveResult == smt::CheckResult::CONFLICTING || negatedResult == smt::CheckResult::CONFLICTING)
-		m_errorReporter.warning(_condition.location(), "At least two SMT solvers provided conflicting answers. Results might not be sound.");
+		_check.errorReporter.warning(_condition.location(), "At least two SMT solvers provided conflicting answers. Results might not be sound.");
 	else if (positiveResult == smt::CheckResult::SATISFIABLE && negatedResult == smt::CheckResult::SATISFIABLE)
 	{
 		// everything fine.
@@ -832,7 +1009,7 @@ void BMC::checkBooleanNotConstant(
 		// can't do anything.
 	}
 	else if (positiveResult == smt::CheckResult::UNSATISFIABLE && negatedResult == smt::CheckResult::UNSATISFIABLE)
-		m_errorReporter.warning(_condition.location(), "Condition unreachable.", SMTEncoder::callStackMessage(_callStack));
+		_check.errorReporter.warning(_condition.location(), "Condition unreachable.", SMTEncoder::callStackMessage(_callStack));
 	else
 	{
 		string value;
@@ -847,7 +1024,7 @@ void BMC::checkBooleanNotConstant(
 			solAssert(negatedResult == smt::CheckResult::SATISFIABLE, "");
 			value = "false";
 		}
-		m_errorReporter.warning(
+		_check.errorReporter.warning(
 			_condition.location(),
 			boost::algorithm::replace_all_copy(_description, "$VALUE", value),
 			SMTEncoder::callStackMessage(_callStack)
@@ -856,23 +1033,71 @@ void BMC::checkBooleanNotConstant(
 }
 
 pair<smt::CheckResult, vector<string>>
-BMC::checkSatisfiableAndGenerateModel(vector<smt::Expression> const& _expressionsToEvaluate)
+BMC::checkSatisfiableAndGenerateModel(CheckContext& _check, vector<smt::Expression> const& _expressionsToEvaluate)
 {
 	smt::CheckResult result;
 	vector<string> values;
+	string answeredBy;
+	size_t querySize = 0;
+	chrono::steady_clock::duration solverTime{0};
+	bool skipped = false;
+	++_check.statistics.queries;
 	try
 	{
-		tie(result, values) = m_interface->check(_expressionsToEvaluate);
+		h256 cacheKey;
+		boost::optional<smt::SMTQueryCache::Result> cachedResult;
+		if (m_queryCache)
+		{
+			string query = _check.solver.query(_expressionsToEvaluate);
+			querySize = query.size();
+			cacheKey = smt::SMTQueryCache::key(query, _check.solver.identity());
+			cachedResult = m_queryCache->lookup(cacheKey);
+		}
+		if (cachedResult)
+		{
+			tie(result, values) = *cachedResult;
+			answeredBy = "cache";
+			++_check.statistics.cachedQueries;
+		}
+		else if (timeBudgetExhausted())
+		{
+			// Cached results above are still used, since they do not take solver time.
+			result = smt::CheckResult::UNKNOWN;
+			skipped = true;
+			++_check.statistics.skippedQueries;
+		}
+		else
+		{
+			auto start = chrono::steady_clock::now();
+			tie(result, values) = _check.solver.check(_expressionsToEvaluate);
+			solverTime = chrono::steady_clock::now() - start;
+			m_solverTimeSpent += solverTime.count();
+			_check.statistics.solverTime += solverTime;
+			answeredBy = _check.solver.lastAnswerer();
+			querySize = _check.solver.lastQuerySize();
+			if (m_queryCache)
+				m_queryCache->store(cacheKey, {result, values});
+		}
 	}
 	catch (smt::SolverError const& _e)
 	{
 		string description("Error querying SMT solver");
 		if (_e.comment())
 			description += ": " + *_e.comment();
-		m_errorReporter.warning(description);
+		_check.errorReporter.warning(description);
 		result = smt::CheckResult::ERROR;
 	}
 
+	if (!_check.targets.empty())
+	{
+		TargetStatistics& target = _check.targets.back();
+		++target.queries;
+		target.querySize = max(target.querySize, querySize);
+		target.solverTime += solverTime;
+		target.solver = answeredBy;
+		target.result = skipped ? "skipped" : checkResultName(result);
+	}
+
 	for (string& value: values)
 	{
 		try
@@ -886,8 +1111,241 @@ BMC::checkSatisfiableAndGenerateModel(vector<smt::Expression> const& _expression
 	return make_pair(result, values);
 }
 
-smt::CheckResult BMC::checkSatisfiable()
+smt::CheckResult BMC::checkSatisfiable(CheckContext& _check)
+{
+	return checkSatisfiableAndGenerateModel(_check, {}).first;
+}
+
+void BMC::startTarget(CheckContext& _check, string _type, SourceLocation const& _location)
+{
+	_check.targets.emplace_back();
+	_check.targets.back().type = move(_type);
+	_check.targets.back().location = _location;
+}
+
+string BMC::targetTypeName(VerificationTarget::Type _type)
 {
-	return checkSatisfiableAndGenerateModel({}).first;
+	switch (_type)
+	{
+	case VerificationTarget::Type::ConstantCondition:
+		return "constant condition";
+	case VerificationTarget::Type::Underflow:
+		return "underflow";
+	case VerificationTarget::Type::Overflow:
+		return "overflow";
+	case VerificationTarget::Type::UnderOverflow:
+		return "underflow or overflow";
+	case VerificationTarget::Type::DivByZero:
+		return "division by zero";
+	case VerificationTarget::Type::Balance:
+		return "insufficient balance";
+	case VerificationTarget::Type::Assert:
+		return "assertion";
+	}
+	solAssert(false, "");
+}
+
+bool BMC::timeBudgetExhausted() const
+{
+	if (m_settings.timeBudget == 0)
+		return false;
+	chrono::steady_clock::duration spent{m_solverTimeSpent.load()};
+	return spent >= chrono::milliseconds(m_settings.timeBudget);
 }
 
+/// Check scheduling.
+
+void BMC::startJob()
+{
+	m_jobs.push_back(Job{m_checks.size(), {}, 0, {}, nullptr, {}});
+}
+
+void BMC::scheduleCheck(function<void(CheckContext&)> _run)
+{
+	solAssert(!m_jobs.empty(), "");
+	m_checks.push_back(ScheduledCheck{
+		move(_run),
+		m_errorReporter.errors().size(),
+		m_context.declarations().size(),
+		abstractionComment(),
+		{},
+		{}
+	});
+}
+
+void BMC::runJobs()
+{
+	atomic<size_t> nextJob{0};
+	auto worker = [&]() {
+		for (size_t job = nextJob++; job < m_jobs.size(); job = nextJob++)
+			try
+			{
+				runJob(job);
+			}
+			catch (...)
+			{
+				m_jobs[job].exception = current_exception();
+			}
+	};
+
+	unsigned threadCount = m_settings.jobs ? m_settings.jobs : thread::hardware_concurrency();
+	size_t workers = min<size_t>(max(threadCount, 1u), m_jobs.size());
+	vector<thread> threads;
+	for (size_t i = 1; i < workers; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread: threads)
+		thread.join();
+
+	for (auto const& job: m_jobs)
+		if (job.exception)
+			rethrow_exception(job.exception);
+
+	ErrorList errors;
+	ErrorList const& encoderErrors = m_errorReporter.errors();
+	size_t position = 0;
+	for (auto const& check: m_checks)
+	{
+		for (; position < check.errorPosition; ++position)
+			errors.push_back(encoderErrors[position]);
+		errors += check.errors;
+		m_targetStatistics += check.targets;
+	}
+	for (; position < encoderErrors.size(); ++position)
+		errors.push_back(encoderErrors[position]);
+	m_errorReporter.clear();
+	m_errorReporter.append(errors);
+}
+
+void BMC::runJob(size_t _index)
+{
+	Job& job = m_jobs[_index];
+	size_t end = _index + 1 < m_jobs.size() ? m_jobs[_index + 1].firstCheck : m_checks.size();
+	if (job.firstCheck == end)
+		return;
+
+	shared_ptr<smt::SMTPortfolio> solver;
+	{
+		// Solvers set global parameters on construction.
+		static mutex solverConstructionMutex;
+		lock_guard<mutex> lock(solverConstructionMutex);
+		solver = make_shared<smt::SMTPortfolio>(m_smtlib2Responses, m_solverProcesses, m_settings.queryTimeout);
+	}
+
+	h256 resultKey;
+	if (m_resultCache && job.encoding)
+	{
+		resultKey = VerificationResultCache::key(*job.encoding, solver->identity(), m_settings.queryTimeout);
+		if (reuseJobOutcome(job, end, resultKey))
+		{
+			job.solvers = solver->solvers();
+			return;
+		}
+	}
+
+	smt::ConeOfInfluence coneOfInfluence;
+
+	// Declarations are replayed in the order of encoding, so that every check
+	// sees the same declarations as if it had been run immediately.
+	auto const& declarations = m_context.declarations();
+	size_t declared = 0;
+	for (size_t i = job.firstCheck; i < end; ++i)
+	{
+		ScheduledCheck& scheduled = m_checks[i];
+		for (; declared < scheduled.declarations; ++declared)
+			solver->declareVariable(declarations[declared].first, *declarations[declared].second);
+		ErrorReporter errorReporter(scheduled.errors);
+		CheckContext check{
+			*solver,
+			errorReporter,
+			scheduled.abstractionComment,
+			coneOfInfluence,
+			job.statistics,
+			scheduled.targets
+		};
+		scheduled.run(check);
+	}
+
+	job.unhandledQueries = solver->unhandledQueries();
+	job.solvers = solver->solvers();
+
+	if (m_resultCache && job.encoding)
+		storeJobOutcome(job, end, resultKey);
+}
+
+bool BMC::reuseJobOutcome(Job& _job, size_t _end, h256 const& _key)
+{
+	auto checks = m_resultCache->lookup(_key, *_job.encoding);
+	if (!checks || checks->size() != _end - _job.firstCheck)
+		return false;
+
+	for (size_t i = _job.firstCheck; i < _end; ++i)
+	{
+		VerificationResultCache::Check& check = (*checks)[i - _job.firstCheck];
+		m_checks[i].errors = std::move(check.warnings);
+		for (auto const& cachedTarget: check.targets)
+		{
+			TargetStatistics target;
+			target.type = cachedTarget.type;
+			target.location = cachedTarget.location;
+			target.result = cachedTarget.result;
+			target.solver = "cache";
+			m_checks[i].targets.push_back(move(target));
+		}
+	}
+	++_job.statistics.reusedFunctions;
+	return true;
+}
+
+void BMC::storeJobOutcome(Job const& _job, size_t _end, h256 const& _key)
+{
+	// Answers given in the auxiliary input as well as skipped and failed
+	// queries depend on the environment. The SMT-LIB2 interface is always
+	// part of the portfolio, so there is no other solver if there is only one.
+	if (_job.solvers <= 1 || _job.statistics.skippedQueries > 0)
+		return;
+
+	vector<VerificationResultCache::Check> checks;
+	for (size_t i = _job.firstCheck; i < _end; ++i)
+	{
+		VerificationResultCache::Check check;
+		check.warnings = m_checks[i].errors;
+		for (auto const& target: m_checks[i].targets)
+		{
+			if (target.result == "error")
+				return;
+			check.targets.push_back({target.type, target.location, target.result});
+		}
+		checks.push_back(move(check));
+	}
+	m_resultCache->store(_key, *_job.encoding, checks);
+}
+
+string BMC::abstractionComment()
+{
+	string comment = SMTEncoder::extraComment();
+	if (m_loopExecutionHappened)
+		comment +=
+			"\nNote that some information is erased after the execution of loops.\n"
+			"You can re-introduce information using require().";
+	if (m_externalFunctionCallHappened)
+		comment +=
+			"\nNote that external function calls are not inlined,"
+			" even if the source code of the function is available."
+			" This is due to the possibility that the actual called contract"
+			" has the same ABI but implements the function differently.";
+	return comment;
+}
+
+
+BMC::Statistics& BMC::Statistics::operator+=(Statistics const& _other)
+{
+	queries += _other.queries;
+	cachedQueries += _other.cachedQueries;
+	batchSavedQueries += _other.batchSavedQueries;
+	droppedConstraints += _other.droppedConstraints;
+	skippedQueries += _other.skippedQueries;
+	reusedFunctions += _other.reusedFunctions;
+	solverTime += _other.solverTime;
+	return *this;
+}
@@ -28,14 +28,25 @@
 #pragma once
 
 
+#include <libsolidity/formal/ConeOfInfluence.h>
 #include <libsolidity/formal/EncodingContext.h>
+#include <libsolidity/formal/ModelCheckerSettings.h>
 #include <libsolidity/formal/SMTEncoder.h>
+#include <libsolidity/formal/SMTPortfolio.h>
+#include <libsolidity/formal/SMTQueryCache.h>
 #include <libsolidity/formal/SolverInterface.h>
+#include <libsolidity/formal/SolverProcessPool.h>
+#include <libsolidity/formal/VerificationResultCache.h>
 
 #include <libsolidity/interface/ReadFile.h>
 #include <liblangutil/ErrorReporter.h>
 #include <liblangutil/Scanner.h>
 
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -53,21 +64,78 @@ namespace solidity
 class BMC: public SMTEncoder
 {
 public:
-	BMC(smt::EncodingContext& _context, langutil::ErrorReporter& _errorReporter, std::map<h256, std::string> const& _smtlib2Responses);
+	/// @param _queryCache if non-null, used to look up query results before
+	/// invoking the solvers and to store their answers afterwards.
+	/// @param _resultCache if non-null, used to reuse the outcome of root functions
+	/// whose encoding did not change instead of checking them again.
+	/// @param _solverProcesses if non-null, external solvers of this pool are queried
+	/// in addition to the linked ones.
+	BMC(
+		smt::EncodingContext& _context,
+		langutil::ErrorReporter& _errorReporter,
+		std::map<h256, std::string> const& _smtlib2Responses,
+		std::shared_ptr<smt::SMTQueryCache> _queryCache = nullptr,
+		std::shared_ptr<VerificationResultCache> _resultCache = nullptr,
+		std::shared_ptr<smt::SolverProcessPool> _solverProcesses = nullptr,
+		ModelCheckerSettings const& _settings = ModelCheckerSettings()
+	);
 
 	void analyze(SourceUnit const& _sources, std::shared_ptr<langutil::Scanner> const& _scanner);
 
 	/// This is used if the SMT solver is not directly linked into this binary.
 	/// @returns a list of inputs to the SMT solver that were not part of the argument to
 	/// the constructor.
-	std::vector<std::string> unhandledQueries() { return m_interface->unhandledQueries(); }
+	std::vector<std::string> unhandledQueries() { return m_unhandledQueries; }
+
+	/// Statistics about the queries of all analyzed source units.
+	struct Statistics
+	{
+		/// Number of queries sent to the solvers, including cached ones.
+		size_t queries = 0;
+		/// Number of queries answered by the query cache instead of a solver.
+		size_t cachedQueries = 0;
+		/// Number of queries saved because the combined query of all targets
+		/// of a function showed that none of them can be violated.
+		size_t batchSavedQueries = 0;
+		/// Number of constraints dropped by cone of influence slicing.
+		size_t droppedConstraints = 0;
+		/// Number of queries that were not solved because the time budget was used up.
+		size_t skippedQueries = 0;
+		/// Number of root functions whose outcome was taken from the verification result cache.
+		size_t reusedFunctions = 0;
+		/// Time spent in the solvers, summed up over all jobs.
+		std::chrono::steady_clock::duration solverTime{0};
+
+		Statistics& operator+=(Statistics const& _other);
+	};
+	Statistics const& statistics() const { return m_statistics; }
+
+	/// Statistics about the queries needed for a single verification target,
+	/// or for the combined query of all targets of a function.
+	struct TargetStatistics
+	{
+		/// Kind of the target, e.g. "overflow".
+		std::string type;
+		langutil::SourceLocation location;
+		/// Result of the last query: "sat", "unsat", "unknown", "conflicting", "error"
+		/// or "skipped" if the time budget was used up.
+		std::string result;
+		/// Solver that provided the result of the last query, "cache" if it was
+		/// found in the query or verification result cache or empty if no solver answered.
+		std::string solver;
+		size_t queries = 0;
+		/// Size in bytes of the largest SMT-LIB2 query.
+		size_t querySize = 0;
+		std::chrono::steady_clock::duration solverTime{0};
+	};
+	/// @returns the statistics of all verification targets checked so far,
+	/// in the order in which they were created.
+	std::vector<TargetStatistics> const& targetStatistics() const { return m_targetStatistics; }
 
 	/// @returns the FunctionDefinition of a called function if possible and should inline,
 	/// otherwise nullptr.
 	static FunctionDefinition const* inlinedFunctionCallToDefinition(FunctionCall const& _funCall);
 
-	std::shared_ptr<smt::SolverInterface> solver() { return m_interface; }
-
 private:
 	/// AST visitors.
 	/// Only nodes that lead to verification targets being built
@@ -111,6 +179,19 @@ private:
 	std::pair<std::vector<smt::Expression>, std::vector<std::string>> modelExpressions();
 	//@}
 
+	/// Solver and error reporter used while running a check, together with
+	/// the comment explaining the abstractions of the encoding at that point.
+	struct CheckContext
+	{
+		smt::SMTPortfolio& solver;
+		langutil::ErrorReporter& errorReporter;
+		std::string abstractionComment;
+		smt::ConeOfInfluence& coneOfInfluence;
+		Statistics& statistics;
+		/// Statistics of the targets checked so far, the current one last.
+		std::vector<TargetStatistics>& targets;
+	};
+
 	/// Verification targets.
 	//@{
 	struct VerificationTarget
@@ -123,14 +204,38 @@ private:
 		std::pair<std::vector<smt::Expression>, std::vector<std::string>> modelExpressions;
 	};
 
-	void checkVerificationTargets(smt::Expression const& _constraints);
-	void checkVerificationTarget(VerificationTarget& _target, smt::Expression const& _constraints = smt::Expression(true));
-	void checkConstantCondition(VerificationTarget& _target);
-	void checkUnderflow(VerificationTarget& _target, smt::Expression const& _constraints);
-	void checkOverflow(VerificationTarget& _target, smt::Expression const& _constraints);
-	void checkDivByZero(VerificationTarget& _target);
-	void checkBalance(VerificationTarget& _target);
-	void checkAssert(VerificationTarget& _target);
+	/// Schedules the check of all targets in m_verificationTargets,
+	/// which were created in @a _scope.
+	void checkVerificationTargets(ASTNode const& _scope, smt::Expression const& _constraints);
+	/// Checks @a _targets. They are first checked together in a single query
+	/// and only checked one by one if one of them might fail.
+	void checkVerificationTargets(
+		CheckContext& _check,
+		langutil::SourceLocation const& _scope,
+		std::vector<VerificationTarget>& _targets,
+		smt::Expression const& _constraints
+	);
+	void checkVerificationTarget(
+		CheckContext& _check,
+		VerificationTarget& _target,
+		smt::Expression const& _constraints = smt::Expression(true)
+	);
+	/// @returns the properties that are checked for a (non constant condition) target.
+	/// These are the target type itself except for UnderOverflow, which is split.
+	static std::vector<VerificationTarget::Type> checkedProperties(VerificationTarget const& _target);
+	/// @returns the constraints of the path leading to @a _target.
+	static smt::Expression pathConstraints(VerificationTarget const& _target, smt::Expression const& _constraints);
+	/// @returns the condition under which @a _property of @a _target is violated,
+	/// given that its path constraints hold.
+	static smt::Expression propertyViolation(VerificationTarget const& _target, VerificationTarget::Type _property);
+	/// The following checks expect the path constraints of the target to be asserted in the solver,
+	/// except for the constant condition check.
+	void checkConstantCondition(CheckContext& _check, VerificationTarget& _target);
+	void checkUnderflow(CheckContext& _check, VerificationTarget& _target);
+	void checkOverflow(CheckContext& _check, VerificationTarget& _target);
+	void checkDivByZero(CheckContext& _check, VerificationTarget& _target);
+	void checkBalance(CheckContext& _check, VerificationTarget& _target);
+	void checkAssert(CheckContext& _check, VerificationTarget& _target);
 	void addVerificationTarget(
 		VerificationTarget::Type _type,
 		smt::Expression const& _value,
@@ -140,8 +245,9 @@ private:
 
 	/// Solver related.
 	//@{
-	/// Check that a condition can be satisfied.
+	/// Check that a condition can be satisfied under the constraints asserted in the solver.
 	void checkCondition(
+		CheckContext& _check,
 		smt::Expression _condition,
 		std::vector<CallStackEntry> const& callStack,
 		std::pair<std::vector<smt::Expression>, std::vector<std::string>> const& _modelExpressions,
@@ -154,6 +260,7 @@ private:
 	/// is a literal constant.
 	/// @param _description the warning string, $VALUE will be replaced by the constant value.
 	void checkBooleanNotConstant(
+		CheckContext& _check,
 		Expression const& _condition,
 		smt::Expression const& _constraints,
 		smt::Expression const& _value,
@@ -161,21 +268,98 @@ private:
 		std::string const& _description
 	);
 	std::pair<smt::CheckResult, std::vector<std::string>>
-	checkSatisfiableAndGenerateModel(std::vector<smt::Expression> const& _expressionsToEvaluate);
+	checkSatisfiableAndGenerateModel(CheckContext& _check, std::vector<smt::Expression> const& _expressionsToEvaluate);
+
+	smt::CheckResult checkSatisfiable(CheckContext& _check);
 
-	smt::CheckResult checkSatisfiable();
+	/// Starts collecting statistics of a new target in @a _check.
+	static void startTarget(CheckContext& _check, std::string _type, langutil::SourceLocation const& _location);
+	static std::string targetTypeName(VerificationTarget::Type _type);
+	/// @returns true if the time budget for the solvers is used up.
+	bool timeBudgetExhausted() const;
+	//@}
+
+	/// Check scheduling.
+	/// Checks are not run while encoding, but collected in jobs.
+	/// A job contains the checks of a root function or of the state
+	/// variable initialization of a contract. Jobs are independent of each other
+	/// and run in parallel once the source unit is encoded, each one with its own solver.
+	//@{
+	struct Job;
+	/// Starts a new job. Subsequently scheduled checks belong to this job.
+	void startJob();
+	/// Schedules @a _run to be executed in the current job.
+	/// @a _run has to copy all encoding state it depends on.
+	void scheduleCheck(std::function<void(CheckContext&)> _run);
+	/// Runs all jobs and merges the warnings of their checks with the
+	/// warnings of the encoder in the order in which they would have occurred
+	/// if the checks had been run immediately.
+	void runJobs();
+	/// Runs the checks of the job at @a _index.
+	void runJob(size_t _index);
+	/// Replaces the checks of @a _job by their outcome stored in the verification
+	/// result cache under @a _key. @returns false if there is none.
+	bool reuseJobOutcome(Job& _job, size_t _end, h256 const& _key);
+	/// Stores the outcome of the checks of @a _job under @a _key in the verification
+	/// result cache, unless it depends on the environment.
+	void storeJobOutcome(Job const& _job, size_t _end, h256 const& _key);
+	/// @returns the comment that explains abstractions used in the current encoding.
+	std::string abstractionComment();
 	//@}
 
 	/// Flags used for better warning messages.
 	bool m_loopExecutionHappened = false;
 	bool m_externalFunctionCallHappened = false;
 
+	/// The contract whose functions are currently encoded.
+	ContractDefinition const* m_currentContract = nullptr;
+
 	/// ErrorReporter that comes from CompilerStack.
 	langutil::ErrorReporter& m_outerErrorReporter;
 
 	std::vector<VerificationTarget> m_verificationTargets;
 
-	std::shared_ptr<smt::SolverInterface> m_interface;
+	struct ScheduledCheck
+	{
+		std::function<void(CheckContext&)> run;
+		/// Number of warnings of the encoder when the check was scheduled.
+		size_t errorPosition;
+		/// Number of variable declarations when the check was scheduled.
+		size_t declarations;
+		std::string abstractionComment;
+		langutil::ErrorList errors;
+		std::vector<TargetStatistics> targets;
+	};
+	struct Job
+	{
+		/// Index of the first check of the job in m_checks.
+		size_t firstCheck;
+		std::vector<std::string> unhandledQueries;
+		size_t solvers = 0;
+		Statistics statistics;
+		std::exception_ptr exception;
+		/// Inputs of the encoding of the root function, if the job checks one
+		/// and its outcome can be cached.
+		boost::optional<VerificationResultCache::EncodingInputs> encoding;
+	};
+	std::vector<ScheduledCheck> m_checks;
+	std::vector<Job> m_jobs;
+
+	std::map<h256, std::string> m_smtlib2Responses;
+	std::vector<std::string> m_unhandledQueries;
+	Statistics m_statistics;
+	std::vector<TargetStatistics> m_targetStatistics;
+
+	ModelCheckerSettings const m_settings;
+	/// Time spent in the solvers by all jobs, used to enforce the time budget.
+	std::atomic<std::chrono::steady_clock::rep> m_solverTimeSpent{0};
+
+	/// Persistent cache of query results, might be null.
+	std::shared_ptr<smt::SMTQueryCache> m_queryCache;
+	/// Persistent cache of the outcome of root functions, might be null.
+	std::shared_ptr<VerificationResultCache> m_resultCache;
+	/// External solver processes, might be null.
+	std::shared_ptr<smt::SolverProcessPool> m_solverProcesses;
 };
 
 }
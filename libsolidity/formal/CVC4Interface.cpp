@@ -24,18 +24,26 @@ using namespace std;
 using namespace dev;
 using namespace dev::solidity::smt;
 
-CVC4Interface::CVC4Interface():
-	m_solver(&m_context)
+CVC4Interface::CVC4Interface(unsigned _queryTimeout):
+	m_solver(&m_context),
+	m_queryTimeout(_queryTimeout)
 {
 	reset();
 }
 
+string CVC4Interface::identity() const
+{
+	return "cvc4-" + CVC4::Configuration::getVersionString();
+}
+
 void CVC4Interface::reset()
 {
 	m_variables.clear();
+	m_translations.clear();
 	m_solver.reset();
 	m_solver.setOption("produce-models", true);
-	m_solver.setTimeLimit(queryTimeout);
+	if (m_queryTimeout > 0)
+		m_solver.setTimeLimit(m_queryTimeout);
 }
 
 void CVC4Interface::push()
@@ -115,20 +123,30 @@ pair<CheckResult, vector<string>> CVC4Interface::check(vector<Expression> const&
 }
 
 CVC4::Expr CVC4Interface::toCVC4Expr(Expression const& _expr)
+{
+	auto cached = m_translations.find(_expr);
+	if (cached != m_translations.end())
+		return cached->second;
+	CVC4::Expr translated = translate(_expr);
+	m_translations.emplace(_expr, translated);
+	return translated;
+}
+
+CVC4::Expr CVC4Interface::translate(Expression const& _expr)
 {
 	// Variable
-	if (_expr.arguments.empty() && m_variables.count(_expr.name))
-		return m_variables.at(_expr.name);
+	if (_expr.arguments().empty() && m_variables.count(_expr.name()))
+		return m_variables.at(_expr.name());
 
 	vector<CVC4::Expr> arguments;
-	for (auto const& arg: _expr.arguments)
+	for (auto const& arg: _expr.arguments())
 		arguments.push_back(toCVC4Expr(arg));
 
 	try
 	{
-		string const& n = _expr.name;
+		string const& n = _expr.name();
 		// Function application
-		if (!arguments.empty() && m_variables.count(_expr.name))
+		if (!arguments.empty() && m_variables.count(n))
 			return m_context.mkExpr(CVC4::kind::APPLY_UF, m_variables.at(n), arguments);
 		// Literal
 		else if (arguments.empty())
@@ -33,6 +33,8 @@
 #undef _GLIBCXX_PERMIT_BACKWARD_HASH
 #endif
 
+#include <unordered_map>
+
 namespace dev
 {
 namespace solidity
@@ -43,7 +45,8 @@ namespace smt
 class CVC4Interface: public SolverInterface, public boost::noncopyable
 {
 public:
-	CVC4Interface();
+	/// @param _queryTimeout timeout of a single query in milliseconds, zero for no timeout.
+	explicit CVC4Interface(unsigned _queryTimeout = defaultQueryTimeout);
 
 	void reset() override;
 
@@ -55,14 +58,21 @@ public:
 	void addAssertion(Expression const& _expr) override;
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
 
+	std::string identity() const override;
+
 private:
+	/// @returns the translation of @a _expr, reusing the translation of
+	/// subexpressions that were already translated.
 	CVC4::Expr toCVC4Expr(Expression const& _expr);
+	CVC4::Expr translate(Expression const& _expr);
 	CVC4::Type cvc4Sort(smt::Sort const& _sort);
 	std::vector<CVC4::Type> cvc4Sort(std::vector<smt::SortPointer> const& _sorts);
 
 	CVC4::ExprManager m_context;
 	CVC4::SmtEngine m_solver;
+	unsigned m_queryTimeout;
 	std::map<std::string, CVC4::Expr> m_variables;
+	std::unordered_map<Expression, CVC4::Expr, Expression::Hash, Expression::Identical> m_translations;
 };
 
 }
@@ -0,0 +1,120 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/ConeOfInfluence.h>
+
+#include <map>
+#include <unordered_set>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+pair<Expression, size_t> ConeOfInfluence::slice(Expression const& _constraints, Expression const& _goal)
+{
+	// Flatten the (usually right-nested) conjunction, removing duplicates and `true`.
+	vector<Expression> conjuncts;
+	unordered_set<Expression, Expression::Hash, Expression::Identical> seen;
+	vector<Expression> toVisit{_constraints};
+	while (!toVisit.empty())
+	{
+		Expression expression = move(toVisit.back());
+		toVisit.pop_back();
+		if (expression.name() == "and" && expression.arguments().size() == 2)
+		{
+			toVisit.push_back(expression.arguments()[1]);
+			toVisit.push_back(expression.arguments()[0]);
+		}
+		else if (expression.name() != "true" && seen.insert(expression).second)
+			conjuncts.push_back(move(expression));
+	}
+
+	map<string, vector<size_t>> conjunctsBySymbol;
+	vector<bool> kept(conjuncts.size(), false);
+	for (size_t i = 0; i < conjuncts.size(); ++i)
+	{
+		auto const& conjunctSymbols = symbols(conjuncts[i]);
+		if (conjunctSymbols.empty())
+			kept[i] = true;
+		for (auto const& symbol: conjunctSymbols)
+			conjunctsBySymbol[symbol].push_back(i);
+	}
+
+	set<string> relevant = symbols(_goal);
+	vector<string> toProcess(relevant.begin(), relevant.end());
+	while (!toProcess.empty())
+	{
+		string symbol = move(toProcess.back());
+		toProcess.pop_back();
+		auto it = conjunctsBySymbol.find(symbol);
+		if (it == conjunctsBySymbol.end())
+			continue;
+		for (size_t i: it->second)
+			if (!kept[i])
+			{
+				kept[i] = true;
+				for (auto const& other: symbols(conjuncts[i]))
+					if (relevant.insert(other).second)
+						toProcess.push_back(other);
+			}
+	}
+
+	vector<Expression> keptConjuncts;
+	for (size_t i = 0; i < conjuncts.size(); ++i)
+		if (kept[i])
+			keptConjuncts.push_back(conjuncts[i]);
+	size_t dropped = conjuncts.size() - keptConjuncts.size();
+	if (keptConjuncts.empty())
+		return {Expression(true), dropped};
+
+	Expression result = keptConjuncts.back();
+	for (size_t i = keptConjuncts.size() - 1; i > 0; --i)
+		result = keptConjuncts[i - 1] && move(result);
+	return {move(result), dropped};
+}
+
+set<string> const& ConeOfInfluence::symbols(Expression const& _expression)
+{
+	auto cached = m_symbols.find(_expression);
+	if (cached != m_symbols.end())
+		return cached->second;
+
+	set<string> result;
+	string const& name = _expression.name();
+	if (_expression.arguments().empty())
+	{
+		bool isLiteral =
+			name == "true" ||
+			name == "false" ||
+			isdigit(static_cast<unsigned char>(name.front())) ||
+			(name.front() == '-' && name.size() > 1);
+		if (!isLiteral)
+			result.insert(name);
+	}
+	else
+	{
+		// Applications of uninterpreted functions do not have a known arity.
+		if (!_expression.hasCorrectArity())
+			result.insert(name);
+		for (auto const& argument: _expression.arguments())
+		{
+			auto const& argumentSymbols = symbols(argument);
+			result.insert(argumentSymbols.begin(), argumentSymbols.end());
+		}
+	}
+	return m_symbols.emplace(_expression, move(result)).first->second;
+}
@@ -0,0 +1,61 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace dev
+{
+namespace solidity
+{
+namespace smt
+{
+
+/**
+ * Cone of influence slicing of constraints.
+ * Splits a conjunction of constraints into its conjuncts and keeps only those
+ * that transitively share symbols with a goal expression. Since the encoding is
+ * in SSA form, every symbol is a single version of a program variable.
+ * Conjuncts without any symbols are always kept.
+ *
+ * Slicing preserves unsatisfiability: if the sliced constraints and the goal are
+ * unsatisfiable, so are the original constraints and the goal. The converse does
+ * not hold if the dropped conjuncts are unsatisfiable on their own.
+ */
+class ConeOfInfluence
+{
+public:
+	/// @returns the conjunction of the conjuncts of @a _constraints in the cone of
+	/// influence of @a _goal, together with the number of dropped conjuncts.
+	std::pair<Expression, size_t> slice(Expression const& _constraints, Expression const& _goal);
+
+private:
+	/// @returns the variables and uninterpreted functions occurring in @a _expression.
+	std::set<std::string> const& symbols(Expression const& _expression);
+
+	std::unordered_map<Expression, std::set<std::string>, Expression::Hash, Expression::Identical> m_symbols;
+};
+
+}
+}
+}
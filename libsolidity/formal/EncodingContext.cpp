@@ -46,9 +46,21 @@ void EncodingContext::reset()
 void EncodingContext::clear()
 {
 	m_variables.clear();
+	m_declarations.clear();
+	m_declaredNames.clear();
 	reset();
 }
 
+Expression EncodingContext::newVariable(string _name, SortPointer _sort)
+{
+	solAssert(_sort, "");
+	if (m_declaredNames.insert(_name).second)
+		m_declarations.emplace_back(_name, _sort);
+	if (m_solver)
+		return m_solver->newVariable(move(_name), move(_sort));
+	return Expression(move(_name), {}, move(_sort));
+}
+
 /// Variables.
 
 shared_ptr<SymbolicVariable> EncodingContext::variable(solidity::VariableDeclaration const& _varDecl)
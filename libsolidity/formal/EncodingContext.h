@@ -54,12 +54,11 @@ public:
 		m_solver = _solver;
 	}
 
-	/// Forwards variable creation to the solver.
-	Expression newVariable(std::string _name, SortPointer _sort)
-	{
-		solAssert(m_solver, "");
-		return m_solver->newVariable(move(_name), move(_sort));
-	}
+	/// Records the declaration of a variable and forwards it to the solver, if set.
+	Expression newVariable(std::string _name, SortPointer _sort);
+	/// @returns the declarations of all variables created since the last clear,
+	/// in order of creation.
+	std::vector<std::pair<std::string, SortPointer>> const& declarations() const { return m_declarations; }
 
 	/// Variables.
 	//@{
@@ -176,6 +175,11 @@ private:
 	/// Solver can be SMT solver or Horn solver in the future.
 	std::shared_ptr<SolverInterface> m_solver;
 
+	/// Variable declarations in order of creation.
+	std::vector<std::pair<std::string, SortPointer>> m_declarations;
+	/// Names of the declared variables.
+	std::set<std::string> m_declaredNames;
+
 	/// Assertion stack.
 	std::vector<Expression> m_assertions;
 	//@}
@@ -17,13 +17,33 @@
 
 #include <libsolidity/formal/ModelChecker.h>
 
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+
 using namespace std;
 using namespace dev;
 using namespace langutil;
 using namespace dev::solidity;
 
-ModelChecker::ModelChecker(ErrorReporter& _errorReporter, map<h256, string> const& _smtlib2Responses):
-	m_bmc(m_context, _errorReporter, _smtlib2Responses),
+ModelChecker::ModelChecker(
+	ErrorReporter& _errorReporter,
+	map<h256, string> const& _smtlib2Responses,
+	string const& _queryCacheDirectory,
+	shared_ptr<smt::SolverProcessPool> _solverProcesses,
+	ModelCheckerSettings const& _settings
+):
+	m_bmc(
+		m_context,
+		_errorReporter,
+		_smtlib2Responses,
+		_queryCacheDirectory.empty() ? nullptr : make_shared<smt::SMTQueryCache>(_queryCacheDirectory),
+		_queryCacheDirectory.empty() ?
+			nullptr :
+			make_shared<VerificationResultCache>((boost::filesystem::path(_queryCacheDirectory) / "functions").string()),
+		move(_solverProcesses),
+		_settings
+	),
 	m_context()
 {
 }
@@ -40,3 +60,37 @@ vector<string> ModelChecker::unhandledQueries()
 {
 	return m_bmc.unhandledQueries();
 }
+
+Json::Value ModelChecker::statistics() const
+{
+	auto milliseconds = [](chrono::steady_clock::duration _time) {
+		return chrono::duration<double, milli>(_time).count();
+	};
+
+	BMC::Statistics const& totals = m_bmc.statistics();
+	Json::Value statistics(Json::objectValue);
+	statistics["queries"] = Json::UInt64(totals.queries);
+	statistics["cachedQueries"] = Json::UInt64(totals.cachedQueries);
+	statistics["batchSavedQueries"] = Json::UInt64(totals.batchSavedQueries);
+	statistics["skippedQueries"] = Json::UInt64(totals.skippedQueries);
+	statistics["reusedFunctions"] = Json::UInt64(totals.reusedFunctions);
+	statistics["droppedConstraints"] = Json::UInt64(totals.droppedConstraints);
+	statistics["solverTime"] = milliseconds(totals.solverTime);
+
+	statistics["targets"] = Json::arrayValue;
+	for (auto const& target: m_bmc.targetStatistics())
+	{
+		Json::Value entry(Json::objectValue);
+		entry["type"] = target.type;
+		entry["source"] = target.location.source ? target.location.source->name() : "";
+		entry["start"] = target.location.start;
+		entry["end"] = target.location.end;
+		entry["result"] = target.result;
+		entry["solver"] = target.solver;
+		entry["queries"] = Json::UInt64(target.queries);
+		entry["querySize"] = Json::UInt64(target.querySize);
+		entry["solverTime"] = milliseconds(target.solverTime);
+		statistics["targets"].append(move(entry));
+	}
+	return statistics;
+}
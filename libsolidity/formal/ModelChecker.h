@@ -24,11 +24,14 @@
 
 #include <libsolidity/formal/BMC.h>
 #include <libsolidity/formal/EncodingContext.h>
+#include <libsolidity/formal/ModelCheckerSettings.h>
 
 #include <libsolidity/interface/ReadFile.h>
 #include <liblangutil/ErrorReporter.h>
 #include <liblangutil/Scanner.h>
 
+#include <json/json.h>
+
 namespace langutil
 {
 class ErrorReporter;
@@ -43,7 +46,16 @@ namespace solidity
 class ModelChecker
 {
 public:
-	ModelChecker(langutil::ErrorReporter& _errorReporter, std::map<h256, std::string> const& _smtlib2Responses);
+	/// @param _queryCacheDirectory if not empty, SMT query results and the outcome
+	/// of root functions are cached persistently in this directory.
+	/// @param _solverProcesses if non-null, pool of external SMT-LIB2 solvers to query.
+	ModelChecker(
+		langutil::ErrorReporter& _errorReporter,
+		std::map<h256, std::string> const& _smtlib2Responses,
+		std::string const& _queryCacheDirectory = "",
+		std::shared_ptr<smt::SolverProcessPool> _solverProcesses = nullptr,
+		ModelCheckerSettings const& _settings = ModelCheckerSettings()
+	);
 
 	void analyze(SourceUnit const& _sources, std::shared_ptr<langutil::Scanner> const& _scanner);
 
@@ -52,6 +64,14 @@ public:
 	/// the constructor.
 	std::vector<std::string> unhandledQueries();
 
+	/// @returns statistics about the solver queries of all analyzed sources:
+	/// totals, including the queries saved by the query cache and by checking all
+	/// targets of a function at once, and, for each verification target, its location,
+	/// result, the solver that answered, the number and size of the queries and the
+	/// solver time.
+	/// Times are given in milliseconds.
+	Json::Value statistics() const;
+
 private:
 	/// Bounded Model Checker engine.
 	BMC m_bmc;
@@ -0,0 +1,45 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Settings of the SMTChecker that trade precision for analysis time.
+ */
+
+#pragma once
+
+#include <libsolidity/formal/SolverInterface.h>
+
+namespace dev
+{
+namespace solidity
+{
+
+struct ModelCheckerSettings
+{
+	/// Timeout of a single query to the linked solvers in milliseconds.
+	/// Zero means no timeout.
+	unsigned queryTimeout = smt::SolverInterface::defaultQueryTimeout;
+	/// Time in milliseconds the solvers may spend on all queries of a compilation,
+	/// summed up over all queries. Once it is used up, the remaining queries are
+	/// not solved and their results are unknown. Zero means no limit.
+	unsigned timeBudget = 0;
+	/// Number of threads that check the verification targets of different functions
+	/// in parallel. Zero means one per hardware thread.
+	unsigned jobs = 0;
+};
+
+}
+}
@@ -29,6 +29,7 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 
@@ -65,35 +66,23 @@ void SMTLib2Interface::pop()
 
 void SMTLib2Interface::declareVariable(string const& _name, Sort const& _sort)
 {
-	if (_sort.kind == Kind::Function)
-		declareFunction(_name, _sort);
-	else if (!m_variables.count(_name))
+	// TODO Use domain and codomain as key as well
+	if (!m_variables.count(_name))
 	{
 		m_variables.insert(_name);
-		write("(declare-fun |" + _name + "| () " + toSmtLibSort(_sort) + ')');
+		write(declaration(_name, _sort));
 	}
 }
 
-void SMTLib2Interface::declareFunction(string const& _name, Sort const& _sort)
+string SMTLib2Interface::declaration(string const& _name, Sort const& _sort)
 {
-	solAssert(_sort.kind == smt::Kind::Function, "");
-	// TODO Use domain and codomain as key as well
-	if (!m_variables.count(_name))
+	if (_sort.kind == Kind::Function)
 	{
 		FunctionSort fSort = dynamic_cast<FunctionSort const&>(_sort);
-		string domain = toSmtLibSort(fSort.domain);
-		string codomain = toSmtLibSort(*fSort.codomain);
-		m_variables.insert(_name);
-		write(
-			"(declare-fun |" +
-			_name +
-			"| " +
-			domain +
-			" " +
-			codomain +
-			")"
-		);
+		return "(declare-fun |" + _name + "| " + toSmtLibSort(fSort.domain) + " " + toSmtLibSort(*fSort.codomain) + ")";
 	}
+	else
+		return "(declare-fun |" + _name + "| () " + toSmtLibSort(_sort) + ")";
 }
 
 void SMTLib2Interface::addAssertion(Expression const& _expr)
@@ -103,37 +92,68 @@ void SMTLib2Interface::addAssertion(Expression const& _expr)
 
 pair<CheckResult, vector<string>> SMTLib2Interface::check(vector<Expression> const& _expressionsToEvaluate)
 {
-	string response = querySolver(
-		boost::algorithm::join(m_accumulatedOutput, "\n") +
-		checkSatAndGetValuesCommand(_expressionsToEvaluate)
-	);
+	string script = query(_expressionsToEvaluate);
+	m_lastQuerySize = script.size();
+	m_lastQueryUnhandled = false;
+	return parseResponse(querySolver(script));
+}
 
+void SMTLib2Interface::dropLastUnhandledQuery()
+{
+	if (m_lastQueryUnhandled)
+	{
+		m_unhandledQueries.pop_back();
+		m_lastQueryUnhandled = false;
+	}
+}
+
+pair<CheckResult, vector<string>> SMTLib2Interface::parseResponse(string const& _response)
+{
 	CheckResult result;
 	// TODO proper parsing
-	if (boost::starts_with(response, "sat\n"))
+	if (boost::starts_with(_response, "sat\n"))
 		result = CheckResult::SATISFIABLE;
-	else if (boost::starts_with(response, "unsat\n"))
+	else if (boost::starts_with(_response, "unsat\n"))
 		result = CheckResult::UNSATISFIABLE;
-	else if (boost::starts_with(response, "unknown\n"))
+	else if (boost::starts_with(_response, "unknown\n"))
 		result = CheckResult::UNKNOWN;
 	else
 		result = CheckResult::ERROR;
 
 	vector<string> values;
-	if (result == CheckResult::SATISFIABLE && result != CheckResult::ERROR)
-		values = parseValues(find(response.cbegin(), response.cend(), '\n'), response.cend());
+	if (result == CheckResult::SATISFIABLE)
+		values = parseValues(find(_response.cbegin(), _response.cend(), '\n'), _response.cend());
 	return make_pair(result, values);
 }
 
+string SMTLib2Interface::query(vector<Expression> const& _expressionsToEvaluate)
+{
+	return
+		boost::algorithm::join(m_accumulatedOutput, "\n") +
+		checkSatAndGetValuesCommand(_expressionsToEvaluate);
+}
+
+void SMTLib2Interface::toSExpr(Expression const& _expr, ostream& _out)
+{
+	if (_expr.arguments().empty())
+	{
+		_out << _expr.name();
+		return;
+	}
+	_out << '(' << _expr.name();
+	for (auto const& arg: _expr.arguments())
+	{
+		_out << ' ';
+		toSExpr(arg, _out);
+	}
+	_out << ')';
+}
+
 string SMTLib2Interface::toSExpr(Expression const& _expr)
 {
-	if (_expr.arguments.empty())
-		return _expr.name;
-	std::string sexpr = "(" + _expr.name;
-	for (auto const& arg: _expr.arguments)
-		sexpr += " " + toSExpr(arg);
-	sexpr += ")";
-	return sexpr;
+	ostringstream sexpr;
+	toSExpr(_expr, sexpr);
+	return sexpr.str();
 }
 
 string SMTLib2Interface::toSmtLibSort(Sort const& _sort)
@@ -171,41 +191,56 @@ void SMTLib2Interface::write(string _data)
 
 string SMTLib2Interface::checkSatAndGetValuesCommand(vector<Expression> const& _expressionsToEvaluate)
 {
-	string command;
+	ostringstream command;
+	checkSatAndGetValuesCommand(_expressionsToEvaluate, command);
+	return command.str();
+}
+
+void SMTLib2Interface::checkSatAndGetValuesCommand(vector<Expression> const& _expressionsToEvaluate, ostream& _out)
+{
 	if (_expressionsToEvaluate.empty())
-		command = "(check-sat)\n";
+		_out << "(check-sat)\n";
 	else
 	{
 		// TODO make sure these are unique
 		for (size_t i = 0; i < _expressionsToEvaluate.size(); i++)
 		{
 			auto const& e = _expressionsToEvaluate.at(i);
-			solAssert(e.sort->kind == Kind::Int || e.sort->kind == Kind::Bool, "Invalid sort for expression to evaluate.");
-			command += "(declare-const |EVALEXPR_" + to_string(i) + "| " + (e.sort->kind == Kind::Int ? "Int" : "Bool") + ")\n";
-			command += "(assert (= |EVALEXPR_" + to_string(i) + "| " + toSExpr(e) + "))\n";
+			solAssert(e.sort()->kind == Kind::Int || e.sort()->kind == Kind::Bool, "Invalid sort for expression to evaluate.");
+			_out << "(declare-const |EVALEXPR_" << i << "| " << (e.sort()->kind == Kind::Int ? "Int" : "Bool") << ")\n";
+			_out << "(assert (= |EVALEXPR_" << i << "| ";
+			toSExpr(e, _out);
+			_out << "))\n";
 		}
-		command += "(check-sat)\n";
-		command += "(get-value (";
+		_out << "(check-sat)\n";
+		_out << "(get-value (";
 		for (size_t i = 0; i < _expressionsToEvaluate.size(); i++)
-			command += "|EVALEXPR_" + to_string(i) + "| ";
-		command += "))\n";
+			_out << "|EVALEXPR_" << i << "| ";
+		_out << "))\n";
 	}
-
-	return command;
 }
 
 vector<string> SMTLib2Interface::parseValues(string::const_iterator _start, string::const_iterator _end)
 {
+	// The response has the form ((name value) (name value) ...),
+	// where values can be nested expressions like (- 1).
 	vector<string> values;
-	while (_start < _end)
-	{
-		auto valStart = find(_start, _end, ' ');
-		if (valStart < _end)
-			++valStart;
-		auto valEnd = find(valStart, _end, ')');
-		values.emplace_back(valStart, valEnd);
-		_start = find(valEnd, _end, '(');
-	}
+	int depth = 0;
+	auto valueStart = _end;
+	for (auto it = _start; it != _end; ++it)
+		if (*it == '(')
+			++depth;
+		else if (*it == ')')
+		{
+			if (depth == 2 && valueStart != _end)
+			{
+				values.emplace_back(valueStart, it);
+				valueStart = _end;
+			}
+			--depth;
+		}
+		else if (*it == ' ' && depth == 2 && valueStart == _end)
+			valueStart = next(it);
 
 	return values;
 }
@@ -218,6 +253,7 @@ string SMTLib2Interface::querySolver(string const& _input)
 	else
 	{
 		m_unhandledQueries.push_back(_input);
+		m_lastQueryUnhandled = true;
 		return "unknown\n";
 	}
 }
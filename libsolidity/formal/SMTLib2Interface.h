@@ -27,6 +27,7 @@
 #include <boost/noncopyable.hpp>
 #include <cstdio>
 #include <map>
+#include <ostream>
 #include <set>
 #include <string>
 #include <vector>
@@ -54,18 +55,41 @@ public:
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
 
 	std::vector<std::string> unhandledQueries() override { return m_unhandledQueries; }
+	/// Removes the script of the last check from the unhandled queries if it was added
+	/// there, since another solver answered it.
+	void dropLastUnhandledQuery();
+
+	std::string identity() const override { return "smtlib2"; }
+
+	/// @returns the SMT-LIB2 script that `check(_expressionsToEvaluate)` would
+	/// send to the solver in the current state.
+	std::string query(std::vector<Expression> const& _expressionsToEvaluate);
+
+	/// @returns the size in bytes of the script sent by the last check.
+	size_t lastQuerySize() const { return m_lastQuerySize; }
+
+	/// SMT-LIB2 printing and parsing helpers, shared with SMTLib2ProcessInterface.
+	//@{
+	/// Writes the SMT-LIB2 representation of @a _expr to @a _out.
+	static void toSExpr(Expression const& _expr, std::ostream& _out);
+	static std::string toSExpr(Expression const& _expr);
+	static std::string toSmtLibSort(Sort const& _sort);
+	static std::string toSmtLibSort(std::vector<SortPointer> const& _sort);
+	/// @returns the command declaring the variable or function @a _name.
+	static std::string declaration(std::string const& _name, Sort const& _sort);
+	/// Writes the commands that check satisfiability and request the values
+	/// of @a _expressionsToEvaluate to @a _out.
+	static void checkSatAndGetValuesCommand(std::vector<Expression> const& _expressionsToEvaluate, std::ostream& _out);
+	/// @returns the result and the requested values contained in the
+	/// response of a solver to `checkSatAndGetValuesCommand`.
+	static std::pair<CheckResult, std::vector<std::string>> parseResponse(std::string const& _response);
+	//@}
 
 private:
-	void declareFunction(std::string const&, Sort const&);
-
-	std::string toSExpr(Expression const& _expr);
-	std::string toSmtLibSort(Sort const& _sort);
-	std::string toSmtLibSort(std::vector<SortPointer> const& _sort);
-
 	void write(std::string _data);
 
 	std::string checkSatAndGetValuesCommand(std::vector<Expression> const& _expressionsToEvaluate);
-	std::vector<std::string> parseValues(std::string::const_iterator _start, std::string::const_iterator _end);
+	static std::vector<std::string> parseValues(std::string::const_iterator _start, std::string::const_iterator _end);
 
 	/// Communicates with the solver via the callback. Throws SMTSolverError on error.
 	std::string querySolver(std::string const& _input);
@@ -73,8 +97,12 @@ private:
 	std::vector<std::string> m_accumulatedOutput;
 	std::set<std::string> m_variables;
 
+	size_t m_lastQuerySize = 0;
+
 	std::map<h256, std::string> const& m_queryResponses;
 	std::vector<std::string> m_unhandledQueries;
+	/// Whether the script of the last check was added to m_unhandledQueries.
+	bool m_lastQueryUnhandled = false;
 };
 
 }
@@ -0,0 +1,133 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/SMTLib2ProcessInterface.h>
+
+#include <libsolidity/formal/SMTLib2Interface.h>
+
+#include <liblangutil/Exceptions.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+using namespace dev::solidity::smt;
+
+namespace
+{
+/// Echoed by the solver after the answers to a check.
+string const c_endOfAnswer = "solc-end-of-answer";
+}
+
+SMTLib2ProcessInterface::SMTLib2ProcessInterface(shared_ptr<SolverProcessPool> _pool, unsigned _queryTimeout):
+	m_pool(move(_pool)),
+	m_queryTimeout(_queryTimeout)
+{
+	solAssert(m_pool, "");
+	reset();
+}
+
+SMTLib2ProcessInterface::~SMTLib2ProcessInterface()
+{
+	m_pool->release(move(m_process));
+}
+
+void SMTLib2ProcessInterface::reset()
+{
+	m_scopes.clear();
+	m_scopes.emplace_back();
+	m_variables.clear();
+	if (m_process)
+		writePreamble();
+}
+
+void SMTLib2ProcessInterface::push()
+{
+	// A new process receives the current scopes before the new one is opened.
+	process().input() << "(push 1)\n";
+	m_scopes.emplace_back();
+}
+
+void SMTLib2ProcessInterface::pop()
+{
+	solAssert(m_scopes.size() > 1, "");
+	// A new process has to receive the scope before it is removed.
+	SolverProcess& solver = process();
+	for (string const& name: m_scopes.back().names)
+		m_variables.erase(name);
+	m_scopes.pop_back();
+	solver.input() << "(pop 1)\n";
+}
+
+void SMTLib2ProcessInterface::declareVariable(string const& _name, Sort const& _sort)
+{
+	if (m_variables.insert(_name).second)
+	{
+		m_scopes.back().names.push_back(_name);
+		write(SMTLib2Interface::declaration(_name, _sort) + "\n");
+	}
+}
+
+void SMTLib2ProcessInterface::addAssertion(Expression const& _expr)
+{
+	write("(assert " + SMTLib2Interface::toSExpr(_expr) + ")\n");
+}
+
+pair<CheckResult, vector<string>> SMTLib2ProcessInterface::check(vector<Expression> const& _expressionsToEvaluate)
+{
+	// The auxiliary declarations of the values to evaluate are removed again
+	// by the enclosing scope.
+	ostream& input = process().input();
+	input << "(push 1)\n";
+	SMTLib2Interface::checkSatAndGetValuesCommand(_expressionsToEvaluate, input);
+	input << "(pop 1)\n";
+	input << "(echo \"" << c_endOfAnswer << "\")\n";
+	auto answer = process().readUntil(c_endOfAnswer, m_queryTimeout);
+	if (!answer)
+	{
+		// The solver is still busy with the query, the pool terminates it.
+		m_pool->release(move(m_process));
+		return make_pair(CheckResult::UNKNOWN, vector<string>{});
+	}
+	return SMTLib2Interface::parseResponse(*answer);
+}
+
+SolverProcess& SMTLib2ProcessInterface::process()
+{
+	if (!m_process)
+	{
+		m_process = m_pool->acquire();
+		writePreamble();
+		for (size_t i = 0; i < m_scopes.size(); ++i)
+			m_process->input() << (i > 0 ? "(push 1)\n" : "") << m_scopes[i].commands;
+	}
+	return *m_process;
+}
+
+void SMTLib2ProcessInterface::write(string const& _command)
+{
+	process().input() << _command;
+	m_scopes.back().commands += _command;
+}
+
+void SMTLib2ProcessInterface::writePreamble()
+{
+	solAssert(m_process, "");
+	m_process->input() <<
+		"(reset)\n"
+		"(set-option :produce-models true)\n"
+		"(set-logic QF_UFLIA)\n";
+}
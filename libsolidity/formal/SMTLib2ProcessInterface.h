@@ -0,0 +1,97 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libsolidity/formal/SolverInterface.h>
+#include <libsolidity/formal/SolverProcessPool.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+namespace smt
+{
+
+/**
+ * Solver interface that talks SMT-LIB2 to an external solver process taken from a pool.
+ * In contrast to SMTLib2Interface, which keeps the whole script in memory in order to
+ * send it at once, commands are streamed to the solver as soon as they are issued and
+ * only checks wait for an answer. The process is leased on first use and returned
+ * to the pool on destruction. If the solver does not answer a check in time, the
+ * result is unknown and the process is replaced by a new one, to which the
+ * current scopes are sent again.
+ */
+class SMTLib2ProcessInterface: public SolverInterface, public boost::noncopyable
+{
+public:
+	/// @param _queryTimeout time to wait for the answer to a check in milliseconds,
+	/// zero for no timeout.
+	explicit SMTLib2ProcessInterface(
+		std::shared_ptr<SolverProcessPool> _pool,
+		unsigned _queryTimeout = defaultQueryTimeout
+	);
+	~SMTLib2ProcessInterface() override;
+
+	void reset() override;
+
+	void push() override;
+	void pop() override;
+
+	void declareVariable(std::string const& _name, Sort const& _sort) override;
+
+	void addAssertion(Expression const& _expr) override;
+	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
+
+	std::string identity() const override { return "smtlib2-process:" + m_pool->command(); }
+
+private:
+	/// Commands and declared names of an assertion scope.
+	/// Declarations are local to their scope in SMT-LIB2.
+	struct Scope
+	{
+		std::string commands;
+		std::vector<std::string> names;
+	};
+
+	/// @returns the leased process, acquiring one and sending the current scopes
+	/// to it on first use.
+	SolverProcess& process();
+	/// Sends @a _command to the solver and records it in the current scope.
+	void write(std::string const& _command);
+	/// Sends the commands that reset the solver to the initial state.
+	void writePreamble();
+
+	std::shared_ptr<SolverProcessPool> m_pool;
+	std::unique_ptr<SolverProcess> m_process;
+	unsigned m_queryTimeout;
+
+	/// The assertion scopes, the innermost last.
+	std::vector<Scope> m_scopes;
+	std::set<std::string> m_variables;
+};
+
+}
+}
+}
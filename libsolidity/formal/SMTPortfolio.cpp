@@ -24,21 +24,31 @@
 #include <libsolidity/formal/CVC4Interface.h>
 #endif
 #include <libsolidity/formal/SMTLib2Interface.h>
+#include <libsolidity/formal/SMTLib2ProcessInterface.h>
 
 using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 using namespace dev::solidity::smt;
 
-SMTPortfolio::SMTPortfolio(map<h256, string> const& _smtlib2Responses)
+SMTPortfolio::SMTPortfolio(
+	map<h256, string> const& _smtlib2Responses,
+	shared_ptr<SolverProcessPool> _processPool,
+	unsigned _queryTimeout
+)
 {
 	m_solvers.emplace_back(make_unique<smt::SMTLib2Interface>(_smtlib2Responses));
 #ifdef HAVE_Z3
-	m_solvers.emplace_back(make_unique<smt::Z3Interface>());
+	m_solvers.emplace_back(make_unique<smt::Z3Interface>(_queryTimeout));
 #endif
 #ifdef HAVE_CVC4
-	m_solvers.emplace_back(make_unique<smt::CVC4Interface>());
+	m_solvers.emplace_back(make_unique<smt::CVC4Interface>(_queryTimeout));
 #endif
+	if (_processPool)
+	{
+		m_solvers.emplace_back(make_unique<smt::SMTLib2ProcessInterface>(move(_processPool), _queryTimeout));
+		m_processSolver = m_solvers.back().get();
+	}
 }
 
 void SMTPortfolio::reset()
@@ -105,21 +115,31 @@ pair<CheckResult, vector<string>> SMTPortfolio::check(vector<Expression> const&
 {
 	CheckResult lastResult = CheckResult::ERROR;
 	vector<string> finalValues;
+	m_lastAnswerer.clear();
 	for (auto const& s: m_solvers)
 	{
 		CheckResult result;
 		vector<string> values;
 		tie(result, values) = s->check(_expressionsToEvaluate);
+		if (s.get() == m_processSolver && solverAnswered(result))
+		{
+			// The query does not have to be answered via the auxiliary input.
+			auto smtlib2 = dynamic_cast<smt::SMTLib2Interface*>(m_solvers.front().get());
+			solAssert(smtlib2, "");
+			smtlib2->dropLastUnhandledQuery();
+		}
 		if (solverAnswered(result))
 		{
 			if (!solverAnswered(lastResult))
 			{
 				lastResult = result;
 				finalValues = std::move(values);
+				m_lastAnswerer = s->identity();
 			}
 			else if (lastResult != result)
 			{
 				lastResult = CheckResult::CONFLICTING;
+				m_lastAnswerer.clear();
 				break;
 			}
 		}
@@ -138,6 +158,32 @@ vector<string> SMTPortfolio::unhandledQueries()
 	return m_solvers.front()->unhandledQueries();
 }
 
+string SMTPortfolio::identity() const
+{
+	string identity;
+	for (auto const& s: m_solvers)
+		identity += (identity.empty() ? "" : ",") + s->identity();
+	return identity;
+}
+
+string SMTPortfolio::query(vector<Expression> const& _expressionsToEvaluate)
+{
+	// This code assumes that the constructor guarantees that
+	// SmtLib2Interface is in position 0.
+	solAssert(!m_solvers.empty(), "");
+	auto smtlib2 = dynamic_cast<smt::SMTLib2Interface*>(m_solvers.front().get());
+	solAssert(smtlib2, "");
+	return smtlib2->query(_expressionsToEvaluate);
+}
+
+size_t SMTPortfolio::lastQuerySize() const
+{
+	solAssert(!m_solvers.empty(), "");
+	auto smtlib2 = dynamic_cast<smt::SMTLib2Interface const*>(m_solvers.front().get());
+	solAssert(smtlib2, "");
+	return smtlib2->lastQuerySize();
+}
+
 bool SMTPortfolio::solverAnswered(CheckResult result)
 {
 	return result == CheckResult::SATISFIABLE || result == CheckResult::UNSATISFIABLE;
@@ -19,11 +19,13 @@
 
 
 #include <libsolidity/formal/SolverInterface.h>
+#include <libsolidity/formal/SolverProcessPool.h>
 #include <libsolidity/interface/ReadFile.h>
 #include <libdevcore/FixedHash.h>
 
 #include <boost/noncopyable.hpp>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace dev
@@ -42,7 +44,14 @@ namespace smt
 class SMTPortfolio: public SolverInterface, public boost::noncopyable
 {
 public:
-	SMTPortfolio(std::map<h256, std::string> const& _smtlib2Responses);
+	/// @param _processPool if non-null, solver processes of this pool are queried as well.
+	/// @param _queryTimeout timeout of a single query of all solvers in milliseconds,
+	/// zero for no timeout.
+	SMTPortfolio(
+		std::map<h256, std::string> const& _smtlib2Responses,
+		std::shared_ptr<SolverProcessPool> _processPool = nullptr,
+		unsigned _queryTimeout = defaultQueryTimeout
+	);
 
 	void reset() override;
 
@@ -57,12 +66,28 @@ public:
 
 	std::vector<std::string> unhandledQueries() override;
 	unsigned solvers() override { return m_solvers.size(); }
+
+	std::string identity() const override;
+
+	/// @returns the SMT-LIB2 representation of the current query.
+	std::string query(std::vector<Expression> const& _expressionsToEvaluate);
+
+	/// @returns the identity of the solver whose answer was returned by the last check,
+	/// or an empty string if no solver answered.
+	std::string const& lastAnswerer() const { return m_lastAnswerer; }
+	/// @returns the size in bytes of the SMT-LIB2 script of the last check.
+	size_t lastQuerySize() const;
+
 private:
 	static bool solverAnswered(CheckResult result);
 
 	std::vector<std::unique_ptr<smt::SolverInterface>> m_solvers;
+	/// The interface to the solver processes, if any. Also part of m_solvers.
+	smt::SolverInterface const* m_processSolver = nullptr;
 
 	std::vector<Expression> m_assertions;
+
+	std::string m_lastAnswerer;
 };
 
 }
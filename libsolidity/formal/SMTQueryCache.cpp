@@ -0,0 +1,136 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/SMTQueryCache.h>
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/JSON.h>
+#include <libdevcore/Keccak256.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+namespace fs = boost::filesystem;
+
+SMTQueryCache::SMTQueryCache(string _directory):
+	m_directory(move(_directory))
+{
+	boost::system::error_code error;
+	fs::create_directories(m_directory, error);
+}
+
+h256 SMTQueryCache::key(string const& _query, string const& _solverIdentity)
+{
+	return keccak256(_solverIdentity + "\n" + normalise(_query));
+}
+
+boost::optional<SMTQueryCache::Result> SMTQueryCache::lookup(h256 const& _key) const
+{
+	Json::Value entry;
+	string content = readFileAsString((fs::path(m_directory) / _key.hex()).string());
+	if (content.empty() || !jsonParseStrict(content, entry) || !entry.isObject())
+	{
+		++m_misses;
+		return {};
+	}
+
+	Result result;
+	if (entry["result"] == "sat")
+		result.first = CheckResult::SATISFIABLE;
+	else if (entry["result"] == "unsat")
+		result.first = CheckResult::UNSATISFIABLE;
+	else
+	{
+		++m_misses;
+		return {};
+	}
+	for (auto const& value: entry["values"])
+		result.second.push_back(value.asString());
+
+	++m_hits;
+	return result;
+}
+
+void SMTQueryCache::store(h256 const& _key, Result const& _result) const
+{
+	Json::Value entry(Json::objectValue);
+	if (_result.first == CheckResult::SATISFIABLE)
+		entry["result"] = "sat";
+	else if (_result.first == CheckResult::UNSATISFIABLE)
+		entry["result"] = "unsat";
+	else
+		return;
+	entry["values"] = Json::arrayValue;
+	for (auto const& value: _result.second)
+		entry["values"].append(value);
+
+	// Write to a temporary file first and rename it afterwards, so that concurrent
+	// compiler runs never observe partially written entries.
+	fs::path target = fs::path(m_directory) / _key.hex();
+	fs::path temporary = fs::path(m_directory) / fs::unique_path(_key.hex() + ".%%%%-%%%%.tmp");
+	{
+		ofstream file(temporary.string(), ios::out | ios::trunc);
+		if (!file)
+			return;
+		file << jsonCompactPrint(entry);
+	}
+	boost::system::error_code error;
+	fs::rename(temporary, target, error);
+	if (error)
+		fs::remove(temporary, error);
+}
+
+string SMTQueryCache::normalise(string const& _query)
+{
+	string normalised;
+	normalised.reserve(_query.size());
+	bool pendingSpace = false;
+	bool inComment = false;
+	bool inQuotedSymbol = false;
+	for (char c: _query)
+	{
+		if (inComment)
+		{
+			if (c == '\n')
+				inComment = false;
+			continue;
+		}
+		if (!inQuotedSymbol && c == ';')
+		{
+			inComment = true;
+			pendingSpace = true;
+			continue;
+		}
+		if (!inQuotedSymbol && isspace(static_cast<unsigned char>(c)))
+		{
+			pendingSpace = true;
+			continue;
+		}
+		if (c == '|')
+			inQuotedSymbol = !inQuotedSymbol;
+		if (pendingSpace && !normalised.empty() && normalised.back() != '(' && c != ')')
+			normalised += ' ';
+		pendingSpace = false;
+		normalised += c;
+	}
+	return normalised;
+}
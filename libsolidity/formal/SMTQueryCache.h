@@ -0,0 +1,79 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#include <libdevcore/FixedHash.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+namespace smt
+{
+
+/**
+ * Persistent on-disk cache of SMT query results.
+ * Every entry is stored in its own file inside the cache directory, named after
+ * the keccak256 hash of the normalised SMT-LIB2 query and the identity of the
+ * solver(s) that answered it. Only definitive answers (SAT and UNSAT) are stored,
+ * since timeouts and errors depend on the environment.
+ * The cache can be used from multiple threads concurrently.
+ */
+class SMTQueryCache: public boost::noncopyable
+{
+public:
+	using Result = std::pair<CheckResult, std::vector<std::string>>;
+
+	explicit SMTQueryCache(std::string _directory);
+
+	/// @returns the cache key of the SMT-LIB2 query @a _query answered by @a _solverIdentity.
+	static h256 key(std::string const& _query, std::string const& _solverIdentity);
+
+	/// @returns the cached result for @a _key, if present.
+	boost::optional<Result> lookup(h256 const& _key) const;
+	/// Stores @a _result under @a _key. Results that are not SAT or UNSAT are ignored.
+	void store(h256 const& _key, Result const& _result) const;
+
+	/// @returns the number of lookups that were answered from the cache.
+	size_t hits() const { return m_hits; }
+	/// @returns the number of lookups that were not answered from the cache.
+	size_t misses() const { return m_misses; }
+
+private:
+	/// @returns @a _query with comments removed and whitespace collapsed
+	/// to single spaces.
+	static std::string normalise(std::string const& _query);
+
+	std::string m_directory;
+	std::atomic<size_t> mutable m_hits{0};
+	std::atomic<size_t> mutable m_misses{0};
+};
+
+}
+}
+}
@@ -0,0 +1,105 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+shared_ptr<Expression::Node const> Expression::intern(string _name, vector<Expression> _arguments, SortPointer _sort)
+{
+	solAssert(_sort, "");
+
+	// Nodes are owned by the expressions referring to them. The table only
+	// keeps weak references and a node removes itself from it when it is deleted.
+	// Expressions are created concurrently by the model checker. Equal nodes have
+	// equal hashes, so the table is split by hash into shards with their own mutex,
+	// which threads only contend for if they intern nodes of the same shard.
+	struct Shard
+	{
+		mutex lock;
+		unordered_multimap<size_t, pair<Node const*, weak_ptr<Node const>>> nodes;
+	};
+	// Intentionally leaked, since expressions might outlive static destruction.
+	static array<Shard, 64>& table = *new array<Shard, 64>();
+
+	size_t hash = std::hash<string>{}(_name);
+	boost::hash_combine(hash, static_cast<int>(_sort->kind));
+	for (auto const& argument: _arguments)
+		boost::hash_combine(hash, argument.m_node->hash);
+	Shard& shard = table[hash % table.size()];
+
+	// Releasing the last reference to a node locks its shard, so candidates
+	// have to be released only after the lock.
+	vector<shared_ptr<Node const>> candidates;
+	lock_guard<mutex> guard(shard.lock);
+
+	auto range = shard.nodes.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+		if (auto candidate = it->second.second.lock())
+		{
+			candidates.push_back(candidate);
+			if (
+				candidate->name == _name &&
+				*candidate->sort == *_sort &&
+				candidate->arguments.size() == _arguments.size() &&
+				equal(
+					_arguments.begin(),
+					_arguments.end(),
+					candidate->arguments.begin(),
+					[](Expression const& _a, Expression const& _b) { return _a.identical(_b); }
+				)
+			)
+				return candidate;
+		}
+
+	shared_ptr<Node const> node(
+		new Node{move(_name), move(_arguments), move(_sort), hash},
+		[](Node const* _node)
+		{
+			{
+				Shard& nodeShard = table[_node->hash % table.size()];
+				lock_guard<mutex> guard(nodeShard.lock);
+				auto range = nodeShard.nodes.equal_range(_node->hash);
+				for (auto it = range.first; it != range.second; ++it)
+					if (it->second.first == _node)
+					{
+						nodeShard.nodes.erase(it);
+						break;
+					}
+			}
+			delete _node;
+		}
+	);
+	shard.nodes.emplace(hash, make_pair(node.get(), weak_ptr<Node const>(node)));
+	return node;
+}
+
+SortPointer const& Expression::simpleSort(Kind _kind)
+{
+	static SortPointer const intSort = make_shared<Sort>(Kind::Int);
+	static SortPointer const boolSort = make_shared<Sort>(Kind::Bool);
+	solAssert(_kind == Kind::Int || _kind == Kind::Bool, "");
+	return _kind == Kind::Int ? intSort : boolSort;
+}
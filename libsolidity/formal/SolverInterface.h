@@ -25,6 +25,7 @@
 #include <boost/noncopyable.hpp>
 #include <cstdio>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -111,9 +112,12 @@ struct ArraySort: public Sort
 };
 
 /// C++ representation of an SMTLIB2 expression.
+/// Expressions are immutable handles to hash-consed nodes: structurally equal
+/// expressions share the same node, so copying and comparing them is cheap.
 class Expression
 {
 	friend class SolverInterface;
+	friend class EncodingContext;
 public:
 	explicit Expression(bool _v): Expression(_v ? "true" : "false", Kind::Bool) {}
 	Expression(size_t _number): Expression(std::to_string(_number), Kind::Int) {}
@@ -147,13 +151,13 @@ public:
 			{"select", 2},
 			{"store", 3}
 		};
-		return operatorsArity.count(name) && operatorsArity.at(name) == arguments.size();
+		return operatorsArity.count(name()) && operatorsArity.at(name()) == arguments().size();
 	}
 
 	static Expression ite(Expression _condition, Expression _trueValue, Expression _falseValue)
 	{
-		solAssert(*_trueValue.sort == *_falseValue.sort, "");
-		SortPointer sort = _trueValue.sort;
+		solAssert(*_trueValue.sort() == *_falseValue.sort(), "");
+		SortPointer sort = _trueValue.sort();
 		return Expression("ite", std::vector<Expression>{
 			std::move(_condition), std::move(_trueValue), std::move(_falseValue)
 		}, std::move(sort));
@@ -172,11 +176,11 @@ public:
 	/// select is the SMT representation of an array index access.
 	static Expression select(Expression _array, Expression _index)
 	{
-		solAssert(_array.sort->kind == Kind::Array, "");
-		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort);
+		solAssert(_array.sort()->kind == Kind::Array, "");
+		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort());
 		solAssert(arraySort, "");
-		solAssert(_index.sort, "");
-		solAssert(*arraySort->domain == *_index.sort, "");
+		solAssert(_index.sort(), "");
+		solAssert(*arraySort->domain == *_index.sort(), "");
 		return Expression(
 			"select",
 			std::vector<Expression>{std::move(_array), std::move(_index)},
@@ -188,13 +192,13 @@ public:
 	/// The function is pure and returns the modified array.
 	static Expression store(Expression _array, Expression _index, Expression _element)
 	{
-		solAssert(_array.sort->kind == Kind::Array, "");
-		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort);
+		solAssert(_array.sort()->kind == Kind::Array, "");
+		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort());
 		solAssert(arraySort, "");
-		solAssert(_index.sort, "");
-		solAssert(_element.sort, "");
-		solAssert(*arraySort->domain == *_index.sort, "");
-		solAssert(*arraySort->range == *_element.sort, "");
+		solAssert(_index.sort(), "");
+		solAssert(_element.sort(), "");
+		solAssert(*arraySort->domain == *_index.sort(), "");
+		solAssert(*arraySort->range == *_element.sort(), "");
 		return Expression(
 			"store",
 			std::vector<Expression>{std::move(_array), std::move(_index), std::move(_element)},
@@ -261,24 +265,54 @@ public:
 	Expression operator()(std::vector<Expression> _arguments) const
 	{
 		solAssert(
-			sort->kind == Kind::Function,
+			sort()->kind == Kind::Function,
 			"Attempted function application to non-function."
 		);
-		auto fSort = dynamic_cast<FunctionSort const*>(sort.get());
+		auto fSort = dynamic_cast<FunctionSort const*>(sort().get());
 		solAssert(fSort, "");
-		return Expression(name, std::move(_arguments), fSort->codomain);
+		return Expression(name(), std::move(_arguments), fSort->codomain);
 	}
 
-	std::string name;
-	std::vector<Expression> arguments;
-	SortPointer sort;
+	std::string const& name() const { return m_node->name; }
+	std::vector<Expression> const& arguments() const { return m_node->arguments; }
+	SortPointer const& sort() const { return m_node->sort; }
+
+	/// @returns true if the two expressions are structurally equal.
+	/// This only compares the nodes and thus takes constant time.
+	bool identical(Expression const& _other) const { return m_node == _other.m_node; }
+
+	/// Function objects to use expressions as keys of unordered containers.
+	struct Hash
+	{
+		size_t operator()(Expression const& _expression) const { return _expression.m_node->hash; }
+	};
+	struct Identical
+	{
+		bool operator()(Expression const& _a, Expression const& _b) const { return _a.identical(_b); }
+	};
 
 private:
+	struct Node
+	{
+		std::string name;
+		std::vector<Expression> arguments;
+		SortPointer sort;
+		/// Structural hash of the name, the arguments and the kind of the sort.
+		size_t hash;
+	};
+
+	/// @returns the unique node with the given name, arguments and sort,
+	/// creating it if it does not exist yet.
+	static std::shared_ptr<Node const> intern(std::string _name, std::vector<Expression> _arguments, SortPointer _sort);
+
+	/// @returns the shared sort of kind Int or Bool.
+	static SortPointer const& simpleSort(Kind _kind);
+
 	/// Manual constructors, should only be used by SolverInterface and this class itself.
 	Expression(std::string _name, std::vector<Expression> _arguments, SortPointer _sort):
-		name(std::move(_name)), arguments(std::move(_arguments)), sort(std::move(_sort)) {}
+		m_node(intern(std::move(_name), std::move(_arguments), std::move(_sort))) {}
 	Expression(std::string _name, std::vector<Expression> _arguments, Kind _kind):
-		Expression(std::move(_name), std::move(_arguments), std::make_shared<Sort>(_kind)) {}
+		Expression(std::move(_name), std::move(_arguments), simpleSort(_kind)) {}
 
 	explicit Expression(std::string _name, Kind _kind):
 		Expression(std::move(_name), std::vector<Expression>{}, _kind) {}
@@ -286,6 +320,8 @@ private:
 		Expression(std::move(_name), std::vector<Expression>{std::move(_arg)}, _kind) {}
 	Expression(std::string _name, Expression _arg1, Expression _arg2, Kind _kind):
 		Expression(std::move(_name), std::vector<Expression>{std::move(_arg1), std::move(_arg2)}, _kind) {}
+
+	std::shared_ptr<Node const> m_node;
 };
 
 DEV_SIMPLE_EXCEPTION(SolverError);
@@ -321,9 +357,12 @@ public:
 	/// @returns how many SMT solvers this interface has.
 	virtual unsigned solvers() { return 1; }
 
-protected:
-	// SMT query timeout in milliseconds.
-	static int const queryTimeout = 10000;
+	/// @returns a string identifying the solver and its version.
+	/// Used to distinguish cached query results of different solvers.
+	virtual std::string identity() const = 0;
+
+	/// Default timeout of a single query in milliseconds.
+	static unsigned const defaultQueryTimeout = 10000;
 };
 
 }
@@ -0,0 +1,345 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/SolverProcessPool.h>
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define SOLC_SOLVER_PROCESSES 1
+#endif
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+namespace
+{
+/// Size of the buffer of commands that are not yet sent to the solver.
+size_t const c_outputBufferSize = 64 * 1024;
+}
+
+SolverProcess::OutputBuffer::OutputBuffer(SolverProcess& _process):
+	m_process(_process),
+	m_buffer(c_outputBufferSize)
+{
+	setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+SolverProcess::OutputBuffer::int_type SolverProcess::OutputBuffer::overflow(int_type _c)
+{
+	sync();
+	if (!traits_type::eq_int_type(_c, traits_type::eof()))
+	{
+		*pptr() = traits_type::to_char_type(_c);
+		pbump(1);
+	}
+	return traits_type::not_eof(_c);
+}
+
+int SolverProcess::OutputBuffer::sync()
+{
+	if (pptr() != pbase())
+	{
+		// Reset the buffer before sending, so that it stays consistent if sending throws.
+		size_t size = static_cast<size_t>(pptr() - pbase());
+		setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+		m_process.send(m_buffer.data(), size);
+	}
+	return 0;
+}
+
+SolverProcess::SolverProcess(string const& _command):
+	m_outputBuffer(*this),
+	m_input(&m_outputBuffer)
+{
+	vector<string> arguments;
+	string command = boost::trim_copy(_command);
+	boost::split(arguments, command, boost::is_space(), boost::token_compress_on);
+	if (command.empty())
+	{
+		markFailed("Empty solver command.");
+		return;
+	}
+
+#ifdef SOLC_SOLVER_PROCESSES
+	// Everything the child needs is prepared before forking, since only
+	// async-signal-safe functions may be called in the child of a multi-threaded process.
+	vector<char*> argv;
+	for (string& argument: arguments)
+		argv.push_back(&argument[0]);
+	argv.push_back(nullptr);
+
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+	{
+		markFailed(string("Could not create socket: ") + strerror(errno));
+		return;
+	}
+	// Do not leak the socket to solver processes started later.
+	fcntl(sockets[0], F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+	int one = 1;
+	setsockopt(sockets[0], SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(sockets[0]);
+		close(sockets[1]);
+		markFailed(string("Could not start solver process: ") + strerror(errno));
+		return;
+	}
+	if (pid == 0)
+	{
+		int devNull = open("/dev/null", O_WRONLY);
+		if (
+			dup2(sockets[1], STDIN_FILENO) < 0 ||
+			dup2(sockets[1], STDOUT_FILENO) < 0 ||
+			(devNull >= 0 && dup2(devNull, STDERR_FILENO) < 0)
+		)
+			_exit(127);
+		close(sockets[0]);
+		close(sockets[1]);
+		execvp(argv[0], argv.data());
+		// The parent notices the failure when reading from the socket.
+		_exit(127);
+	}
+	close(sockets[1]);
+	m_socket = sockets[0];
+	m_pid = pid;
+	fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL) | O_NONBLOCK);
+#else
+	markFailed("Solver processes are not supported on this platform.");
+#endif
+}
+
+SolverProcess::~SolverProcess()
+{
+#ifdef SOLC_SOLVER_PROCESSES
+	if (m_socket >= 0)
+		close(m_socket);
+	if (m_pid > 0)
+	{
+		// The solver might be busy with a query whose answer is not needed anymore.
+		kill(m_pid, SIGKILL);
+		waitpid(m_pid, nullptr, 0);
+	}
+#endif
+}
+
+void SolverProcess::flush()
+{
+	if (m_failed)
+		fail(m_failureReason);
+	m_input.flush();
+	if (!m_input)
+		fail("Could not send commands to solver.");
+}
+
+boost::optional<string> SolverProcess::readUntil(string const& _marker, unsigned _timeout)
+{
+	if (m_failed)
+		fail(m_failureReason);
+	flush();
+	auto deadline = chrono::steady_clock::now() + chrono::milliseconds(_timeout);
+	// Solvers differ in whether they print the quotes of echoed strings.
+	string const quotedMarker = "\"" + _marker + "\"";
+	size_t lineStart = 0;
+	while (true)
+	{
+		size_t lineEnd;
+		while ((lineEnd = m_pendingOutput.find('\n', lineStart)) != string::npos)
+		{
+			string line = boost::trim_copy(m_pendingOutput.substr(lineStart, lineEnd - lineStart));
+			if (line == _marker || line == quotedMarker)
+			{
+				string output = m_pendingOutput.substr(0, lineStart);
+				m_pendingOutput.erase(0, lineEnd + 1);
+				return output;
+			}
+			lineStart = lineEnd + 1;
+		}
+
+#ifdef SOLC_SOLVER_PROCESSES
+		int timeout = -1;
+		if (_timeout > 0)
+			timeout = max<int>(0, int(chrono::duration_cast<chrono::milliseconds>(
+				deadline - chrono::steady_clock::now()
+			).count()));
+		if (!wait(POLLIN, timeout))
+		{
+			markFailed("Solver did not answer within " + to_string(_timeout) + " ms.");
+			return boost::none;
+		}
+		receive();
+#else
+		fail("Solver processes are not supported on this platform.");
+#endif
+	}
+}
+
+void SolverProcess::send(char const* _data, size_t _size)
+{
+	if (m_failed)
+		fail(m_failureReason);
+#ifdef SOLC_SOLVER_PROCESSES
+	int flags = 0;
+#ifdef MSG_NOSIGNAL
+	flags = MSG_NOSIGNAL;
+#endif
+	while (_size > 0)
+	{
+		// The solver stops reading once its answers to earlier commands fill up the
+		// socket, so these have to be read before sending can continue.
+		short events = wait(POLLIN | POLLOUT);
+		if (events & POLLIN)
+			receive();
+		if (!(events & POLLOUT))
+			continue;
+		ssize_t sent = ::send(m_socket, _data, _size, flags);
+		if (sent < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+			continue;
+		if (sent < 0)
+			fail(string("Could not write to solver: ") + strerror(errno));
+		_data += sent;
+		_size -= static_cast<size_t>(sent);
+	}
+#else
+	(void)_data;
+	(void)_size;
+#endif
+}
+
+short SolverProcess::wait(short _events, int _timeout)
+{
+#ifdef SOLC_SOLVER_PROCESSES
+	while (true)
+	{
+		pollfd socket{m_socket, _events, 0};
+		int ready = poll(&socket, 1, _timeout);
+		if (ready < 0 && errno == EINTR)
+			continue;
+		if (ready < 0)
+			fail(string("Could not wait for solver: ") + strerror(errno));
+		if (ready == 0)
+			return 0;
+		if (socket.revents & POLLNVAL)
+			fail("Could not wait for solver: invalid socket.");
+		if (socket.revents & (POLLERR | POLLHUP))
+			// Remaining output is still read, the next read or write reports the error.
+			return _events;
+		if (socket.revents & _events)
+			return socket.revents & _events;
+	}
+#else
+	(void)_events;
+	(void)_timeout;
+	fail("Solver processes are not supported on this platform.");
+#endif
+}
+
+void SolverProcess::receive()
+{
+#ifdef SOLC_SOLVER_PROCESSES
+	char buffer[4096];
+	while (true)
+	{
+		ssize_t received = recv(m_socket, buffer, sizeof(buffer), 0);
+		if (received < 0 && errno == EINTR)
+			continue;
+		if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return;
+		if (received < 0)
+			fail(string("Could not read from solver: ") + strerror(errno));
+		if (received == 0)
+			fail("Solver process terminated unexpectedly.");
+		m_pendingOutput.append(buffer, static_cast<size_t>(received));
+	}
+#else
+	fail("Solver processes are not supported on this platform.");
+#endif
+}
+
+void SolverProcess::markFailed(string const& _reason)
+{
+	if (!m_failed)
+	{
+		m_failed = true;
+		m_failureReason = _reason;
+	}
+}
+
+void SolverProcess::fail(string const& _reason)
+{
+	markFailed(_reason);
+	BOOST_THROW_EXCEPTION(SolverError() << errinfo_comment(m_failureReason));
+}
+
+SolverProcessPool::SolverProcessPool(string _command, size_t _maxProcesses):
+	m_command(move(_command)),
+	m_maxProcesses(max<size_t>(_maxProcesses, 1))
+{
+}
+
+unique_ptr<SolverProcess> SolverProcessPool::acquire()
+{
+	unique_lock<mutex> lock(m_mutex);
+	m_released.wait(lock, [&]() { return !m_idle.empty() || m_running < m_maxProcesses; });
+	if (!m_idle.empty())
+	{
+		unique_ptr<SolverProcess> process = move(m_idle.back());
+		m_idle.pop_back();
+		return process;
+	}
+	// Processes are started while holding the lock, so that no other
+	// process inherits the socket before it is marked close-on-exec.
+	unique_ptr<SolverProcess> process = make_unique<SolverProcess>(m_command);
+	++m_running;
+	return process;
+}
+
+void SolverProcessPool::release(unique_ptr<SolverProcess> _process)
+{
+	if (!_process)
+		return;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		if (_process->failed())
+			--m_running;
+		else
+			m_idle.push_back(move(_process));
+	}
+	m_released.notify_one();
+	// A failed process is terminated here, outside of the lock.
+}
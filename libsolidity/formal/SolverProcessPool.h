@@ -0,0 +1,141 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Long-lived SMT solver processes that read SMT-LIB2 commands
+ * from their standard input and answer on their standard output.
+ */
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+namespace smt
+{
+
+/**
+ * A solver process connected to this process via a socket.
+ * Commands written to `input()` are buffered and sent to the solver
+ * without waiting for its answers, which are only returned by `readUntil`.
+ * Answers are also read while sending, so that neither side blocks on a full socket.
+ * Errors while starting or talking to the solver mark the process as failed
+ * and are reported by the next call to `flush` or `readUntil` as SolverError.
+ */
+class SolverProcess: public boost::noncopyable
+{
+public:
+	/// Starts @a _command, which is split at whitespace into the program and its arguments.
+	/// Does not throw if the process cannot be started, but marks it as failed.
+	explicit SolverProcess(std::string const& _command);
+	~SolverProcess();
+
+	/// @returns the stream of commands sent to the solver.
+	std::ostream& input() { return m_input; }
+	/// Sends all buffered commands to the solver.
+	void flush();
+	/// Sends all buffered commands and reads the answers of the solver up to
+	/// the line printed by `(echo "<_marker>")`.
+	/// @param _timeout time to wait for the marker in milliseconds, zero for no limit.
+	/// @returns the answers without the marker line, or nothing if the marker did not
+	/// arrive in time. The process is marked as failed then, since its later output
+	/// would be taken for the answers to later commands.
+	boost::optional<std::string> readUntil(std::string const& _marker, unsigned _timeout = 0);
+
+	bool failed() const { return m_failed; }
+
+private:
+	/// Buffer that sends its content to the solver once it is full.
+	class OutputBuffer: public std::streambuf
+	{
+	public:
+		explicit OutputBuffer(SolverProcess& _process);
+
+	protected:
+		int_type overflow(int_type _c) override;
+		int sync() override;
+
+	private:
+		SolverProcess& m_process;
+		std::vector<char> m_buffer;
+	};
+
+	void send(char const* _data, size_t _size);
+	/// Waits until the socket is ready for any of @a _events, at most @a _timeout
+	/// milliseconds if it is not negative.
+	/// @returns the events that occurred, zero if the time ran out.
+	short wait(short _events, int _timeout = -1);
+	/// Appends the output of the solver that is available without blocking to m_pendingOutput.
+	void receive();
+	/// Marks the process as failed. Only the first reason is kept.
+	void markFailed(std::string const& _reason);
+	/// Marks the process as failed and throws SolverError with the first failure reason.
+	[[noreturn]] void fail(std::string const& _reason);
+
+	int m_socket = -1;
+	int m_pid = -1;
+	bool m_failed = false;
+	std::string m_failureReason;
+	/// Output of the solver that was read but not yet returned.
+	std::string m_pendingOutput;
+	OutputBuffer m_outputBuffer;
+	std::ostream m_input;
+};
+
+/**
+ * Pool of at most a given number of solver processes running the same command.
+ * Processes are started on demand and leased to one solver interface at a time,
+ * which resets the solver state after acquiring it.
+ */
+class SolverProcessPool: public boost::noncopyable
+{
+public:
+	SolverProcessPool(std::string _command, size_t _maxProcesses);
+
+	std::string const& command() const { return m_command; }
+
+	/// @returns an idle process, starting a new one if all are leased and the limit
+	/// is not reached yet. Blocks until a process is released otherwise.
+	std::unique_ptr<SolverProcess> acquire();
+	/// Returns @a _process to the pool. Failed processes are terminated.
+	void release(std::unique_ptr<SolverProcess> _process);
+
+private:
+	std::string const m_command;
+	size_t const m_maxProcesses;
+
+	std::mutex m_mutex;
+	std::condition_variable m_released;
+	std::vector<std::unique_ptr<SolverProcess>> m_idle;
+	/// Number of processes that are running, leased or idle.
+	size_t m_running = 0;
+};
+
+}
+}
+}
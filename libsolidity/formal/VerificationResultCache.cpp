@@ -0,0 +1,329 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/VerificationResultCache.h>
+
+#include <libsolidity/ast/ASTVisitor.h>
+#include <libsolidity/formal/BMC.h>
+#include <libsolidity/interface/Version.h>
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/JSON.h>
+#include <libdevcore/Keccak256.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <set>
+
+using namespace std;
+using namespace dev;
+using namespace langutil;
+using namespace dev::solidity;
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+
+string sourceText(ASTNode const& _node)
+{
+	SourceLocation const& location = _node.location();
+	if (!location.source || location.start < 0 || location.end < location.start)
+		return "";
+	return location.source->source().substr(location.start, location.end - location.start);
+}
+
+/**
+ * Collects the functions and modifiers inlined by a root function and
+ * serialises everything their encoding depends on.
+ */
+class EncodingInputsCollector: private ASTConstVisitor
+{
+public:
+	explicit EncodingInputsCollector(FunctionDefinition const& _root)
+	{
+		add(_root);
+		// Nodes added while visiting are visited in turn.
+		for (size_t i = 0; i < m_nodes.size(); ++i)
+		{
+			m_data += "node\n" + sourceText(*m_nodes[i]) + "\n";
+			m_nodes[i]->accept(*this);
+		}
+	}
+
+	vector<ASTNode const*> const& nodes() const { return m_nodes; }
+	string const& data() const { return m_data; }
+
+private:
+	bool visitNode(ASTNode const& _node) override
+	{
+		if (auto expression = dynamic_cast<Expression const*>(&_node))
+			if (TypePointer type = expression->annotation().type)
+				m_data += type->toString(false) + "\n";
+		return true;
+	}
+
+	bool visit(Identifier const& _identifier) override
+	{
+		addConstant(_identifier.annotation().referencedDeclaration);
+		return visitNode(_identifier);
+	}
+
+	bool visit(MemberAccess const& _memberAccess) override
+	{
+		addConstant(_memberAccess.annotation().referencedDeclaration);
+		return visitNode(_memberAccess);
+	}
+
+	bool visit(FunctionCall const& _funCall) override
+	{
+		if (auto callee = BMC::inlinedFunctionCallToDefinition(_funCall))
+			add(*callee);
+		return visitNode(_funCall);
+	}
+
+	bool visit(ModifierInvocation const& _modifier) override
+	{
+		if (auto modifier = dynamic_cast<ModifierDefinition const*>(_modifier.name()->annotation().referencedDeclaration))
+			add(*modifier);
+		return visitNode(_modifier);
+	}
+
+	void add(ASTNode const& _node)
+	{
+		if (m_visited.insert(&_node).second)
+			m_nodes.push_back(&_node);
+	}
+
+	/// The value of constants is part of their declaration, which might be
+	/// outside of the collected nodes.
+	void addConstant(Declaration const* _declaration)
+	{
+		auto variable = dynamic_cast<VariableDeclaration const*>(_declaration);
+		if (variable && variable->isConstant() && m_constants.insert(variable).second)
+			m_data += "constant\n" + sourceText(*variable) + "\n";
+	}
+
+	vector<ASTNode const*> m_nodes;
+	set<ASTNode const*> m_visited;
+	set<VariableDeclaration const*> m_constants;
+	string m_data;
+};
+
+/// @returns @a _location as [node, start, end] relative to the node of @a _nodes
+/// that contains it, null for an empty location or nothing if no node contains it.
+boost::optional<Json::Value> relativeLocation(SourceLocation const& _location, vector<ASTNode const*> const& _nodes)
+{
+	if (_location.isEmpty())
+		return Json::Value(Json::nullValue);
+	for (size_t i = 0; i < _nodes.size(); ++i)
+	{
+		SourceLocation const& node = _nodes[i]->location();
+		if (node.source.get() == _location.source.get() && node.start <= _location.start && _location.end <= node.end)
+		{
+			Json::Value relative(Json::arrayValue);
+			relative.append(Json::UInt64(i));
+			relative.append(_location.start - node.start);
+			relative.append(_location.end - node.start);
+			return relative;
+		}
+	}
+	return {};
+}
+
+/// @returns the location stored by relativeLocation or an empty value if
+/// @a _relative is not valid for @a _nodes.
+boost::optional<SourceLocation> absoluteLocation(Json::Value const& _relative, vector<ASTNode const*> const& _nodes)
+{
+	if (_relative.isNull())
+		return SourceLocation();
+	if (!_relative.isArray() || _relative.size() != 3 || !_relative[0].isUInt() || _relative[0].asUInt() >= _nodes.size())
+		return {};
+	SourceLocation const& node = _nodes[_relative[0].asUInt()]->location();
+	SourceLocation location{node.start + _relative[1].asInt(), node.start + _relative[2].asInt(), node.source};
+	if (location.start < node.start || location.end > node.end || location.start > location.end)
+		return {};
+	return location;
+}
+
+}
+
+VerificationResultCache::VerificationResultCache(string _directory):
+	m_directory(move(_directory))
+{
+	boost::system::error_code error;
+	fs::create_directories(m_directory, error);
+}
+
+VerificationResultCache::EncodingInputs VerificationResultCache::encodingInputs(
+	FunctionDefinition const& _function,
+	ContractDefinition const& _contract
+)
+{
+	EncodingInputsCollector collector(_function);
+
+	// The same state variables as in SMTEncoder::visit(ContractDefinition).
+	string data = collector.data();
+	for (auto const& contract: _contract.annotation().linearizedBaseContracts)
+		for (auto variable: contract->stateVariables())
+			if (*contract == _contract || variable->isVisibleInDerivedContracts())
+				data += "state\n" + sourceText(*variable) + "\n" + variable->type()->toString(false) + "\n";
+
+	return EncodingInputs{keccak256(data), collector.nodes()};
+}
+
+h256 VerificationResultCache::key(EncodingInputs const& _encoding, string const& _solverIdentity, unsigned _queryTimeout)
+{
+	return keccak256(
+		"function\n" +
+		VersionString + "\n" +
+		_solverIdentity + "\n" +
+		to_string(_queryTimeout) + "\n" +
+		_encoding.hash.hex()
+	);
+}
+
+boost::optional<vector<VerificationResultCache::Check>> VerificationResultCache::lookup(
+	h256 const& _key,
+	EncodingInputs const& _encoding
+) const
+{
+	Json::Value entry;
+	string content = readFileAsString((fs::path(m_directory) / _key.hex()).string());
+	if (
+		content.empty() ||
+		!jsonParseStrict(content, entry) ||
+		!entry.isObject() ||
+		!entry["checks"].isArray()
+	)
+	{
+		++m_misses;
+		return {};
+	}
+
+	auto invalid = [&]() -> boost::optional<vector<Check>> {
+		++m_misses;
+		return {};
+	};
+
+	vector<Check> checks;
+	for (auto const& storedCheck: entry["checks"])
+	{
+		Check check;
+		for (auto const& storedWarning: storedCheck["warnings"])
+		{
+			auto location = absoluteLocation(storedWarning["location"], _encoding.nodes);
+			if (!location)
+				return invalid();
+			auto warning = make_shared<Error>(Error::Type::Warning);
+			*warning <<
+				errinfo_sourceLocation(*location) <<
+				errinfo_comment(storedWarning["message"].asString());
+			if (storedWarning.isMember("secondary"))
+			{
+				SecondarySourceLocation secondary;
+				for (auto const& info: storedWarning["secondary"])
+				{
+					auto secondaryLocation = absoluteLocation(info["location"], _encoding.nodes);
+					if (!secondaryLocation)
+						return invalid();
+					secondary.append(info["message"].asString(), *secondaryLocation);
+				}
+				*warning << errinfo_secondarySourceLocation(secondary);
+			}
+			check.warnings.push_back(std::move(warning));
+		}
+		for (auto const& storedTarget: storedCheck["targets"])
+		{
+			auto location = absoluteLocation(storedTarget["location"], _encoding.nodes);
+			if (!location)
+				return invalid();
+			check.targets.push_back(Target{storedTarget["type"].asString(), *location, storedTarget["result"].asString()});
+		}
+		checks.push_back(move(check));
+	}
+
+	++m_hits;
+	return checks;
+}
+
+void VerificationResultCache::store(h256 const& _key, EncodingInputs const& _encoding, vector<Check> const& _checks) const
+{
+	Json::Value entry(Json::objectValue);
+	entry["checks"] = Json::arrayValue;
+	for (auto const& check: _checks)
+	{
+		Json::Value storedCheck(Json::objectValue);
+		storedCheck["warnings"] = Json::arrayValue;
+		for (auto const& warning: check.warnings)
+		{
+			if (warning->type() != Error::Type::Warning)
+				return;
+			Json::Value storedWarning(Json::objectValue);
+			storedWarning["message"] = warning->comment() ? *warning->comment() : "";
+			SourceLocation const* location = boost::get_error_info<errinfo_sourceLocation>(*warning);
+			auto relative = relativeLocation(location ? *location : SourceLocation(), _encoding.nodes);
+			if (!relative)
+				return;
+			storedWarning["location"] = *relative;
+			if (auto secondary = boost::get_error_info<errinfo_secondarySourceLocation>(*warning))
+			{
+				storedWarning["secondary"] = Json::arrayValue;
+				for (auto const& info: secondary->infos)
+				{
+					Json::Value storedInfo(Json::objectValue);
+					storedInfo["message"] = info.first;
+					auto relativeInfo = relativeLocation(info.second, _encoding.nodes);
+					if (!relativeInfo)
+						return;
+					storedInfo["location"] = *relativeInfo;
+					storedWarning["secondary"].append(move(storedInfo));
+				}
+			}
+			storedCheck["warnings"].append(move(storedWarning));
+		}
+		storedCheck["targets"] = Json::arrayValue;
+		for (auto const& target: check.targets)
+		{
+			Json::Value storedTarget(Json::objectValue);
+			storedTarget["type"] = target.type;
+			auto relative = relativeLocation(target.location, _encoding.nodes);
+			if (!relative)
+				return;
+			storedTarget["location"] = *relative;
+			storedTarget["result"] = target.result;
+			storedCheck["targets"].append(move(storedTarget));
+		}
+		entry["checks"].append(move(storedCheck));
+	}
+
+	// Write to a temporary file first and rename it afterwards, so that concurrent
+	// compiler runs never observe partially written entries.
+	fs::path target = fs::path(m_directory) / _key.hex();
+	fs::path temporary = fs::path(m_directory) / fs::unique_path(_key.hex() + ".%%%%-%%%%.tmp");
+	{
+		ofstream file(temporary.string(), ios::out | ios::trunc);
+		if (!file)
+			return;
+		file << jsonCompactPrint(entry);
+	}
+	boost::system::error_code error;
+	fs::rename(temporary, target, error);
+	if (error)
+		fs::remove(temporary, error);
+}
@@ -0,0 +1,103 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libsolidity/ast/AST.h>
+
+#include <liblangutil/Exceptions.h>
+
+#include <libdevcore/FixedHash.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Persistent on-disk cache of the verification outcomes of root functions.
+ * The outcome of a function only depends on the inputs of its encoding: the source
+ * of the function, of the modifiers and functions it inlines, the types of the
+ * expressions therein and the state variables of the contract. An entry is stored
+ * under a hash of these inputs, so that functions that did not change are not solved
+ * again, even if other parts of the source changed.
+ * Source locations are stored relative to the encoded nodes, since the function might
+ * have moved in the meantime.
+ * The cache can be used from multiple threads concurrently.
+ */
+class VerificationResultCache: public boost::noncopyable
+{
+public:
+	/// The AST nodes whose encoding is checked in a root function and the hash of
+	/// everything that encoding depends on.
+	struct EncodingInputs
+	{
+		h256 hash;
+		/// The root function first, followed by the inlined functions and modifiers.
+		std::vector<ASTNode const*> nodes;
+	};
+
+	/// A verification target and the result of its last query.
+	struct Target
+	{
+		std::string type;
+		langutil::SourceLocation location;
+		std::string result;
+	};
+
+	/// Outcome of one scheduled check: its warnings and targets in the order they occurred.
+	struct Check
+	{
+		langutil::ErrorList warnings;
+		std::vector<Target> targets;
+	};
+
+	explicit VerificationResultCache(std::string _directory);
+
+	/// @returns the inputs of the encoding of @a _function as root function in @a _contract.
+	static EncodingInputs encodingInputs(FunctionDefinition const& _function, ContractDefinition const& _contract);
+	/// @returns the cache key of an encoding that is checked by @a _solverIdentity
+	/// with a timeout of @a _queryTimeout milliseconds per query.
+	static h256 key(EncodingInputs const& _encoding, std::string const& _solverIdentity, unsigned _queryTimeout);
+
+	/// @returns the checks stored under @a _key, with locations relative to the
+	/// nodes of @a _encoding, if present.
+	boost::optional<std::vector<Check>> lookup(h256 const& _key, EncodingInputs const& _encoding) const;
+	/// Stores @a _checks under @a _key. Does nothing if a location is outside of the
+	/// nodes of @a _encoding or if an error is not a warning.
+	void store(h256 const& _key, EncodingInputs const& _encoding, std::vector<Check> const& _checks) const;
+
+	/// @returns the number of lookups that were answered from the cache.
+	size_t hits() const { return m_hits; }
+	/// @returns the number of lookups that were not answered from the cache.
+	size_t misses() const { return m_misses; }
+
+private:
+	std::string m_directory;
+	std::atomic<size_t> mutable m_hits{0};
+	std::atomic<size_t> mutable m_misses{0};
+};
+
+}
+}
@@ -24,19 +24,31 @@ using namespace std;
 using namespace dev;
 using namespace dev::solidity::smt;
 
-Z3Interface::Z3Interface():
+Z3Interface::Z3Interface(unsigned _queryTimeout):
 	m_solver(m_context)
 {
 	// This needs to be set globally.
 	z3::set_param("rewriter.pull_cheap_ite", true);
 	// This needs to be set in the context.
-	m_context.set("timeout", queryTimeout);
+	if (_queryTimeout > 0)
+		m_context.set("timeout", to_string(_queryTimeout).c_str());
+}
+
+string Z3Interface::identity() const
+{
+	unsigned major = 0;
+	unsigned minor = 0;
+	unsigned build = 0;
+	unsigned revision = 0;
+	Z3_get_version(&major, &minor, &build, &revision);
+	return "z3-" + to_string(major) + "." + to_string(minor) + "." + to_string(build) + "." + to_string(revision);
 }
 
 void Z3Interface::reset()
 {
 	m_constants.clear();
 	m_functions.clear();
+	m_translations.clear();
 	m_solver.reset();
 }
 
@@ -110,15 +122,25 @@ pair<CheckResult, vector<string>> Z3Interface::check(vector<Expression> const& _
 
 z3::expr Z3Interface::toZ3Expr(Expression const& _expr)
 {
-	if (_expr.arguments.empty() && m_constants.count(_expr.name))
-		return m_constants.at(_expr.name);
+	auto cached = m_translations.find(_expr);
+	if (cached != m_translations.end())
+		return cached->second;
+	z3::expr translated = translate(_expr);
+	m_translations.emplace(_expr, translated);
+	return translated;
+}
+
+z3::expr Z3Interface::translate(Expression const& _expr)
+{
+	if (_expr.arguments().empty() && m_constants.count(_expr.name()))
+		return m_constants.at(_expr.name());
 	z3::expr_vector arguments(m_context);
-	for (auto const& arg: _expr.arguments)
+	for (auto const& arg: _expr.arguments())
 		arguments.push_back(toZ3Expr(arg));
 
 	try
 	{
-		string const& n = _expr.name;
+		string const& n = _expr.name();
 		if (m_functions.count(n))
 			return m_functions.at(n)(arguments);
 		else if (m_constants.count(n))
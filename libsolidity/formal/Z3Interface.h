@@ -21,6 +21,8 @@
 #include <boost/noncopyable.hpp>
 #include <z3++.h>
 
+#include <unordered_map>
+
 namespace dev
 {
 namespace solidity
@@ -31,7 +33,8 @@ namespace smt
 class Z3Interface: public SolverInterface, public boost::noncopyable
 {
 public:
-	Z3Interface();
+	/// @param _queryTimeout timeout of a single query in milliseconds, zero for no timeout.
+	explicit Z3Interface(unsigned _queryTimeout = defaultQueryTimeout);
 
 	void reset() override;
 
@@ -43,10 +46,15 @@ public:
 	void addAssertion(Expression const& _expr) override;
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
 
+	std::string identity() const override;
+
 private:
 	void declareFunction(std::string const& _name, Sort const& _sort);
 
+	/// @returns the translation of @a _expr, reusing the translation of
+	/// subexpressions that were already translated.
 	z3::expr toZ3Expr(Expression const& _expr);
+	z3::expr translate(Expression const& _expr);
 	z3::sort z3Sort(smt::Sort const& _sort);
 	z3::sort_vector z3Sort(std::vector<smt::SortPointer> const& _sorts);
 
@@ -54,6 +62,7 @@ private:
 	z3::solver m_solver;
 	std::map<std::string, z3::expr> m_constants;
 	std::map<std::string, z3::func_decl> m_functions;
+	std::unordered_map<Expression, z3::expr, Expression::Hash, Expression::Identical> m_translations;
 };
 
 }
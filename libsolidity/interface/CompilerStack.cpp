@@ -40,6 +40,7 @@
 #include <libsolidity/ast/TypeProvider.h>
 #include <libsolidity/codegen/Compiler.h>
 #include <libsolidity/formal/ModelChecker.h>
+#include <libsolidity/formal/SolverProcessPool.h>
 #include <libsolidity/interface/ABI.h>
 #include <libsolidity/interface/Natspec.h>
 #include <libsolidity/interface/GasEstimator.h>
@@ -60,6 +61,7 @@
 #include <liblangutil/SemVerHandler.h>
 
 #include <libevmasm/Exceptions.h>
+#include <libevmasm/OptimiserStatistics.h>
 
 #include <libdevcore/SwarmHash.h>
 #include <libdevcore/IpfsHash.h>
@@ -69,6 +71,8 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <thread>
+
 using namespace std;
 using namespace dev;
 using namespace langutil;
@@ -166,12 +170,38 @@ void CompilerStack::addSMTLib2Response(h256 const& _hash, string const& _respons
 	m_smtlib2Responses[_hash] = _response;
 }
 
+void CompilerStack::setSMTQueryCacheDirectory(string const& _directory)
+{
+	if (m_stackState >= ParsingSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must set SMT query cache directory before parsing."));
+	m_smtQueryCacheDirectory = _directory;
+}
+
+void CompilerStack::setSMTSolverCommand(string const& _command)
+{
+	if (m_stackState >= ParsingSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must set SMT solver command before parsing."));
+	if (_command.empty())
+		m_smtSolverProcesses.reset();
+	else if (!m_smtSolverProcesses || m_smtSolverProcesses->command() != _command)
+		m_smtSolverProcesses = make_shared<smt::SolverProcessPool>(_command, thread::hardware_concurrency());
+}
+
+void CompilerStack::setModelCheckerSettings(ModelCheckerSettings _settings)
+{
+	if (m_stackState >= ParsingSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must set model checker settings before parsing."));
+	m_modelCheckerSettings = _settings;
+}
+
 void CompilerStack::reset(bool _keepSettings)
 {
 	m_stackState = Empty;
 	m_sources.clear();
 	m_smtlib2Responses.clear();
 	m_unhandledSMTLib2Queries.clear();
+	m_modelCheckerStatistics = Json::Value();
+	m_optimiserSettings.statistics.reset();
 	if (!_keepSettings)
 	{
 		m_remappings.clear();
@@ -179,8 +209,12 @@ void CompilerStack::reset(bool _keepSettings)
 		m_evmVersion = langutil::EVMVersion();
 		m_generateIR = false;
 		m_generateEWasm = false;
+		m_collectOptimiserStatistics = false;
 		m_optimiserSettings = OptimiserSettings::minimal();
 		m_metadataLiteralSources = false;
+		m_smtQueryCacheDirectory.clear();
+		m_smtSolverProcesses.reset();
+		m_modelCheckerSettings = ModelCheckerSettings();
 	}
 	m_globalContext.reset();
 	m_scopes.clear();
@@ -371,10 +405,17 @@ bool CompilerStack::analyze()
 
 		if (noErrors)
 		{
-			ModelChecker modelChecker(m_errorReporter, m_smtlib2Responses);
+			ModelChecker modelChecker(
+				m_errorReporter,
+				m_smtlib2Responses,
+				m_smtQueryCacheDirectory,
+				m_smtSolverProcesses,
+				m_modelCheckerSettings
+			);
 			for (Source const* source: m_sourceOrder)
 				modelChecker.analyze(*source->ast, source->scanner);
 			m_unhandledSMTLib2Queries += modelChecker.unhandledQueries();
+			m_modelCheckerStatistics = modelChecker.statistics();
 		}
 	}
 	catch(FatalError const&)
@@ -429,14 +470,18 @@ bool CompilerStack::compile()
 		if (!parseAndAnalyze())
 			return false;
 
+	m_optimiserSettings.statistics =
+		m_collectOptimiserStatistics ? make_shared<eth::OptimiserStatistics>() : nullptr;
+
 	// Only compile contracts individually which have been requested.
 	map<ContractDefinition const*, shared_ptr<Compiler const>> otherCompilers;
+	auto yulFunctionCache = make_shared<YulFunctionCache>();
 	for (Source const* source: m_sourceOrder)
 		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 			if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
 				if (isRequestedContract(*contract))
 				{
-					compileContract(*contract, otherCompilers);
+					compileContract(*contract, otherCompilers, yulFunctionCache);
 					if (m_generateIR || m_generateEWasm)
 						generateIR(*contract);
 					if (m_generateEWasm)
@@ -457,6 +502,13 @@ void CompilerStack::link()
 	}
 }
 
+Json::Value CompilerStack::optimiserStatistics() const
+{
+	if (!m_optimiserSettings.statistics)
+		return Json::Value();
+	return m_optimiserSettings.statistics->toJson();
+}
+
 vector<string> CompilerStack::contractNames() const
 {
 	if (m_stackState < AnalysisSuccessful)
@@ -503,13 +555,7 @@ string const* CompilerStack::sourceMapping(string const& _contractName) const
 	if (m_stackState != CompilationSuccessful)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
 
-	Contract const& c = contract(_contractName);
-	if (!c.sourceMapping)
-	{
-		if (auto items = assemblyItems(_contractName))
-			c.sourceMapping.reset(new string(computeSourceMapping(*items)));
-	}
-	return c.sourceMapping.get();
+	return contract(_contractName).sourceMapping.get();
 }
 
 string const* CompilerStack::runtimeSourceMapping(string const& _contractName) const
@@ -517,13 +563,7 @@ string const* CompilerStack::runtimeSourceMapping(string const& _contractName) c
 	if (m_stackState != CompilationSuccessful)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
 
-	Contract const& c = contract(_contractName);
-	if (!c.runtimeSourceMapping)
-	{
-		if (auto items = runtimeAssemblyItems(_contractName))
-			c.runtimeSourceMapping.reset(new string(computeSourceMapping(*items)));
-	}
-	return c.runtimeSourceMapping.get();
+	return contract(_contractName).runtimeSourceMapping.get();
 }
 
 std::string const CompilerStack::filesystemFriendlyName(string const& _contractName) const
@@ -935,7 +975,8 @@ bool onlySafeExperimentalFeaturesActivated(set<ExperimentalFeature> const& featu
 
 void CompilerStack::compileContract(
 	ContractDefinition const& _contract,
-	map<ContractDefinition const*, shared_ptr<Compiler const>>& _otherCompilers
+	map<ContractDefinition const*, shared_ptr<Compiler const>>& _otherCompilers,
+	shared_ptr<YulFunctionCache> const& _yulFunctionCache
 )
 {
 	solAssert(m_stackState >= AnalysisSuccessful, "");
@@ -943,11 +984,11 @@ void CompilerStack::compileContract(
 	if (_otherCompilers.count(&_contract) || !_contract.canBeDeployed())
 		return;
 	for (auto const* dependency: _contract.annotation().contractDependencies)
-		compileContract(*dependency, _otherCompilers);
+		compileContract(*dependency, _otherCompilers, _yulFunctionCache);
 
 	Contract& compiledContract = m_contracts.at(_contract.fullyQualifiedName());
 
-	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_evmVersion, m_optimiserSettings);
+	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_evmVersion, m_optimiserSettings, _yulFunctionCache);
 	compiledContract.compiler = compiler;
 
 	bytes cborEncodedMetadata = createCBORMetadata(
@@ -967,8 +1008,11 @@ void CompilerStack::compileContract(
 
 	try
 	{
-		// Assemble deployment (incl. runtime)  object.
-		compiledContract.object = compiler->assembledObject();
+		// Assemble deployment (incl. runtime)  object and generate the source mappings in the same pass.
+		map<string, unsigned> const indices = sourceIndices();
+		compiledContract.object = compiler->assembledObject(&indices);
+		compiledContract.sourceMapping = make_unique<string const>(compiler->sourceMapping());
+		compiledContract.runtimeSourceMapping = make_unique<string const>(compiler->runtimeSourceMapping());
 	}
 	catch(eth::AssemblyException const&)
 	{
@@ -1129,6 +1173,9 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 		details["deduplicate"] = m_optimiserSettings.runDeduplicate;
 		details["cse"] = m_optimiserSettings.runCSE;
 		details["constantOptimizer"] = m_optimiserSettings.runConstantOptimiser;
+		// Only provided if enabled so that the metadata of existing settings does not change.
+		if (m_optimiserSettings.runBlockLayout)
+			details["blockLayout"] = true;
 		details["yul"] = m_optimiserSettings.runYulOptimiser;
 		if (m_optimiserSettings.runYulOptimiser)
 		{
@@ -1259,82 +1306,6 @@ bytes CompilerStack::createCBORMetadata(string const& _metadata, bool _experimen
 	return encoder.serialise();
 }
 
-string CompilerStack::computeSourceMapping(eth::AssemblyItems const& _items) const
-{
-	if (m_stackState != CompilationSuccessful)
-		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
-
-	string ret;
-	map<string, unsigned> sourceIndicesMap = sourceIndices();
-	int prevStart = -1;
-	int prevLength = -1;
-	int prevSourceIndex = -1;
-	char prevJump = 0;
-	for (auto const& item: _items)
-	{
-		if (!ret.empty())
-			ret += ";";
-
-		SourceLocation const& location = item.location();
-		int length = location.start != -1 && location.end != -1 ? location.end - location.start : -1;
-		int sourceIndex =
-			location.source && sourceIndicesMap.count(location.source->name()) ?
-			sourceIndicesMap.at(location.source->name()) :
-			-1;
-		char jump = '-';
-		if (item.getJumpType() == eth::AssemblyItem::JumpType::IntoFunction)
-			jump = 'i';
-		else if (item.getJumpType() == eth::AssemblyItem::JumpType::OutOfFunction)
-			jump = 'o';
-
-		unsigned components = 4;
-		if (jump == prevJump)
-		{
-			components--;
-			if (sourceIndex == prevSourceIndex)
-			{
-				components--;
-				if (length == prevLength)
-				{
-					components--;
-					if (location.start == prevStart)
-						components--;
-				}
-			}
-		}
-
-		if (components-- > 0)
-		{
-			if (location.start != prevStart)
-				ret += to_string(location.start);
-			if (components-- > 0)
-			{
-				ret += ':';
-				if (length != prevLength)
-					ret += to_string(length);
-				if (components-- > 0)
-				{
-					ret += ':';
-					if (sourceIndex != prevSourceIndex)
-						ret += to_string(sourceIndex);
-					if (components-- > 0)
-					{
-						ret += ':';
-						if (jump != prevJump)
-							ret += jump;
-					}
-				}
-			}
-		}
-
-		prevStart = location.start;
-		prevLength = length;
-		prevSourceIndex = sourceIndex;
-		prevJump = jump;
-	}
-	return ret;
-}
-
 namespace
 {
 
@@ -1376,26 +1347,34 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 
 	if (eth::AssemblyItems const* items = runtimeAssemblyItems(_contractName))
 	{
-		/// External functions
 		ContractDefinition const& contract = contractDefinition(_contractName);
-		Json::Value externalFunctions(Json::objectValue);
+		// The estimations of the functions are independent and run concurrently.
+		// The output group and name of each estimation are stored in keys.
+		vector<pair<string, string>> keys;
+		vector<function<Gas()>> estimations;
+
+		/// External functions
 		for (auto it: contract.interfaceFunctions())
 		{
 			string sig = it.second->externalSignature();
-			externalFunctions[sig] = gasToJson(gasEstimator.functionalEstimation(*items, sig));
+			keys.emplace_back("external", sig);
+			estimations.emplace_back([&, sig]() {
+				return gasEstimator.functionalEstimation(*items, sig);
+			});
 		}
 
 		if (contract.fallbackFunction())
+		{
 			/// This needs to be set to an invalid signature in order to trigger the fallback,
 			/// without the shortcut (of CALLDATSIZE == 0), and therefore to receive the upper bound.
 			/// An empty string ("") would work to trigger the shortcut only.
-			externalFunctions[""] = gasToJson(gasEstimator.functionalEstimation(*items, "INVALID"));
-
-		if (!externalFunctions.empty())
-			output["external"] = externalFunctions;
+			keys.emplace_back("external", "");
+			estimations.emplace_back([&]() {
+				return gasEstimator.functionalEstimation(*items, "INVALID");
+			});
+		}
 
 		/// Internal functions
-		Json::Value internalFunctions(Json::objectValue);
 		for (auto const& it: contract.definedFunctions())
 		{
 			/// Exclude externally visible functions, constructor and the fallback function
@@ -1403,9 +1382,6 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 				continue;
 
 			size_t entry = functionEntryPoint(_contractName, *it);
-			GasEstimator::GasConsumption gas = GasEstimator::GasConsumption::infinite();
-			if (entry > 0)
-				gas = gasEstimator.functionalEstimation(*items, entry, *it);
 
 			/// TODO: This could move into a method shared with externalSignature()
 			FunctionType type(*it);
@@ -1415,11 +1391,18 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 				sig += (*it)->toString() + (it + 1 == paramTypes.end() ? "" : ",");
 			sig += ")";
 
-			internalFunctions[sig] = gasToJson(gas);
+			FunctionDefinition const* function = it;
+			keys.emplace_back("internal", sig);
+			estimations.emplace_back([&, entry, function]() {
+				if (entry == 0)
+					return Gas::infinite();
+				return gasEstimator.functionalEstimation(*items, entry, *function);
+			});
 		}
 
-		if (!internalFunctions.empty())
-			output["internal"] = internalFunctions;
+		vector<Gas> results = GasEstimator::estimateConcurrently(estimations);
+		for (size_t i = 0; i < keys.size(); ++i)
+			output[keys[i].first][keys[i].second] = gasToJson(results[i]);
 	}
 
 	return output;
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <libsolidity/formal/ModelCheckerSettings.h>
 #include <libsolidity/interface/ReadFile.h>
 #include <libsolidity/interface/OptimiserSettings.h>
 #include <libsolidity/interface/Version.h>
@@ -64,6 +65,11 @@ using AssemblyItems = std::vector<AssemblyItem>;
 namespace solidity
 {
 
+namespace smt
+{
+class SolverProcessPool;
+}
+
 // forward declarations
 class ASTNode;
 class ContractDefinition;
@@ -73,6 +79,7 @@ class Compiler;
 class GlobalContext;
 class Natspec;
 class DeclarationContainer;
+class YulFunctionCache;
 
 /**
  * Easy to use and self-contained Solidity compiler with as few header dependencies as possible.
@@ -161,6 +168,9 @@ public:
 	/// Enable experimental generation of eWasm code. If enabled, IR is also generated.
 	void enableEWasmGeneration(bool _enable = true) { m_generateEWasm = _enable; }
 
+	/// Enable recording the effect of the optimiser steps during compilation, see optimiserStatistics().
+	void enableOptimiserStatistics(bool _enable = true) { m_collectOptimiserStatistics = _enable; }
+
 	/// @arg _metadataLiteralSources When true, store sources as literals in the contract metadata.
 	/// Must be set before parsing.
 	void useMetadataLiteralSources(bool _metadataLiteralSources);
@@ -172,6 +182,23 @@ public:
 	/// Must be set before parsing.
 	void addSMTLib2Response(h256 const& _hash, std::string const& _response);
 
+	/// Sets the directory used to persistently cache results of SMT queries
+	/// and the outcome of the verification of functions.
+	/// Caching is disabled if @a _directory is empty.
+	/// Must be set before parsing.
+	void setSMTQueryCacheDirectory(std::string const& _directory);
+
+	/// Sets the command line of an SMT-LIB2 solver that is queried by the SMTChecker
+	/// in addition to the linked solvers. Up to one process per hardware thread is
+	/// started and kept running across compilations.
+	/// Disabled if @a _command is empty.
+	/// Must be set before parsing.
+	void setSMTSolverCommand(std::string const& _command);
+
+	/// Sets the query timeout, time budget and number of threads of the SMTChecker.
+	/// Must be set before parsing.
+	void setModelCheckerSettings(ModelCheckerSettings _settings);
+
 	/// Parses all source units that were added
 	/// @returns false on error.
 	bool parse();
@@ -211,6 +238,14 @@ public:
 	/// by calling @a addSMTLib2Response).
 	std::vector<std::string> const& unhandledSMTLib2Queries() const { return m_unhandledSMTLib2Queries; }
 
+	/// @returns statistics about the SMTChecker queries and verification targets,
+	/// see ModelChecker::statistics. Null if the SMTChecker did not run.
+	Json::Value const& modelCheckerStatistics() const { return m_modelCheckerStatistics; }
+
+	/// @returns the effect of the optimiser steps during the last compilation summed up per step,
+	/// see eth::OptimiserStatistics::toJson. Null if not enabled.
+	Json::Value optimiserStatistics() const;
+
 	/// @returns a list of the contract names in the sources.
 	std::vector<std::string> contractNames() const;
 
@@ -311,8 +346,8 @@ private:
 		mutable std::unique_ptr<Json::Value const> abi;
 		mutable std::unique_ptr<Json::Value const> userDocumentation;
 		mutable std::unique_ptr<Json::Value const> devDocumentation;
-		mutable std::unique_ptr<std::string const> sourceMapping;
-		mutable std::unique_ptr<std::string const> runtimeSourceMapping;
+		std::unique_ptr<std::string const> sourceMapping; ///< Compressed source mapping, generated during assembly.
+		std::unique_ptr<std::string const> runtimeSourceMapping; ///< Compressed source mapping of the runtime code.
 	};
 
 	/// Loads the missing sources from @a _ast (named @a _path) using the callback
@@ -331,9 +366,11 @@ private:
 	/// Compile a single contract.
 	/// @param _otherCompilers provides access to compilers of other contracts, to get
 	///                        their bytecode if needed. Only filled after they have been compiled.
+	/// @param _yulFunctionCache Yul helper functions shared by all contracts.
 	void compileContract(
 		ContractDefinition const& _contract,
-		std::map<ContractDefinition const*, std::shared_ptr<Compiler const>>& _otherCompilers
+		std::map<ContractDefinition const*, std::shared_ptr<Compiler const>>& _otherCompilers,
+		std::shared_ptr<YulFunctionCache> const& _yulFunctionCache
 	);
 
 	/// Generate Yul IR for a single contract.
@@ -365,9 +402,6 @@ private:
 	/// @returns the metadata CBOR for the given serialised metadata JSON.
 	bytes createCBORMetadata(std::string const& _metadata, bool _experimentalMode);
 
-	/// @returns the computer source mapping string.
-	std::string computeSourceMapping(eth::AssemblyItems const& _items) const;
-
 	/// @returns the contract ABI as a JSON object.
 	/// This will generate the JSON object and store it in the Contract object if it is not present yet.
 	Json::Value const& contractABI(Contract const&) const;
@@ -397,6 +431,7 @@ private:
 	std::map<std::string, std::set<std::string>> m_requestedContractNames;
 	bool m_generateIR;
 	bool m_generateEWasm;
+	bool m_collectOptimiserStatistics = false;
 	std::map<std::string, h160> m_libraries;
 	/// list of path prefix remappings, e.g. mylibrary: github.com/ethereum = /usr/local/ethereum
 	/// "context:prefix=target"
@@ -404,6 +439,11 @@ private:
 	std::map<std::string const, Source> m_sources;
 	std::vector<std::string> m_unhandledSMTLib2Queries;
 	std::map<h256, std::string> m_smtlib2Responses;
+	std::string m_smtQueryCacheDirectory;
+	std::shared_ptr<smt::SolverProcessPool> m_smtSolverProcesses;
+	ModelCheckerSettings m_modelCheckerSettings;
+	/// Statistics of the SMTChecker queries of the last analysis.
+	Json::Value m_modelCheckerStatistics;
 	std::shared_ptr<GlobalContext> m_globalContext;
 	std::vector<Source const*> m_sourceOrder;
 	/// This is updated during compilation.
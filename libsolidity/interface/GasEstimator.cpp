@@ -31,9 +31,11 @@
 #include <libevmasm/PathGasMeter.h>
 #include <libdevcore/Keccak256.h>
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
+#include <thread>
 
 using namespace std;
 using namespace dev;
@@ -189,6 +191,39 @@ GasEstimator::GasConsumption GasEstimator::functionalEstimation(
 	return PathGasMeter::estimateMax(_items, m_evmVersion, _offset, state);
 }
 
+vector<GasEstimator::GasConsumption> GasEstimator::estimateConcurrently(
+	vector<function<GasConsumption()>> const& _estimations
+)
+{
+	vector<GasConsumption> results(_estimations.size());
+	vector<exception_ptr> exceptions(_estimations.size());
+	atomic<size_t> nextEstimation{0};
+	auto worker = [&]() {
+		for (size_t i = nextEstimation++; i < _estimations.size(); i = nextEstimation++)
+			try
+			{
+				results[i] = _estimations[i]();
+			}
+			catch (...)
+			{
+				exceptions[i] = current_exception();
+			}
+	};
+
+	size_t workers = min<size_t>(max(thread::hardware_concurrency(), 1u), _estimations.size());
+	vector<thread> threads;
+	for (size_t i = 1; i < workers; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread: threads)
+		thread.join();
+
+	for (auto const& exception: exceptions)
+		if (exception)
+			rethrow_exception(exception);
+	return results;
+}
+
 set<ASTNode const*> GasEstimator::finestNodesAtLocation(
 	vector<ASTNode const*> const& _roots
 )
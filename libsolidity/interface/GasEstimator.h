@@ -28,6 +28,7 @@
 #include <libevmasm/GasMeter.h>
 
 #include <array>
+#include <functional>
 #include <map>
 #include <vector>
 
@@ -81,6 +82,13 @@ public:
 		FunctionDefinition const& _function
 	) const;
 
+	/// Runs the independent estimations @a _estimations concurrently, using up to one
+	/// thread per hardware thread.
+	/// @returns the results in the order of @a _estimations.
+	static std::vector<GasConsumption> estimateConcurrently(
+		std::vector<std::function<GasConsumption()>> const& _estimations
+	);
+
 private:
 	/// @returns the set of AST nodes which are the finest nodes at their location.
 	static std::set<ASTNode const*> finestNodesAtLocation(std::vector<ASTNode const*> const& _roots);
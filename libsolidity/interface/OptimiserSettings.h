@@ -23,9 +23,14 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 
 namespace dev
 {
+namespace eth
+{
+class OptimiserStatistics;
+}
 namespace solidity
 {
 
@@ -57,6 +62,7 @@ struct OptimiserSettings
 		// The only disabled ones
 		s.optimizeStackAllocation = false;
 		s.runYulOptimiser = false;
+		s.runBlockLayout = false;
 		s.expectedExecutionsPerDeployment = 200;
 		return s;
 	}
@@ -66,6 +72,7 @@ struct OptimiserSettings
 		OptimiserSettings s = standard();
 		s.optimizeStackAllocation = true;
 		s.runYulOptimiser = true;
+		s.runBlockLayout = true;
 		return s;
 	}
 
@@ -78,6 +85,7 @@ struct OptimiserSettings
 			runDeduplicate == _other.runDeduplicate &&
 			runCSE == _other.runCSE &&
 			runConstantOptimiser == _other.runConstantOptimiser &&
+			runBlockLayout == _other.runBlockLayout &&
 			optimizeStackAllocation == _other.optimizeStackAllocation &&
 			runYulOptimiser == _other.runYulOptimiser &&
 			expectedExecutionsPerDeployment == _other.expectedExecutionsPerDeployment;
@@ -97,6 +105,9 @@ struct OptimiserSettings
 	/// Constant optimizer, which tries to find better representations that satisfy the given
 	/// size/cost-trade-off.
 	bool runConstantOptimiser = false;
+	/// Reorders the basic blocks such that unconditional jumps go to the following block
+	/// where possible.
+	bool runBlockLayout = false;
 	/// Perform more efficient stack allocation for variables during code generation from Yul to bytecode.
 	bool optimizeStackAllocation = false;
 	/// Yul optimiser with default settings. Will only run on certain parts of the code for now.
@@ -104,6 +115,9 @@ struct OptimiserSettings
 	/// This specifies an estimate on how often each opcode in this assembly will be executed,
 	/// i.e. use a small value to optimise for size and a large value to optimise for runtime gas usage.
 	size_t expectedExecutionsPerDeployment = 200;
+	/// If set, the effect of each optimiser step is recorded here. Not part of the settings
+	/// that influence the output.
+	std::shared_ptr<eth::OptimiserStatistics> statistics;
 };
 
 }
@@ -26,6 +26,7 @@
 #include <libyul/AssemblyStack.h>
 #include <liblangutil/SourceReferenceFormatter.h>
 #include <libevmasm/Instruction.h>
+#include <libevmasm/OptimiserStatistics.h>
 #include <libdevcore/JSON.h>
 #include <libdevcore/Keccak256.h>
 
@@ -349,19 +350,25 @@ boost::optional<Json::Value> checkAuxiliaryInputKeys(Json::Value const& _input)
 
 boost::optional<Json::Value> checkSettingsKeys(Json::Value const& _input)
 {
-	static set<string> keys{"parserErrorRecovery", "evmVersion", "libraries", "metadata", "optimizer", "outputSelection", "remappings"};
+	static set<string> keys{"parserErrorRecovery", "evmVersion", "libraries", "metadata", "modelChecker", "optimizer", "outputSelection", "remappings"};
 	return checkKeys(_input, keys, "settings");
 }
 
+boost::optional<Json::Value> checkModelCheckerKeys(Json::Value const& _input)
+{
+	static set<string> keys{"statistics", "timeBudget", "timeout"};
+	return checkKeys(_input, keys, "settings.modelChecker");
+}
+
 boost::optional<Json::Value> checkOptimizerKeys(Json::Value const& _input)
 {
-	static set<string> keys{"details", "enabled", "runs"};
+	static set<string> keys{"details", "enabled", "runs", "statistics"};
 	return checkKeys(_input, keys, "settings.optimizer");
 }
 
 boost::optional<Json::Value> checkOptimizerDetailsKeys(Json::Value const& _input)
 {
-	static set<string> keys{"peephole", "jumpdestRemover", "orderLiterals", "deduplicate", "cse", "constantOptimizer", "yul", "yulDetails"};
+	static set<string> keys{"peephole", "jumpdestRemover", "orderLiterals", "deduplicate", "cse", "constantOptimizer", "blockLayout", "yul", "yulDetails"};
 	return checkKeys(_input, keys, "settings.optimizer.details");
 }
 
@@ -470,6 +477,8 @@ boost::variant<OptimiserSettings, Json::Value> parseOptimizerSettings(Json::Valu
 			return *error;
 		if (auto error = checkOptimizerDetail(details, "constantOptimizer", settings.runConstantOptimiser))
 			return *error;
+		if (auto error = checkOptimizerDetail(details, "blockLayout", settings.runBlockLayout))
+			return *error;
 		if (auto error = checkOptimizerDetail(details, "yul", settings.runYulOptimiser))
 			return *error;
 		if (settings.runYulOptimiser)
@@ -661,6 +670,37 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 			return boost::get<Json::Value>(std::move(optimiserSettings)); // was an error
 		else
 			ret.optimiserSettings = boost::get<OptimiserSettings>(std::move(optimiserSettings));
+		if (settings["optimizer"].isMember("statistics"))
+		{
+			if (!settings["optimizer"]["statistics"].isBool())
+				return formatFatalError("JSONError", "\"settings.optimizer.statistics\" must be a Boolean.");
+			ret.optimiserStatistics = settings["optimizer"]["statistics"].asBool();
+		}
+	}
+
+	if (settings.isMember("modelChecker"))
+	{
+		Json::Value const& modelChecker = settings["modelChecker"];
+		if (auto result = checkModelCheckerKeys(modelChecker))
+			return *result;
+		if (modelChecker.isMember("timeout"))
+		{
+			if (!modelChecker["timeout"].isUInt())
+				return formatFatalError("JSONError", "\"settings.modelChecker.timeout\" must be an unsigned number.");
+			ret.modelCheckerSettings.queryTimeout = modelChecker["timeout"].asUInt();
+		}
+		if (modelChecker.isMember("timeBudget"))
+		{
+			if (!modelChecker["timeBudget"].isUInt())
+				return formatFatalError("JSONError", "\"settings.modelChecker.timeBudget\" must be an unsigned number.");
+			ret.modelCheckerSettings.timeBudget = modelChecker["timeBudget"].asUInt();
+		}
+		if (modelChecker.isMember("statistics"))
+		{
+			if (!modelChecker["statistics"].isBool())
+				return formatFatalError("JSONError", "\"settings.modelChecker.statistics\" must be a Boolean.");
+			ret.modelCheckerStatistics = modelChecker["statistics"].asBool();
+		}
 	}
 
 	Json::Value jsonLibraries = settings.get("libraries", Json::Value(Json::objectValue));
@@ -733,6 +773,7 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 	compilerStack.setParserErrorRecovery(_inputsAndSettings.parserErrorRecovery);
 	compilerStack.setRemappings(_inputsAndSettings.remappings);
 	compilerStack.setOptimiserSettings(std::move(_inputsAndSettings.optimiserSettings));
+	compilerStack.setModelCheckerSettings(_inputsAndSettings.modelCheckerSettings);
 	compilerStack.setLibraries(_inputsAndSettings.libraries);
 	compilerStack.useMetadataLiteralSources(_inputsAndSettings.metadataLiteralSources);
 	compilerStack.setRequestedContractNames(requestedContractNames(_inputsAndSettings.outputSelection));
@@ -740,6 +781,7 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 	compilerStack.enableIRGeneration(isIRRequested(_inputsAndSettings.outputSelection));
 
 	compilerStack.enableEWasmGeneration(isEWasmRequested(_inputsAndSettings.outputSelection));
+	compilerStack.enableOptimiserStatistics(_inputsAndSettings.optimiserStatistics);
 
 	Json::Value errors = std::move(_inputsAndSettings.errors);
 
@@ -860,6 +902,12 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 		for (string const& query: compilerStack.unhandledSMTLib2Queries())
 			output["auxiliaryInputRequested"]["smtlib2queries"]["0x" + keccak256(query).hex()] = query;
 
+	if (_inputsAndSettings.modelCheckerStatistics && !compilerStack.modelCheckerStatistics().isNull())
+		output["modelChecker"]["statistics"] = compilerStack.modelCheckerStatistics();
+
+	if (_inputsAndSettings.optimiserStatistics && !compilerStack.optimiserStatistics().isNull())
+		output["optimizer"]["statistics"] = compilerStack.optimiserStatistics();
+
 	bool const wildcardMatchesExperimental = false;
 
 	output["sources"] = Json::objectValue;
@@ -969,6 +1017,8 @@ Json::Value StandardCompiler::compileYul(InputsAndSettings _inputsAndSettings)
 
 	Json::Value output = Json::objectValue;
 
+	if (_inputsAndSettings.optimiserStatistics)
+		_inputsAndSettings.optimiserSettings.statistics = make_shared<eth::OptimiserStatistics>();
 	AssemblyStack stack(
 		_inputsAndSettings.evmVersion,
 		AssemblyStack::Language::StrictAssembly,
@@ -1028,6 +1078,9 @@ Json::Value StandardCompiler::compileYul(InputsAndSettings _inputsAndSettings)
 	if (isArtifactRequested(_inputsAndSettings.outputSelection, sourceName, contractName, "evm.assembly", wildcardMatchesExperimental))
 		output["contracts"][sourceName][contractName]["evm"]["assembly"] = object.assembly;
 
+	if (_inputsAndSettings.optimiserSettings.statistics)
+		output["optimizer"]["statistics"] = _inputsAndSettings.optimiserSettings.statistics->toJson();
+
 	return output;
 }
 
@@ -66,6 +66,9 @@ private:
 		langutil::EVMVersion evmVersion;
 		std::vector<CompilerStack::Remapping> remappings;
 		OptimiserSettings optimiserSettings = OptimiserSettings::minimal();
+		bool optimiserStatistics = false;
+		ModelCheckerSettings modelCheckerSettings;
+		bool modelCheckerStatistics = false;
 		std::map<std::string, h160> libraries;
 		bool metadataLiteralSources = false;
 		Json::Value outputSelection;
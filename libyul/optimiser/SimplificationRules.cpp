@@ -49,19 +49,42 @@ SimplificationRule<yul::Pattern> const* SimplificationRules::findFirstMatch(
 	static SimplificationRules rules;
 	assertThrow(rules.isInitialized(), OptimizerException, "Rule list not properly initialized.");
 
-	for (auto const& rule: rules.m_rules[uint8_t(instruction->first)])
+	vector<Expression> const& arguments = *instruction->second;
+	auto argumentRoot = [&](size_t _argument)
+	{
+		if (_argument >= arguments.size())
+			return MatchRoot::any();
+		// Resolve the variable in the same way as Pattern::matches.
+		Expression const* argument = &arguments[_argument];
+		if (argument->type() == typeid(Identifier))
+		{
+			auto value = _ssaValues.find(boost::get<Identifier>(*argument).name);
+			if (value != _ssaValues.end() && value->second)
+				argument = value->second;
+		}
+		if (argument->type() == typeid(Literal))
+		{
+			Literal const& literal = boost::get<Literal>(*argument);
+			if (literal.kind == LiteralKind::Number)
+				return MatchRoot::constant(valueOfNumberLiteral(literal));
+		}
+		else if (auto argumentInstruction = instructionAndArguments(_dialect, *argument))
+			return MatchRoot::operation(argumentInstruction->first);
+		return MatchRoot::any();
+	};
+	for (auto const* rule: rules.m_rules.candidates(instruction->first, argumentRoot))
 	{
 		rules.resetMatchGroups();
-		if (rule.pattern.matches(_expr, _dialect, _ssaValues))
-			if (!rule.feasible || rule.feasible())
-				return &rule;
+		if (rule->pattern.matches(_expr, _dialect, _ssaValues))
+			if (!rule->feasible || rule->feasible())
+				return rule;
 	}
 	return nullptr;
 }
 
 bool SimplificationRules::isInitialized() const
 {
-	return !m_rules[uint8_t(dev::eth::Instruction::ADD)].empty();
+	return !m_rules.empty();
 }
 
 boost::optional<std::pair<dev::eth::Instruction, vector<Expression> const*>>
@@ -78,17 +101,6 @@ boost::optional<std::pair<dev::eth::Instruction, vector<Expression> const*>>
 	return {};
 }
 
-void SimplificationRules::addRules(vector<SimplificationRule<Pattern>> const& _rules)
-{
-	for (auto const& r: _rules)
-		addRule(r);
-}
-
-void SimplificationRules::addRule(SimplificationRule<Pattern> const& _rule)
-{
-	m_rules[uint8_t(_rule.pattern.instruction())].push_back(_rule);
-}
-
 SimplificationRules::SimplificationRules()
 {
 	// Multiple occurrences of one of these inside one rule must match the same equivalence class.
@@ -105,7 +117,7 @@ SimplificationRules::SimplificationRules()
 	X.setMatchGroup(4, m_matchGroups);
 	Y.setMatchGroup(5, m_matchGroups);
 
-	addRules(simplificationRuleList(A, B, C, X, Y));
+	m_rules = RuleDecisionTree<Pattern>(simplificationRuleList(A, B, C, X, Y));
 	assertThrow(isInitialized(), OptimizerException, "Rule list not properly initialized.");
 }
 
@@ -116,8 +128,9 @@ yul::Pattern::Pattern(dev::eth::Instruction _instruction, vector<Pattern> const&
 {
 }
 
-void Pattern::setMatchGroup(unsigned _group, map<unsigned, Expression const*>& _matchGroups)
+void Pattern::setMatchGroup(unsigned _group, MatchGroups<Expression>& _matchGroups)
 {
+	assertThrow(_group > 0 && _group < _matchGroups.size(), OptimizerException, "Invalid match group.");
 	m_matchGroup = _group;
 	m_matchGroups = &_matchGroups;
 }
@@ -180,7 +193,7 @@ bool Pattern::matches(
 		// on the variables and not their values.
 		// The assumption is that CSE or local value numbering has been done prior to this step.
 
-		if (m_matchGroups->count(m_matchGroup))
+		if ((*m_matchGroups)[m_matchGroup])
 		{
 			assertThrow(m_kind == PatternKind::Any, OptimizerException, "Match group repetition for non-any.");
 			Expression const* firstMatch = (*m_matchGroups)[m_matchGroup];
@@ -201,6 +214,16 @@ bool Pattern::matches(
 	return true;
 }
 
+MatchRoot Pattern::root() const
+{
+	if (m_kind == PatternKind::Operation)
+		return MatchRoot::operation(m_instruction);
+	else if (m_kind == PatternKind::Constant)
+		return MatchRoot::constant(m_data ? boost::make_optional(*m_data) : boost::none);
+	else
+		return MatchRoot::any();
+}
+
 dev::eth::Instruction Pattern::instruction() const
 {
 	assertThrow(m_kind == PatternKind::Operation, OptimizerException, "");
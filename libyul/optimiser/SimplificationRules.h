@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <libevmasm/RuleDecisionTree.h>
 #include <libevmasm/SimplificationRule.h>
 
 #include <libyul/AsmDataForward.h>
@@ -61,13 +62,10 @@ public:
 	instructionAndArguments(Dialect const& _dialect, Expression const& _expr);
 
 private:
-	void addRules(std::vector<dev::eth::SimplificationRule<Pattern>> const& _rules);
-	void addRule(dev::eth::SimplificationRule<Pattern> const& _rule);
+	void resetMatchGroups() { m_matchGroups.fill(nullptr); }
 
-	void resetMatchGroups() { m_matchGroups.clear(); }
-
-	std::map<unsigned, Expression const*> m_matchGroups;
-	std::vector<dev::eth::SimplificationRule<Pattern>> m_rules[256];
+	dev::eth::MatchGroups<Expression> m_matchGroups{};
+	dev::eth::RuleDecisionTree<Pattern> m_rules;
 };
 
 enum class PatternKind
@@ -96,13 +94,15 @@ public:
 	/// Sets this pattern to be part of the match group with the identifier @a _group.
 	/// Inside one rule, all patterns in the same match group have to match expressions from the
 	/// same expression equivalence class.
-	void setMatchGroup(unsigned _group, std::map<unsigned, Expression const*>& _matchGroups);
+	void setMatchGroup(unsigned _group, dev::eth::MatchGroups<Expression>& _matchGroups);
 	unsigned matchGroup() const { return m_matchGroup; }
 	bool matches(
 		Expression const& _expr,
 		Dialect const& _dialect,
 		std::map<YulString, Expression const*> const& _ssaValues
 	) const;
+	/// @returns the root of this pattern for the rule decision tree.
+	dev::eth::MatchRoot root() const;
 
 	std::vector<Pattern> arguments() const { return m_arguments; }
 
@@ -123,7 +123,7 @@ private:
 	std::shared_ptr<dev::u256> m_data; ///< Only valid if m_kind is Constant
 	std::vector<Pattern> m_arguments;
 	unsigned m_matchGroup = 0;
-	std::map<unsigned, Expression const*>* m_matchGroups = nullptr;
+	dev::eth::MatchGroups<Expression>* m_matchGroups = nullptr;
 };
 
 }
@@ -53,8 +53,13 @@
 #include <libyul/backends/wasm/WasmDialect.h>
 #include <libyul/backends/evm/NoOutputAssembly.h>
 
+#include <libevmasm/OptimiserStatistics.h>
+
 #include <libdevcore/CommonData.h>
 
+#include <chrono>
+#include <functional>
+
 using namespace std;
 using namespace dev;
 using namespace yul;
@@ -65,7 +70,8 @@ void OptimiserSuite::run(
 	Block& _ast,
 	AsmAnalysisInfo const& _analysisInfo,
 	bool _optimizeStackAllocation,
-	set<YulString> const& _externallyUsedIdentifiers
+	set<YulString> const& _externallyUsedIdentifiers,
+	eth::OptimiserStatistics* _statistics
 )
 {
 	set<YulString> reservedIdentifiers = _externallyUsedIdentifiers;
@@ -73,19 +79,40 @@ void OptimiserSuite::run(
 
 	Block ast = boost::get<Block>(Disambiguator(_dialect, _analysisInfo, reservedIdentifiers)(_ast));
 
-	VarDeclInitializer{}(ast);
-	FunctionHoister{}(ast);
-	BlockFlattener{}(ast);
-	ForLoopInitRewriter{}(ast);
-	DeadCodeEliminator{_dialect}(ast);
-	FunctionGrouper{}(ast);
-	EquivalentFunctionCombiner::run(ast);
-	UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
-	BlockFlattener{}(ast);
-	ControlFlowSimplifier{_dialect}(ast);
-	StructuralSimplifier{_dialect}(ast);
-	ControlFlowSimplifier{_dialect}(ast);
-	BlockFlattener{}(ast);
+	// Runs a single step and records its effect if statistics are requested.
+	auto step = [&](char const* _name, function<void()> const& _step)
+	{
+		if (!_statistics)
+		{
+			_step();
+			return;
+		}
+		eth::OptimiserStepRun run;
+		run.optimiser = "yul";
+		run.step = _name;
+		run.sizeBefore = CodeSize::codeSizeIncludingFunctions(ast);
+		string codeBefore = AsmPrinter{}(ast);
+		auto start = chrono::steady_clock::now();
+		_step();
+		run.time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+		run.sizeAfter = CodeSize::codeSizeIncludingFunctions(ast);
+		run.changed = AsmPrinter{}(ast) != codeBefore;
+		_statistics->record(move(run));
+	};
+
+	step("VarDeclInitializer", [&]() { VarDeclInitializer{}(ast); });
+	step("FunctionHoister", [&]() { FunctionHoister{}(ast); });
+	step("BlockFlattener", [&]() { BlockFlattener{}(ast); });
+	step("ForLoopInitRewriter", [&]() { ForLoopInitRewriter{}(ast); });
+	step("DeadCodeEliminator", [&]() { DeadCodeEliminator{_dialect}(ast); });
+	step("FunctionGrouper", [&]() { FunctionGrouper{}(ast); });
+	step("EquivalentFunctionCombiner", [&]() { EquivalentFunctionCombiner::run(ast); });
+	step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
+	step("BlockFlattener", [&]() { BlockFlattener{}(ast); });
+	step("ControlFlowSimplifier", [&]() { ControlFlowSimplifier{_dialect}(ast); });
+	step("StructuralSimplifier", [&]() { StructuralSimplifier{_dialect}(ast); });
+	step("ControlFlowSimplifier", [&]() { ControlFlowSimplifier{_dialect}(ast); });
+	step("BlockFlattener", [&]() { BlockFlattener{}(ast); });
 
 	// None of the above can make stack problems worse.
 
@@ -103,118 +130,118 @@ void OptimiserSuite::run(
 
 		{
 			// Turn into SSA and simplify
-			ExpressionSplitter{_dialect, dispenser}(ast);
-			SSATransform::run(ast, dispenser);
-			RedundantAssignEliminator::run(_dialect, ast);
-			RedundantAssignEliminator::run(_dialect, ast);
+			step("ExpressionSplitter", [&]() { ExpressionSplitter{_dialect, dispenser}(ast); });
+			step("SSATransform", [&]() { SSATransform::run(ast, dispenser); });
+			step("RedundantAssignEliminator", [&]() { RedundantAssignEliminator::run(_dialect, ast); });
+			step("RedundantAssignEliminator", [&]() { RedundantAssignEliminator::run(_dialect, ast); });
 
-			ExpressionSimplifier::run(_dialect, ast);
-			CommonSubexpressionEliminator{_dialect}(ast);
+			step("ExpressionSimplifier", [&]() { ExpressionSimplifier::run(_dialect, ast); });
+			step("CommonSubexpressionEliminator", [&]() { CommonSubexpressionEliminator{_dialect}(ast); });
 		}
 
 		{
 			// still in SSA, perform structural simplification
-			ControlFlowSimplifier{_dialect}(ast);
-			StructuralSimplifier{_dialect}(ast);
-			ControlFlowSimplifier{_dialect}(ast);
-			BlockFlattener{}(ast);
-			DeadCodeEliminator{_dialect}(ast);
-			UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
+			step("ControlFlowSimplifier", [&]() { ControlFlowSimplifier{_dialect}(ast); });
+			step("StructuralSimplifier", [&]() { StructuralSimplifier{_dialect}(ast); });
+			step("ControlFlowSimplifier", [&]() { ControlFlowSimplifier{_dialect}(ast); });
+			step("BlockFlattener", [&]() { BlockFlattener{}(ast); });
+			step("DeadCodeEliminator", [&]() { DeadCodeEliminator{_dialect}(ast); });
+			step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
 		}
 		{
 			// simplify again
-			CommonSubexpressionEliminator{_dialect}(ast);
-			UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
+			step("CommonSubexpressionEliminator", [&]() { CommonSubexpressionEliminator{_dialect}(ast); });
+			step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
 		}
 
 		{
 			// reverse SSA
-			SSAReverser::run(ast);
-			CommonSubexpressionEliminator{_dialect}(ast);
-			UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
+			step("SSAReverser", [&]() { SSAReverser::run(ast); });
+			step("CommonSubexpressionEliminator", [&]() { CommonSubexpressionEliminator{_dialect}(ast); });
+			step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
 
-			ExpressionJoiner::run(ast);
-			ExpressionJoiner::run(ast);
+			step("ExpressionJoiner", [&]() { ExpressionJoiner::run(ast); });
+			step("ExpressionJoiner", [&]() { ExpressionJoiner::run(ast); });
 		}
 
 		// should have good "compilability" property here.
 
 		{
 			// run functional expression inliner
-			ExpressionInliner(_dialect, ast).run();
-			UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
+			step("ExpressionInliner", [&]() { ExpressionInliner(_dialect, ast).run(); });
+			step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
 		}
 
 		{
 			// Turn into SSA again and simplify
-			ExpressionSplitter{_dialect, dispenser}(ast);
-			SSATransform::run(ast, dispenser);
-			RedundantAssignEliminator::run(_dialect, ast);
-			RedundantAssignEliminator::run(_dialect, ast);
-			CommonSubexpressionEliminator{_dialect}(ast);
+			step("ExpressionSplitter", [&]() { ExpressionSplitter{_dialect, dispenser}(ast); });
+			step("SSATransform", [&]() { SSATransform::run(ast, dispenser); });
+			step("RedundantAssignEliminator", [&]() { RedundantAssignEliminator::run(_dialect, ast); });
+			step("RedundantAssignEliminator", [&]() { RedundantAssignEliminator::run(_dialect, ast); });
+			step("CommonSubexpressionEliminator", [&]() { CommonSubexpressionEliminator{_dialect}(ast); });
 		}
 
 		{
 			// run full inliner
-			FunctionGrouper{}(ast);
-			EquivalentFunctionCombiner::run(ast);
-			FullInliner{ast, dispenser}.run();
-			BlockFlattener{}(ast);
+			step("FunctionGrouper", [&]() { FunctionGrouper{}(ast); });
+			step("EquivalentFunctionCombiner", [&]() { EquivalentFunctionCombiner::run(ast); });
+			step("FullInliner", [&]() { FullInliner{ast, dispenser}.run(); });
+			step("BlockFlattener", [&]() { BlockFlattener{}(ast); });
 		}
 
 		{
 			// SSA plus simplify
-			SSATransform::run(ast, dispenser);
-			RedundantAssignEliminator::run(_dialect, ast);
-			RedundantAssignEliminator::run(_dialect, ast);
-			ExpressionSimplifier::run(_dialect, ast);
-			StructuralSimplifier{_dialect}(ast);
-			BlockFlattener{}(ast);
-			DeadCodeEliminator{_dialect}(ast);
-			ControlFlowSimplifier{_dialect}(ast);
-			CommonSubexpressionEliminator{_dialect}(ast);
-			SSATransform::run(ast, dispenser);
-			RedundantAssignEliminator::run(_dialect, ast);
-			RedundantAssignEliminator::run(_dialect, ast);
-			UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
-			CommonSubexpressionEliminator{_dialect}(ast);
+			step("SSATransform", [&]() { SSATransform::run(ast, dispenser); });
+			step("RedundantAssignEliminator", [&]() { RedundantAssignEliminator::run(_dialect, ast); });
+			step("RedundantAssignEliminator", [&]() { RedundantAssignEliminator::run(_dialect, ast); });
+			step("ExpressionSimplifier", [&]() { ExpressionSimplifier::run(_dialect, ast); });
+			step("StructuralSimplifier", [&]() { StructuralSimplifier{_dialect}(ast); });
+			step("BlockFlattener", [&]() { BlockFlattener{}(ast); });
+			step("DeadCodeEliminator", [&]() { DeadCodeEliminator{_dialect}(ast); });
+			step("ControlFlowSimplifier", [&]() { ControlFlowSimplifier{_dialect}(ast); });
+			step("CommonSubexpressionEliminator", [&]() { CommonSubexpressionEliminator{_dialect}(ast); });
+			step("SSATransform", [&]() { SSATransform::run(ast, dispenser); });
+			step("RedundantAssignEliminator", [&]() { RedundantAssignEliminator::run(_dialect, ast); });
+			step("RedundantAssignEliminator", [&]() { RedundantAssignEliminator::run(_dialect, ast); });
+			step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
+			step("CommonSubexpressionEliminator", [&]() { CommonSubexpressionEliminator{_dialect}(ast); });
 		}
 	}
 
 	// Make source short and pretty.
 
-	ExpressionJoiner::run(ast);
-	Rematerialiser::run(_dialect, ast);
-	UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
-	ExpressionJoiner::run(ast);
-	UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
-	ExpressionJoiner::run(ast);
-	UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
+	step("ExpressionJoiner", [&]() { ExpressionJoiner::run(ast); });
+	step("Rematerialiser", [&]() { Rematerialiser::run(_dialect, ast); });
+	step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
+	step("ExpressionJoiner", [&]() { ExpressionJoiner::run(ast); });
+	step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
+	step("ExpressionJoiner", [&]() { ExpressionJoiner::run(ast); });
+	step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
 
-	SSAReverser::run(ast);
-	CommonSubexpressionEliminator{_dialect}(ast);
-	UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
+	step("SSAReverser", [&]() { SSAReverser::run(ast); });
+	step("CommonSubexpressionEliminator", [&]() { CommonSubexpressionEliminator{_dialect}(ast); });
+	step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
 
-	ExpressionJoiner::run(ast);
-	Rematerialiser::run(_dialect, ast);
-	UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
+	step("ExpressionJoiner", [&]() { ExpressionJoiner::run(ast); });
+	step("Rematerialiser", [&]() { Rematerialiser::run(_dialect, ast); });
+	step("UnusedPruner", [&]() { UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers); });
 
 	// This is a tuning parameter, but actually just prevents infinite loops.
 	size_t stackCompressorMaxIterations = 16;
-	FunctionGrouper{}(ast);
+	step("FunctionGrouper", [&]() { FunctionGrouper{}(ast); });
 	// We ignore the return value because we will get a much better error
 	// message once we perform code generation.
-	StackCompressor::run(_dialect, ast, _optimizeStackAllocation, stackCompressorMaxIterations);
-	BlockFlattener{}(ast);
-	DeadCodeEliminator{_dialect}(ast);
-	ControlFlowSimplifier{_dialect}(ast);
+	step("StackCompressor", [&]() { StackCompressor::run(_dialect, ast, _optimizeStackAllocation, stackCompressorMaxIterations); });
+	step("BlockFlattener", [&]() { BlockFlattener{}(ast); });
+	step("DeadCodeEliminator", [&]() { DeadCodeEliminator{_dialect}(ast); });
+	step("ControlFlowSimplifier", [&]() { ControlFlowSimplifier{_dialect}(ast); });
 
-	FunctionGrouper{}(ast);
+	step("FunctionGrouper", [&]() { FunctionGrouper{}(ast); });
 
 	if (EVMDialect const* dialect = dynamic_cast<EVMDialect const*>(&_dialect))
 	{
 		yulAssert(_meter, "");
-		ConstantOptimiser{*dialect, *_meter}(ast);
+		step("ConstantOptimiser", [&]() { ConstantOptimiser{*dialect, *_meter}(ast); });
 	}
 	else if (dynamic_cast<WasmDialect const*>(&_dialect))
 	{
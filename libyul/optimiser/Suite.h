@@ -26,6 +26,14 @@
 
 #include <set>
 
+namespace dev
+{
+namespace eth
+{
+class OptimiserStatistics;
+}
+}
+
 namespace yul
 {
 
@@ -34,7 +42,8 @@ struct Dialect;
 class GasMeter;
 
 /**
- * Optimiser suite that combines all steps and also provides the settings for the heuristics
+ * Optimiser suite that combines all steps and also provides the settings for the heuristics.
+ * If @a _statistics is given, the effect of each step is recorded there.
  */
 class OptimiserSuite
 {
@@ -45,7 +54,8 @@ public:
 		Block& _ast,
 		AsmAnalysisInfo const& _analysisInfo,
 		bool _optimizeStackAllocation,
-		std::set<YulString> const& _externallyUsedIdentifiers = {}
+		std::set<YulString> const& _externallyUsedIdentifiers = {},
+		dev::eth::OptimiserStatistics* _statistics = nullptr
 	);
 };
 
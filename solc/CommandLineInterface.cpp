@@ -63,6 +63,7 @@
 	#include <unistd.h>
 #endif
 
+#include <chrono>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -118,6 +119,7 @@ static string const g_strEVM15 = "evm15";
 static string const g_strEVMVersion = "evm-version";
 static string const g_streWasm = "ewasm";
 static string const g_strGas = "gas";
+static string const g_strGasEstimationTime = "gas-estimation-time";
 static string const g_strHelp = "help";
 static string const g_strInputFile = "input-file";
 static string const g_strInterface = "interface";
@@ -136,9 +138,15 @@ static string const g_strOpcodes = "opcodes";
 static string const g_strOptimize = "optimize";
 static string const g_strOptimizeRuns = "optimize-runs";
 static string const g_strOptimizeYul = "optimize-yul";
+static string const g_strOptimizerStatistics = "optimizer-statistics";
 static string const g_strOutputDir = "output-dir";
 static string const g_strOverwrite = "overwrite";
 static string const g_strSignatureHashes = "hashes";
+static string const g_strSMTCacheDir = "smt-cache-dir";
+static string const g_strSMTSolver = "smt-solver";
+static string const g_strSMTStatistics = "smt-statistics";
+static string const g_strSMTTimeBudget = "smt-time-budget";
+static string const g_strSMTTimeout = "smt-timeout";
 static string const g_strSources = "sources";
 static string const g_strSourceList = "sourceList";
 static string const g_strSrcMap = "srcmap";
@@ -167,6 +175,7 @@ static string const g_argCombinedJson = g_strCombinedJson;
 static string const g_argCompactJSON = g_strCompactJSON;
 static string const g_argErrorRecovery = g_strErrorRecovery;
 static string const g_argGas = g_strGas;
+static string const g_argGasEstimationTime = g_strGasEstimationTime;
 static string const g_argHelp = g_strHelp;
 static string const g_argInputFile = g_strInputFile;
 static string const g_argYul = g_strYul;
@@ -182,8 +191,14 @@ static string const g_argNatspecUser = g_strNatspecUser;
 static string const g_argOpcodes = g_strOpcodes;
 static string const g_argOptimize = g_strOptimize;
 static string const g_argOptimizeRuns = g_strOptimizeRuns;
+static string const g_argOptimizerStatistics = g_strOptimizerStatistics;
 static string const g_argOutputDir = g_strOutputDir;
 static string const g_argSignatureHashes = g_strSignatureHashes;
+static string const g_argSMTCacheDir = g_strSMTCacheDir;
+static string const g_argSMTSolver = g_strSMTSolver;
+static string const g_argSMTStatistics = g_strSMTStatistics;
+static string const g_argSMTTimeBudget = g_strSMTTimeBudget;
+static string const g_argSMTTimeout = g_strSMTTimeout;
 static string const g_argStandardJSON = g_strStandardJSON;
 static string const g_argStrictAssembly = g_strStrictAssembly;
 static string const g_argVersion = g_strVersion;
@@ -415,7 +430,9 @@ void CommandLineInterface::handleNatspec(bool _natspecDev, string const& _contra
 
 void CommandLineInterface::handleGasEstimation(string const& _contract)
 {
+	auto start = chrono::steady_clock::now();
 	Json::Value estimates = m_compiler->gasEstimates(_contract);
+	auto estimationTime = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
 	sout() << "Gas estimation:" << endl;
 
 	if (estimates["creation"].isObject())
@@ -451,6 +468,72 @@ void CommandLineInterface::handleGasEstimation(string const& _contract)
 			sout() << internalFunctions[name].asString() << endl;
 		}
 	}
+
+	if (m_args.count(g_argGasEstimationTime))
+		sout() << "estimation time: " << estimationTime.count() << " ms" << endl;
+}
+
+void CommandLineInterface::handleSMTStatistics()
+{
+	if (!m_args.count(g_argSMTStatistics))
+		return;
+
+	Json::Value const& statistics = m_compiler->modelCheckerStatistics();
+	if (statistics.isNull())
+		return;
+
+	sout() << "SMTChecker statistics:" << endl;
+	sout() << "queries: " << statistics["queries"].asString();
+	sout() << " (" << statistics["skippedQueries"].asString() << " skipped";
+	sout() << ", " << statistics["cachedQueries"].asString() << " cached)";
+	sout() << ", saved by batching: " << statistics["batchSavedQueries"].asString();
+	sout() << ", reused functions: " << statistics["reusedFunctions"].asString();
+	sout() << ", solver time: " << statistics["solverTime"].asDouble() << " ms" << endl;
+	for (auto const& target: statistics["targets"])
+	{
+		string source = target["source"].asString();
+		int line = -1;
+		int column = -1;
+		if (m_sourceCodes.count(source))
+			tie(line, column) = m_compiler->scanner(source).translatePositionToLineColumn(target["start"].asInt());
+		sout() << "   " << source << ":" << (line + 1) << ":" << (column + 1) << ": " << target["type"].asString() << ": ";
+		sout() << target["result"].asString();
+		if (!target["solver"].asString().empty())
+			sout() << " (" << target["solver"].asString() << ")";
+		sout() << ", " << target["queries"].asString() << " queries";
+		sout() << ", " << target["querySize"].asString() << " bytes";
+		sout() << ", " << target["solverTime"].asDouble() << " ms" << endl;
+	}
+}
+
+void CommandLineInterface::handleOptimiserStatistics()
+{
+	if (!m_args.count(g_argOptimizerStatistics))
+		return;
+
+	Json::Value statistics = m_compiler->optimiserStatistics();
+	if (statistics.isNull())
+		return;
+
+	sout() << "Optimizer statistics:" << endl;
+	for (string const& optimiser: statistics.getMemberNames())
+	{
+		sout() << optimiser << ":" << endl;
+		for (string const& step: statistics[optimiser].getMemberNames())
+		{
+			Json::Value const& stepStatistics = statistics[optimiser][step];
+			sout() << "   " << step << ": " << stepStatistics["runs"].asString() << " runs";
+			sout() << " (" << stepStatistics["changedRuns"].asString() << " changed)";
+			sout() << ", " << stepStatistics["time"].asDouble() << " ms";
+			sout() << ", size " << stepStatistics["sizeBefore"].asString() << " -> " << stepStatistics["sizeAfter"].asString();
+			if (stepStatistics.isMember("bytesDelta"))
+			{
+				sout() << ", " << stepStatistics["bytesDelta"].asString() << " bytes";
+				sout() << ", " << stepStatistics["gasDelta"].asString() << " gas";
+			}
+			sout() << endl;
+		}
+	}
 }
 
 bool CommandLineInterface::readInputFilesAndConfigureRemappings()
@@ -651,6 +734,10 @@ Allowed options)",
 			"Lower values will optimize more for initial deployment cost, higher values will optimize more for high-frequency usage."
 		)
 		(g_strOptimizeYul.c_str(), "Enable Yul optimizer in Solidity, mostly for ABIEncoderV2. Still considered experimental.")
+		(
+			g_argOptimizerStatistics.c_str(),
+			"Print how often each optimizer step ran, how long it took and how it changed the code."
+		)
 		(g_argPrettyJson.c_str(), "Output JSON in pretty format. Currently it only works with the combined JSON output.")
 		(
 			g_argLibraries.c_str(),
@@ -671,6 +758,8 @@ Allowed options)",
 			"Output a single json document containing the specified information."
 		)
 		(g_argGas.c_str(), "Print an estimate of the maximal gas usage for each function.")
+		(g_argGasEstimationTime.c_str(), "Print the time taken for the gas estimation of each contract (used together with --gas).")
+		(g_argSMTStatistics.c_str(), "Print solver time, query size, result and answering solver of each SMTChecker verification target.")
 		(
 			g_argStandardJSON.c_str(),
 			"Switch to Standard JSON input / output mode, ignoring all options. "
@@ -708,6 +797,29 @@ Allowed options)",
 		(g_argNoColor.c_str(), "Explicitly disable colored output, disabling terminal auto-detection.")
 		(g_argNewReporter.c_str(), "Enables new diagnostics reporter.")
 		(g_argErrorRecovery.c_str(), "Enables additional parser error recovery.")
+		(
+			g_argSMTCacheDir.c_str(),
+			po::value<string>()->value_name("path"),
+			"Cache results of SMTChecker queries and of functions in the given directory and reuse them in later runs. "
+			"Functions whose source did not change are not checked again."
+		)
+		(
+			g_argSMTSolver.c_str(),
+			po::value<string>()->value_name("command"),
+			"Also query the SMT-LIB2 solver started by the given command, e.g. \"z3 -in\", from the SMTChecker. "
+			"One solver process per hardware thread is kept running."
+		)
+		(
+			g_argSMTTimeout.c_str(),
+			po::value<unsigned>()->value_name("ms"),
+			"Set the timeout of a single SMTChecker query to the linked solvers in milliseconds (0 for no timeout)."
+		)
+		(
+			g_argSMTTimeBudget.c_str(),
+			po::value<unsigned>()->value_name("ms"),
+			"Limit the total time the SMTChecker solvers may spend in milliseconds. "
+			"Queries after the budget is used up are not solved and their results are unknown."
+		)
 		(g_argIgnoreMissingFiles.c_str(), "Ignore missing files.");
 	po::options_description outputComponents("Output Components");
 	outputComponents.add_options()
@@ -945,11 +1057,25 @@ bool CommandLineInterface::processInput()
 			m_compiler->setLibraries(m_libraries);
 		if (m_args.count(g_argErrorRecovery))
 			m_compiler->setParserErrorRecovery(true);
+		if (m_args.count(g_argSMTCacheDir))
+			m_compiler->setSMTQueryCacheDirectory(m_args[g_argSMTCacheDir].as<string>());
+		if (m_args.count(g_argSMTSolver))
+			m_compiler->setSMTSolverCommand(m_args[g_argSMTSolver].as<string>());
+		if (m_args.count(g_argSMTTimeout) || m_args.count(g_argSMTTimeBudget))
+		{
+			ModelCheckerSettings modelCheckerSettings;
+			if (m_args.count(g_argSMTTimeout))
+				modelCheckerSettings.queryTimeout = m_args[g_argSMTTimeout].as<unsigned>();
+			if (m_args.count(g_argSMTTimeBudget))
+				modelCheckerSettings.timeBudget = m_args[g_argSMTTimeBudget].as<unsigned>();
+			m_compiler->setModelCheckerSettings(modelCheckerSettings);
+		}
 		m_compiler->setEVMVersion(m_evmVersion);
 		// TODO: Perhaps we should not compile unless requested
 
 		m_compiler->enableIRGeneration(m_args.count(g_argIR));
 		m_compiler->enableEWasmGeneration(m_args.count(g_argEWasm));
+		m_compiler->enableOptimiserStatistics(m_args.count(g_argOptimizerStatistics));
 
 		OptimiserSettings settings = m_args.count(g_argOptimize) ? OptimiserSettings::standard() : OptimiserSettings::minimal();
 		settings.expectedExecutionsPerDeployment = m_args[g_argOptimizeRuns].as<unsigned>();
@@ -1397,6 +1523,9 @@ void CommandLineInterface::outputCompilationResults()
 	handleAst(g_argAstJson);
 	handleAst(g_argAstCompactJson);
 
+	handleSMTStatistics();
+	handleOptimiserStatistics();
+
 	vector<string> contracts = m_compiler->contractNames();
 	for (string const& contract: contracts)
 	{
@@ -73,6 +73,8 @@ private:
 	void handleABI(std::string const& _contract);
 	void handleNatspec(bool _natspecDev, std::string const& _contract);
 	void handleGasEstimation(std::string const& _contract);
+	void handleSMTStatistics();
+	void handleOptimiserStatistics();
 	void handleFormal();
 
 	/// Fills @a m_sourceCodes initially and @a m_redirects.
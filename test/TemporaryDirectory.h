@@ -0,0 +1,41 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Temporary directories for tests.
+ */
+
+#pragma once
+
+#include <boost/filesystem.hpp>
+
+namespace dev
+{
+namespace test
+{
+
+/// Unique path in the temporary directory of the system, which is removed
+/// including its contents on destruction. The directory itself is not created.
+struct TemporaryDirectory
+{
+	TemporaryDirectory();
+	~TemporaryDirectory();
+
+	boost::filesystem::path path;
+};
+
+}
+}
@@ -182,7 +182,12 @@ test_suite* init_unit_test_suite( int /*argc*/, char* /*argv*/[] )
 	}
 
 	if (dev::test::Options::get().disableSMT)
-		removeTestSuite("SMTChecker");
+		for (auto suite: {
+			"SMTChecker",
+			"SMTQueryCacheStatisticsTest",
+			"SMTVerificationResultCacheTest"
+		})
+			removeTestSuite(suite);
 
 	return 0;
 }
@@ -194,6 +194,53 @@ BOOST_AUTO_TEST_CASE(invalid_param_rendered)
 	BOOST_CHECK_EQUAL(m.render(), templ);
 }
 
+BOOST_AUTO_TEST_CASE(unterminated_tags_rendered)
+{
+	string templ = "<?b>x <a> <#l>y</b";
+	BOOST_CHECK_EQUAL(Whiskers(templ)("a", "A").render(), "<?b>x A <#l>y</b");
+}
+
+BOOST_AUTO_TEST_CASE(template_reused)
+{
+	string templ = "<?b><x><!b>-</b><#l>(<y>)</l>";
+	vector<map<string, string>> list(2);
+	list[0]["y"] = "1";
+	list[1]["y"] = "2";
+	BOOST_CHECK_EQUAL(Whiskers(templ)("b", true)("x", "X")("l", list).render(), "X(1)(2)");
+	BOOST_CHECK_EQUAL(Whiskers(templ)("b", false)("l", vector<map<string, string>>{}).render(), "-");
+	Whiskers m(templ);
+	m("b", true)("l", list);
+	BOOST_CHECK_THROW(m.render(), WhiskersError);
+}
+
+BOOST_AUTO_TEST_CASE(error_messages_contain_context)
+{
+	string templ = "a <#l><x></l> <?c>y</c>";
+	auto mentions = [](vector<string> const& _parts) {
+		return [=](WhiskersError const& _error) {
+			for (auto const& part: _parts)
+				if (!_error.comment() || _error.comment()->find(part) == string::npos)
+					return false;
+			return true;
+		};
+	};
+	BOOST_CHECK_EXCEPTION(Whiskers{templ}.render(), WhiskersError, mentions({"l", templ}));
+	BOOST_CHECK_EXCEPTION(
+		Whiskers{templ}("l", vector<map<string, string>>{}).render(),
+		WhiskersError,
+		mentions({"c", templ})
+	);
+	vector<map<string, string>> list(1);
+	list[0]["x"] = "1";
+	BOOST_CHECK_EXCEPTION(
+		Whiskers{templ}("x", "X")("l", list)("c", true).render(),
+		WhiskersError,
+		mentions({"x", "<x>"})
+	);
+	BOOST_CHECK_EXCEPTION(Whiskers{templ}("c", true)("c", false), WhiskersError, mentions({"c", templ}));
+	BOOST_CHECK_EXCEPTION(Whiskers{templ}("x y", "X"), WhiskersError, mentions({"x y", templ}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -25,6 +25,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <map>
 #include <string>
 #include <tuple>
 #include <memory>
@@ -148,6 +149,83 @@ BOOST_AUTO_TEST_CASE(all_assembly_items)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(item_data_and_locations)
+{
+	auto source = make_shared<CharStream>("", "a.asm");
+	u256 big = u256(1) << 200;
+	AssemblyItem small(u256(7), {1, 3, source});
+	AssemblyItem large(big + 1, {1, 3, source});
+	AssemblyItem other(big + 2, {1, 4, source});
+	BOOST_CHECK_EQUAL(small.data(), u256(7));
+	BOOST_CHECK_EQUAL(large.data(), big + 1);
+	BOOST_CHECK(small < large);
+	BOOST_CHECK(large < other);
+	BOOST_CHECK(large != other);
+	BOOST_CHECK(large == AssemblyItem(big + 1));
+
+	BOOST_CHECK(small.hasSameLocation(large));
+	BOOST_CHECK(!large.hasSameLocation(other));
+	BOOST_CHECK(large.location() == SourceLocation({1, 3, source}));
+	BOOST_CHECK(AssemblyItem(Instruction::ADD).location().isEmpty());
+
+	AssemblyItem copy = large;
+	copy.setData(2);
+	BOOST_CHECK_EQUAL(copy.data(), u256(2));
+	BOOST_CHECK_EQUAL(large.data(), big + 1);
+	copy.copyLocation(other);
+	BOOST_CHECK(copy.location() == other.location());
+
+	// Locations do not keep their source alive and are not confused with locations
+	// of a source that is later allocated at the same address.
+	source.reset();
+	BOOST_CHECK(!small.location().source);
+	auto newSource = make_shared<CharStream>("", "b.asm");
+	AssemblyItem item(Instruction::ADD, {1, 3, newSource});
+	BOOST_CHECK(!item.hasSameLocation(small));
+	BOOST_CHECK(item.location().source == newSource);
+}
+
+BOOST_AUTO_TEST_CASE(source_mapping)
+{
+	auto rootSource = make_shared<CharStream>("", "root.asm");
+	auto subSource = make_shared<CharStream>("", "sub.asm");
+	auto createAssembly = [&]() {
+		auto subAssembly = make_shared<Assembly>();
+		subAssembly->setSourceLocation({6, 8, subSource});
+		subAssembly->append(Instruction::INVALID);
+
+		auto assembly = make_shared<Assembly>();
+		assembly->setSourceLocation({1, 3, rootSource});
+		auto tag = assembly->newTag();
+		assembly->append(tag);
+		assembly->append(u256(1));
+		assembly->append(Instruction::POP);
+		assembly->setSourceLocation({4, 6, rootSource});
+		assembly->appendJump(tag);
+		assembly->items().back().setJumpType(AssemblyItem::JumpType::IntoFunction);
+		assembly->setSourceLocation({});
+		assembly->append(Instruction::STOP);
+		assembly->appendSubroutine(subAssembly);
+		return assembly;
+	};
+	map<string, unsigned> const sourceIndices{{"root.asm", 0}, {"sub.asm", 1}};
+	string const expectation = "1:2:0:-;;;4;:::i;-1:-1:-1:-;";
+	string const subExpectation = "6:2:1:-";
+
+	auto assembly = createAssembly();
+	BOOST_CHECK(assembly->assemble(&sourceIndices).toHex() == createAssembly()->assemble().toHex());
+	BOOST_CHECK_EQUAL(assembly->sourceMapping(), expectation);
+	BOOST_CHECK_EQUAL(assembly->sub(0).sourceMapping(), subExpectation);
+
+	// The mappings are also generated if the assembly was assembled before.
+	assembly = createAssembly();
+	assembly->assemble();
+	BOOST_CHECK(assembly->sourceMapping().empty());
+	assembly->assemble(&sourceIndices);
+	BOOST_CHECK_EQUAL(assembly->sourceMapping(), expectation);
+	BOOST_CHECK_EQUAL(assembly->sub(0).sourceMapping(), subExpectation);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
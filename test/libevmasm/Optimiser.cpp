@@ -27,6 +27,8 @@
 #include <libevmasm/JumpdestRemover.h>
 #include <libevmasm/ControlFlowGraph.h>
 #include <libevmasm/BlockDeduplicator.h>
+#include <libevmasm/BlockLayoutOptimiser.h>
+#include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/Assembly.h>
 
 #include <boost/test/unit_test.hpp>
@@ -34,6 +36,7 @@
 #include <string>
 #include <tuple>
 #include <memory>
+#include <random>
 
 using namespace std;
 using namespace langutil;
@@ -673,6 +676,33 @@ BOOST_AUTO_TEST_CASE(cse_equality_on_initially_known_stack)
 	BOOST_CHECK(find(output.begin(), output.end(), AssemblyItem(u256(1))) != output.end());
 }
 
+BOOST_AUTO_TEST_CASE(cse_copied_state_is_independent)
+{
+	eth::KnownState state = createInitialState(AssemblyItems{
+		u256(7),
+		u256(1),
+		Instruction::SSTORE,
+		u256(2)
+	});
+	shared_ptr<eth::KnownState> copy = state.copy();
+	BOOST_CHECK(*copy == state);
+	for (auto const& item: addDummyLocations(AssemblyItems{u256(8), u256(3), Instruction::SSTORE, u256(4)}))
+		copy->feedItem(item, true);
+	BOOST_CHECK(!(*copy == state));
+	BOOST_CHECK_EQUAL(state.stackHeight(), 1);
+	BOOST_CHECK_EQUAL(state.stackElements().size(), 1);
+	BOOST_CHECK_EQUAL(state.storageContent().size(), 1);
+	BOOST_CHECK_EQUAL(copy->stackHeight(), 2);
+	BOOST_CHECK_EQUAL(copy->storageContent().size(), 2);
+
+	// Only the value stored in both states is retained.
+	copy->reduceToCommonKnowledge(state, true);
+	BOOST_CHECK_EQUAL(copy->stackHeight(), 1);
+	BOOST_CHECK_EQUAL(copy->stackElements().size(), 0);
+	BOOST_CHECK(copy->storageContent() == state.storageContent());
+	BOOST_CHECK_EQUAL(state.storageContent().size(), 1);
+}
+
 BOOST_AUTO_TEST_CASE(cse_access_previous_sequence)
 {
 	// Tests that the code generator detects whether it tries to access SLOAD instructions
@@ -802,6 +832,31 @@ BOOST_AUTO_TEST_CASE(block_deduplicator)
 	BOOST_CHECK_EQUAL(pushTags.size(), 2);
 }
 
+BOOST_AUTO_TEST_CASE(block_deduplicator_tag_table)
+{
+	AssemblyItems input{
+		AssemblyItem::tagTable({1, 2, 3}),
+		u256(1),
+		Instruction::SHR,
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		u256(6),
+		Instruction::STOP,
+		AssemblyItem(Tag, 2),
+		u256(6),
+		Instruction::STOP,
+		AssemblyItem(Tag, 3),
+		u256(7),
+		Instruction::STOP
+	};
+	BlockDeduplicator dedup(input);
+	BOOST_REQUIRE(dedup.deduplicate());
+
+	vector<size_t> entries = input.front().tagTableEntries();
+	BOOST_CHECK_EQUAL(entries[0], entries[1]);
+	BOOST_CHECK_EQUAL(entries[2], 3);
+}
+
 BOOST_AUTO_TEST_CASE(block_deduplicator_loops)
 {
 	AssemblyItems input{
@@ -834,6 +889,58 @@ BOOST_AUTO_TEST_CASE(block_deduplicator_loops)
 	BOOST_CHECK_EQUAL(pushTags.size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(block_deduplicator_many_blocks)
+{
+	// Loops that only differ in the stored value and their own tag.
+	size_t const blocks = 60;
+	AssemblyItems input;
+	for (size_t i = 1; i <= blocks; ++i)
+		input += AssemblyItems{AssemblyItem(PushTag, i), Instruction::POP};
+	input.emplace_back(Instruction::STOP);
+	for (size_t i = 1; i <= blocks; ++i)
+		input += AssemblyItems{
+			AssemblyItem(Tag, i),
+			u256(i % 3),
+			u256(0),
+			Instruction::SSTORE,
+			AssemblyItem(PushTag, i),
+			Instruction::JUMP
+		};
+	BlockDeduplicator dedup(input);
+	BOOST_CHECK(dedup.deduplicate());
+
+	set<u256> pushTags;
+	for (AssemblyItem const& item: input)
+		if (item.type() == PushTag)
+			pushTags.insert(item.data());
+	BOOST_CHECK((pushTags == set<u256>{1, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(block_deduplicator_fall_through_chains)
+{
+	// Two equal chains of blocks that fall through to the next block
+	// and jump back to the first block of their chain at the end.
+	size_t const blocks = 1000;
+	AssemblyItems input{AssemblyItem(PushTag, 1), AssemblyItem(PushTag, blocks + 1), Instruction::STOP};
+	for (size_t chain = 0; chain < 2; ++chain)
+	{
+		for (size_t i = 1; i <= blocks; ++i)
+			input += AssemblyItems{AssemblyItem(Tag, chain * blocks + i), u256(i), Instruction::POP};
+		input += AssemblyItems{AssemblyItem(PushTag, chain * blocks + 1), Instruction::JUMP};
+	}
+	BlockDeduplicator dedup(input);
+	BOOST_CHECK(dedup.deduplicate());
+	BOOST_CHECK_EQUAL(dedup.replacedTags().size(), blocks);
+	for (auto const& replacement: dedup.replacedTags())
+		BOOST_CHECK_EQUAL(replacement.first, replacement.second + blocks);
+
+	set<u256> pushTags;
+	for (AssemblyItem const& item: input)
+		if (item.type() == PushTag)
+			pushTags.insert(item.data());
+	BOOST_CHECK((pushTags == set<u256>{1}));
+}
+
 BOOST_AUTO_TEST_CASE(clear_unreachable_code)
 {
 	AssemblyItems items{
@@ -903,9 +1010,9 @@ BOOST_AUTO_TEST_CASE(peephole_pop_calldatasize)
 		Instruction::POP
 	};
 	PeepholeOptimiser peepOpt(items);
-	for (size_t i = 0; i < 3; i++)
-		BOOST_CHECK(peepOpt.optimise());
+	BOOST_CHECK(peepOpt.optimise());
 	BOOST_CHECK(items.empty());
+	BOOST_CHECK(!peepOpt.optimise());
 }
 
 BOOST_AUTO_TEST_CASE(peephole_commutative_swap1)
@@ -1075,6 +1182,69 @@ BOOST_AUTO_TEST_CASE(peephole_iszero_iszero_jumpi)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(peephole_single_sweep_matches_repeated_passes)
+{
+	// Fragments chosen such that all rules and many overlaps between them occur.
+	vector<AssemblyItems> const fragments{
+		{u256(0)},
+		{u256(0)},
+		{u256(1)},
+		{u256(0xffffffff)},
+		{AssemblyItem(PushTag, 1)},
+		{AssemblyItem(PushTag, 2)},
+		{AssemblyItem(Tag, 1)},
+		{AssemblyItem(Tag, 2)},
+		{AssemblyItem(PushData, 3)},
+		{Instruction::POP},
+		{Instruction::POP},
+		{Instruction::POP},
+		{Instruction::DUP1},
+		{Instruction::DUP2},
+		{Instruction::SWAP1},
+		{Instruction::SWAP1},
+		{Instruction::SWAP2},
+		{Instruction::ISZERO},
+		{Instruction::ISZERO},
+		{Instruction::NOT},
+		{Instruction::AND},
+		{Instruction::ADD},
+		{Instruction::SUB},
+		{Instruction::LT},
+		{Instruction::SGT},
+		{Instruction::ADDMOD},
+		{Instruction::CALLDATALOAD},
+		{Instruction::SSTORE},
+		{Instruction::JUMP},
+		{Instruction::JUMPI},
+		{Instruction::STOP},
+		{Instruction::RETURN},
+		{Instruction::ISZERO, Instruction::ISZERO, AssemblyItem(PushTag, 1)},
+		{Instruction::ISZERO, Instruction::ISZERO, AssemblyItem(PushTag, 1), Instruction::DUP1, Instruction::POP, Instruction::JUMPI},
+		{AssemblyItem(PushTag, 2), Instruction::JUMPI, AssemblyItem(Tag, 2)}
+	};
+	mt19937 random(1);
+	for (size_t run = 0; run < 5000; ++run)
+	{
+		AssemblyItems input;
+		for (size_t i = uniform_int_distribution<size_t>(0, 30)(random); i > 0; --i)
+			input += fragments[uniform_int_distribution<size_t>(0, fragments.size() - 1)(random)];
+
+		AssemblyItems expectation = input;
+		bool expectChange = false;
+		PeepholeOptimiser reference(expectation);
+		while (reference.optimiseWithoutBacktracking())
+			expectChange = true;
+
+		AssemblyItems items = input;
+		PeepholeOptimiser peepOpt(items);
+		BOOST_CHECK_EQUAL(peepOpt.optimise(), expectChange);
+		BOOST_CHECK_EQUAL_COLLECTIONS(
+			items.begin(), items.end(),
+			expectation.begin(), expectation.end()
+		);
+	}
+}
+
 BOOST_AUTO_TEST_CASE(jumpdest_removal)
 {
 	AssemblyItems items{
@@ -1102,6 +1272,124 @@ BOOST_AUTO_TEST_CASE(jumpdest_removal)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(jumpdest_removal_tag_table)
+{
+	AssemblyItems items{
+		AssemblyItem::tagTable({1, 3}),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		u256(5),
+		AssemblyItem(Tag, 2),
+		u256(6),
+		AssemblyItem(Tag, 3),
+		Instruction::STOP,
+	};
+	AssemblyItems expectation{
+		AssemblyItem::tagTable({1, 3}),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		u256(5),
+		u256(6),
+		AssemblyItem(Tag, 3),
+		Instruction::STOP,
+	};
+	JumpdestRemover jdr(items);
+	BOOST_REQUIRE(jdr.optimise({}));
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(block_layout)
+{
+	AssemblyItems items{
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		u256(0),
+		Instruction::DUP1,
+		Instruction::REVERT,
+		AssemblyItem(Tag, 3),
+		u256(1),
+		u256(0),
+		Instruction::SSTORE,
+		Instruction::STOP,
+		AssemblyItem(Tag, 2),
+		u256(0),
+		Instruction::SLOAD,
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMPI,
+		AssemblyItem(PushTag, 3),
+		Instruction::JUMP
+	};
+	// The reverting block moves to the end.
+	AssemblyItems expectation{
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		u256(0),
+		Instruction::SLOAD,
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMPI,
+		AssemblyItem(PushTag, 3),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 3),
+		u256(1),
+		u256(0),
+		Instruction::SSTORE,
+		Instruction::STOP,
+		AssemblyItem(Tag, 1),
+		u256(0),
+		Instruction::DUP1,
+		Instruction::REVERT
+	};
+	BOOST_CHECK_EQUAL(BlockLayoutOptimiser::jumpsToNextTag(items), 0);
+	BlockLayoutOptimiser layout(items);
+	BOOST_REQUIRE(layout.optimise());
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+	BOOST_CHECK_EQUAL(BlockLayoutOptimiser::jumpsToNextTag(items), 2);
+	BOOST_CHECK(!BlockLayoutOptimiser(items).optimise());
+}
+
+BOOST_AUTO_TEST_CASE(block_layout_keeps_fixed_blocks)
+{
+	// The block at the end falls off the code and stays there.
+	AssemblyItems items{
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		u256(1),
+		Instruction::STOP,
+		AssemblyItem(Tag, 1),
+		u256(2),
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMPI
+	};
+	AssemblyItems original = items;
+	BOOST_CHECK(!BlockLayoutOptimiser(items).optimise());
+	BOOST_CHECK(items == original);
+
+	// Nothing is moved if the code uses positions of instructions.
+	items = AssemblyItems{
+		Instruction::PC,
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		Instruction::STOP,
+		AssemblyItem(Tag, 1),
+		Instruction::STOP
+	};
+	original = items;
+	BOOST_CHECK(!BlockLayoutOptimiser(items).optimise());
+	BOOST_CHECK(items == original);
+	items.erase(items.begin());
+	BOOST_CHECK(BlockLayoutOptimiser(items).optimise());
+}
+
 BOOST_AUTO_TEST_CASE(jumpdest_removal_subassemblies)
 {
 	// This tests that tags from subassemblies are not removed
@@ -1158,6 +1446,71 @@ BOOST_AUTO_TEST_CASE(jumpdest_removal_subassemblies)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(many_subassemblies)
+{
+	// Sub-assemblies are optimised concurrently. The result has to be the same as
+	// if they were optimised one by one, especially the tag replacements have to
+	// be applied to the references of the right sub-assembly.
+	size_t const subCount = 6;
+	auto createSub = [](size_t _blocks) {
+		AssemblyPointer sub = make_shared<Assembly>();
+		vector<AssemblyItem> tags;
+		for (size_t i = 0; i < _blocks; ++i)
+		{
+			tags.push_back(sub->newTag());
+			sub->append(tags.back());
+			sub->append(tags.back().pushTag());
+			sub->append(Instruction::JUMP);
+		}
+		return make_pair(sub, tags);
+	};
+	auto appendSub = [](Assembly& _assembly, pair<AssemblyPointer, vector<AssemblyItem>> const& _sub) {
+		size_t subId = size_t(_assembly.appendSubroutine(_sub.first).data());
+		_assembly.append(_sub.second.front().toSubAssemblyTag(subId));
+		_assembly.append(_sub.second.back().toSubAssemblyTag(subId));
+	};
+
+	Assembly main;
+	vector<AssemblyPointer> subs;
+	for (size_t i = 0; i < subCount; ++i)
+	{
+		auto sub = createSub(i + 1);
+		subs.push_back(sub.first);
+		appendSub(main, sub);
+	}
+	// Using the same assembly twice disables the concurrent optimisation
+	// for this assembly, but not for its own sub-assemblies.
+	Assembly outer;
+	AssemblyPointer mainPointer = make_shared<Assembly>(main);
+	outer.appendSubroutine(mainPointer);
+	outer.appendSubroutine(mainPointer);
+	outer.optimise(true, dev::test::Options::get().evmVersion(), false, 200);
+
+	AssemblyItems expectationMain;
+	for (size_t i = 0; i < subCount; ++i)
+	{
+		Assembly single;
+		auto sub = createSub(i + 1);
+		appendSub(single, sub);
+		single.optimise(true, dev::test::Options::get().evmVersion(), false, 200);
+		for (AssemblyItem const& item: single.items())
+			if (item.type() == PushSubSize)
+				expectationMain.push_back(AssemblyItem(PushSubSize, i));
+			else if (item.type() == PushTag)
+				expectationMain.push_back(AssemblyItem(Tag, item.splitForeignPushTag().second).toSubAssemblyTag(i));
+			else
+				expectationMain.push_back(item);
+		BOOST_CHECK_EQUAL_COLLECTIONS(
+			subs[i]->items().begin(), subs[i]->items().end(),
+			sub.first->items().begin(), sub.first->items().end()
+		);
+	}
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		mainPointer->items().begin(), mainPointer->items().end(),
+		expectationMain.begin(), expectationMain.end()
+	);
+}
+
 BOOST_AUTO_TEST_CASE(cse_sub_zero)
 {
 	checkCSE({
@@ -1370,6 +1723,27 @@ BOOST_AUTO_TEST_CASE(cse_replace_too_large_shift)
 	});
 }
 
+BOOST_AUTO_TEST_CASE(constant_optimiser_cache)
+{
+	ComputeMethod::clearCache();
+	auto optimise = []()
+	{
+		Assembly assembly;
+		assembly.append(u256(1) << 200);
+		assembly.append(Instruction::POP);
+		ConstantOptimisationMethod::optimiseConstants(false, 200, dev::test::Options::get().evmVersion(), assembly);
+		return assembly.items();
+	};
+	AssemblyItems first = optimise();
+	BOOST_CHECK_EQUAL(ComputeMethod::cacheStatistics().hits, 0);
+	BOOST_CHECK_EQUAL(ComputeMethod::cacheStatistics().misses, 1);
+	AssemblyItems second = optimise();
+	BOOST_CHECK_EQUAL(ComputeMethod::cacheStatistics().hits, 1);
+	BOOST_CHECK_EQUAL(ComputeMethod::cacheStatistics().misses, 1);
+	BOOST_CHECK(first.size() > 2);
+	BOOST_CHECK(first == second);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
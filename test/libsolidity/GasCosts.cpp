@@ -125,6 +125,41 @@ BOOST_AUTO_TEST_CASE(string_storage)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(packed_array_copy)
+{
+	char const* sourceCode = R"(
+		contract C {
+			uint8[] a;
+			uint16[] b;
+			function f() public {
+				uint8[] memory m = new uint8[](64);
+				for (uint i = 0; i < 64; i++)
+					m[i] = uint8(i + 1);
+				a = m;
+			}
+			function g(uint16[] calldata x) external {
+				b = x;
+			}
+		}
+	)";
+	compileAndRun(sourceCode);
+
+	// Storage writes are metered differently on Constantinople.
+	if (Options::get().evmVersion() != EVMVersion::petersburg() || Options::get().useABIEncoderV2)
+		return;
+
+	// Two slots, each written by a single SSTORE.
+	callContractFunction("f()");
+	CHECK_GAS(97918, 97138, 100);
+
+	vector<u256> values;
+	for (unsigned i = 1; i <= 40; ++i)
+		values.push_back(u256(i));
+	// Three slots, each written by a single SSTORE.
+	callContractFunction("g(uint16[])", u256(0x20), u256(values.size()), values);
+	CHECK_GAS(114395, 114075, 100);
+}
+
 BOOST_AUTO_TEST_CASE(single_callvaluecheck)
 {
 	string sourceCode = R"(
@@ -20,6 +20,10 @@
 
 #include <test/libsolidity/AnalysisFramework.h>
 
+#include <test/Options.h>
+
+#include <liblangutil/SourceReferenceFormatter.h>
+
 #include <boost/test/unit_test.hpp>
 
 #include <string>
@@ -248,6 +252,55 @@ BOOST_AUTO_TEST_CASE(mod)
 	CHECK_SUCCESS_NO_WARNINGS(text);
 }
 
+BOOST_AUTO_TEST_CASE(parallel_jobs_deterministic)
+{
+	string text = R"(
+		pragma experimental SMTChecker;
+		contract A {
+			uint8 x = 200 + 55;
+			function f(uint a, uint b) public pure returns (uint) {
+				return a / b;
+			}
+			function g(uint8 a) public pure returns (uint8) {
+				return a + 1;
+			}
+		}
+		contract B {
+			uint[] a;
+			function f(uint i) public view {
+				assert(a[i] > 0);
+			}
+			function g(int a, int b) public pure returns (int) {
+				require(a > 0);
+				return a * b - 7;
+			}
+			function h(uint i) public view returns (uint) {
+				require(i < 10);
+				assert(i < 9);
+				return a[i] - 1;
+			}
+		}
+	)";
+	auto warnings = [&](unsigned _jobs) {
+		CompilerStack compiler;
+		compiler.setSources({{"", text}});
+		compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+		ModelCheckerSettings settings;
+		settings.jobs = _jobs;
+		compiler.setModelCheckerSettings(settings);
+		BOOST_REQUIRE(compiler.parseAndAnalyze());
+		string result;
+		for (auto const& error: compiler.errors())
+			result += SourceReferenceFormatter::formatErrorInformation(*error);
+		return result;
+	};
+	string serial = warnings(1);
+	BOOST_CHECK(serial.find("Division by zero") != string::npos);
+	BOOST_CHECK(serial.find("Assertion violation") != string::npos);
+	for (size_t i = 0; i < 3; ++i)
+		BOOST_CHECK_EQUAL(warnings(4), serial);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
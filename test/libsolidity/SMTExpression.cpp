@@ -0,0 +1,97 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the hash-consed SMT expressions.
+ */
+
+#include <libsolidity/formal/ConeOfInfluence.h>
+#include <libsolidity/formal/SMTLib2Interface.h>
+
+#include <test/Options.h>
+
+using namespace std;
+using namespace dev::solidity::smt;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(SMTExpressionTest)
+
+BOOST_AUTO_TEST_CASE(structurally_equal_expressions_share_nodes)
+{
+	SMTLib2Interface solver({});
+	Expression x = solver.newVariable("x", make_shared<Sort>(Kind::Int));
+	Expression y = solver.newVariable("y", make_shared<Sort>(Kind::Int));
+
+	Expression a = (x + y) > 2 && x < y;
+	Expression b = (x + y) > 2 && x < y;
+	BOOST_CHECK(a.identical(b));
+	BOOST_CHECK(a.arguments()[0].identical(b.arguments()[0]));
+	BOOST_CHECK(Expression::Hash{}(a) == Expression::Hash{}(b));
+
+	BOOST_CHECK(!a.identical((x + y) > 3 && x < y));
+	BOOST_CHECK(!a.identical((y + x) > 2 && x < y));
+	BOOST_CHECK(!x.identical(solver.newVariable("x", make_shared<Sort>(Kind::Bool))));
+}
+
+BOOST_AUTO_TEST_CASE(shared_subterms_keep_structure)
+{
+	SMTLib2Interface solver({});
+	Expression x = solver.newVariable("x", make_shared<Sort>(Kind::Int));
+	Expression path = x > 0;
+	Expression a = path && x < 10;
+	Expression b = path && x > 10;
+	BOOST_CHECK(a.arguments()[0].identical(b.arguments()[0]));
+	BOOST_CHECK_EQUAL(a.name(), "and");
+	BOOST_CHECK_EQUAL(a.arguments().size(), 2);
+	BOOST_CHECK(a.sort()->kind == Kind::Bool);
+	BOOST_CHECK(a.arguments()[1].arguments()[0].identical(x));
+}
+
+BOOST_AUTO_TEST_CASE(cone_of_influence)
+{
+	SMTLib2Interface solver({});
+	Expression x = solver.newVariable("x", make_shared<Sort>(Kind::Int));
+	Expression y = solver.newVariable("y", make_shared<Sort>(Kind::Int));
+	Expression z = solver.newVariable("z", make_shared<Sort>(Kind::Int));
+	Expression w = solver.newVariable("w", make_shared<Sort>(Kind::Int));
+
+	Expression constraints = x == y + 1 && (z > 2 && (y < 5 && (w == z && (Expression(false) && Expression(true)))));
+	ConeOfInfluence coneOfInfluence;
+
+	auto sliced = coneOfInfluence.slice(constraints, x > 3);
+	BOOST_CHECK(sliced.first.identical(x == y + 1 && (y < 5 && Expression(false))));
+	BOOST_CHECK_EQUAL(sliced.second, 2);
+
+	sliced = coneOfInfluence.slice(constraints, w < 0);
+	BOOST_CHECK(sliced.first.identical(z > 2 && (w == z && Expression(false))));
+	BOOST_CHECK_EQUAL(sliced.second, 2);
+
+	sliced = coneOfInfluence.slice(Expression(true), x > 3);
+	BOOST_CHECK(sliced.first.identical(Expression(true)));
+	BOOST_CHECK_EQUAL(sliced.second, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
@@ -0,0 +1,132 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the persistent SMT query cache.
+ */
+
+#include <libsolidity/formal/SMTQueryCache.h>
+#include <libsolidity/interface/CompilerStack.h>
+
+#include <test/Options.h>
+#include <test/TemporaryDirectory.h>
+
+#include <boost/filesystem.hpp>
+
+using namespace std;
+using namespace dev::solidity::smt;
+using namespace dev::test;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(SMTQueryCacheTest)
+
+BOOST_AUTO_TEST_CASE(key_ignores_formatting)
+{
+	string query = "(declare-fun |x_0| () Int)\n(assert (>  |x_0| 2))\n(check-sat)\n";
+	string reformatted = "(declare-fun |x_0| () Int) ; x\n( assert (> |x_0|\n\t2 ) )\n(check-sat)";
+	BOOST_CHECK(SMTQueryCache::key(query, "z3") == SMTQueryCache::key(reformatted, "z3"));
+	BOOST_CHECK(SMTQueryCache::key(query, "z3") != SMTQueryCache::key(query, "cvc4"));
+	BOOST_CHECK(SMTQueryCache::key(query, "z3") != SMTQueryCache::key("(assert (> |x_0| 3))", "z3"));
+}
+
+BOOST_AUTO_TEST_CASE(store_and_lookup)
+{
+	TemporaryDirectory directory;
+	h256 key = SMTQueryCache::key("(check-sat)", "smtlib2");
+	{
+		SMTQueryCache cache(directory.path.string());
+		BOOST_CHECK(!cache.lookup(key));
+		cache.store(key, {CheckResult::SATISFIABLE, {"1", "(- 2)"}});
+		BOOST_CHECK_EQUAL(cache.misses(), 1);
+	}
+	SMTQueryCache cache(directory.path.string());
+	auto result = cache.lookup(key);
+	BOOST_REQUIRE(result);
+	BOOST_CHECK(result->first == CheckResult::SATISFIABLE);
+	BOOST_CHECK(result->second == vector<string>({"1", "(- 2)"}));
+	BOOST_CHECK_EQUAL(cache.hits(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(inconclusive_results_not_stored)
+{
+	TemporaryDirectory directory;
+	SMTQueryCache cache(directory.path.string());
+	h256 key = SMTQueryCache::key("(check-sat)", "smtlib2");
+	cache.store(key, {CheckResult::UNKNOWN, {}});
+	cache.store(key, {CheckResult::ERROR, {}});
+	BOOST_CHECK(!cache.lookup(key));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(SMTQueryCacheStatisticsTest)
+
+BOOST_AUTO_TEST_CASE(saved_queries_statistics)
+{
+	string const source = R"(
+		pragma experimental SMTChecker;
+		contract C {
+			function f(uint x) public pure { require(x > 10); assert(x > 5); assert(x > 1); assert(x != 0); }
+		}
+	)";
+	TemporaryDirectory directory;
+	bool solverAvailable = true;
+	auto statistics = [&]() {
+		CompilerStack compiler;
+		compiler.setSources({{"a.sol", source}});
+		compiler.setSMTQueryCacheDirectory(directory.path.string());
+		BOOST_REQUIRE(compiler.parseAndAnalyze());
+		for (auto const& error: compiler.errors())
+			if (error->comment() && error->comment()->find("no integrated SMT solver") != string::npos)
+				solverAvailable = false;
+		return compiler.modelCheckerStatistics();
+	};
+
+	Json::Value first = statistics();
+	if (!solverAvailable)
+	{
+		// Nothing is proven and inconclusive results are not cached.
+		boost::filesystem::remove_all(directory.path / "functions");
+		for (Json::Value const& result: {first, statistics()})
+		{
+			BOOST_CHECK_EQUAL(result["batchSavedQueries"].asUInt(), 0);
+			BOOST_CHECK_EQUAL(result["cachedQueries"].asUInt(), 0);
+		}
+		return;
+	}
+	// The three assertions are proven by a single query.
+	BOOST_CHECK_EQUAL(first["batchSavedQueries"].asUInt(), 2);
+	BOOST_CHECK_EQUAL(first["cachedQueries"].asUInt(), 0);
+
+	// Without the outcomes of the functions, all queries are answered by the query cache.
+	boost::filesystem::remove_all(directory.path / "functions");
+	Json::Value second = statistics();
+	BOOST_CHECK(second["queries"].asUInt() > 0);
+	BOOST_CHECK_EQUAL(second["cachedQueries"].asUInt(), second["queries"].asUInt());
+	BOOST_CHECK_EQUAL(second["batchSavedQueries"].asUInt(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
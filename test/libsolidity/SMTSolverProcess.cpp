@@ -0,0 +1,177 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the SMT-LIB2 solver process backend, using a stub solver script.
+ */
+
+#include <libsolidity/formal/SMTLib2Interface.h>
+#include <libsolidity/formal/SMTLib2ProcessInterface.h>
+#include <libsolidity/formal/SMTPortfolio.h>
+#include <libsolidity/formal/SolverProcessPool.h>
+
+#include <test/Options.h>
+
+#include <chrono>
+
+using namespace std;
+using namespace dev::solidity::smt;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(SMTSolverProcessTest)
+
+BOOST_AUTO_TEST_CASE(parse_response)
+{
+	auto result = SMTLib2Interface::parseResponse("sat\n((|EVALEXPR_0| (- 56))\n (|EVALEXPR_1| 3))\n");
+	BOOST_CHECK(result.first == CheckResult::SATISFIABLE);
+	BOOST_CHECK(result.second == (vector<string>{"(- 56)", "3"}));
+	result = SMTLib2Interface::parseResponse("unsat\n(error \"model is not available\")\n");
+	BOOST_CHECK(result.first == CheckResult::UNSATISFIABLE);
+	BOOST_CHECK(result.second.empty());
+}
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+
+namespace
+{
+
+shared_ptr<SolverProcessPool> stubSolverPool(string const& _answer, size_t _processes = 1)
+{
+	auto stub = dev::test::Options::get().testPath / "libsolidity" / "smtSolverStub.sh";
+	return make_shared<SolverProcessPool>("sh " + stub.string() + " " + _answer, _processes);
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(unsat)
+{
+	SMTLib2ProcessInterface solver(stubSolverPool("unsat"));
+	Expression x = solver.newVariable("x", make_shared<Sort>(Kind::Int));
+	solver.addAssertion(x > 2);
+	solver.push();
+	solver.addAssertion(x < 1);
+	auto result = solver.check({});
+	BOOST_CHECK(result.first == CheckResult::UNSATISFIABLE);
+	BOOST_CHECK(result.second.empty());
+	solver.pop();
+}
+
+BOOST_AUTO_TEST_CASE(sat_with_values)
+{
+	SMTLib2ProcessInterface solver(stubSolverPool("sat"));
+	Expression x = solver.newVariable("x", make_shared<Sort>(Kind::Int));
+	solver.addAssertion(x == 0);
+	auto result = solver.check({x});
+	BOOST_CHECK(result.first == CheckResult::SATISFIABLE);
+	BOOST_CHECK(result.second == vector<string>{"0"});
+}
+
+BOOST_AUTO_TEST_CASE(multiple_checks_and_reuse)
+{
+	auto pool = stubSolverPool("unknown");
+	for (size_t i = 0; i < 3; ++i)
+	{
+		// Every solver leases the same process, which has to be reset in between.
+		SMTLib2ProcessInterface solver(pool);
+		Expression x = solver.newVariable("x", make_shared<Sort>(Kind::Int));
+		for (size_t j = 0; j < 3; ++j)
+		{
+			solver.push();
+			solver.addAssertion(x == j);
+			BOOST_CHECK(solver.check({x}).first == CheckResult::UNKNOWN);
+			solver.pop();
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(parallel_solvers)
+{
+	auto pool = stubSolverPool("unsat", 2);
+	SMTLib2ProcessInterface first(pool);
+	SMTLib2ProcessInterface second(pool);
+	Expression x = first.newVariable("x", make_shared<Sort>(Kind::Int));
+	second.newVariable("x", make_shared<Sort>(Kind::Int));
+	first.addAssertion(x > 0);
+	second.addAssertion(x < 0);
+	BOOST_CHECK(first.check({}).first == CheckResult::UNSATISFIABLE);
+	BOOST_CHECK(second.check({}).first == CheckResult::UNSATISFIABLE);
+}
+
+BOOST_AUTO_TEST_CASE(query_timeout)
+{
+	SMTLib2ProcessInterface solver(stubSolverPool("none"), 100);
+	Expression x = solver.newVariable("x", make_shared<Sort>(Kind::Int));
+	solver.addAssertion(x > 2);
+	auto start = chrono::steady_clock::now();
+	BOOST_CHECK(solver.check({}).first == CheckResult::UNKNOWN);
+	// The process that did not answer is replaced by a new one.
+	solver.push();
+	solver.addAssertion(x < 1);
+	BOOST_CHECK(solver.check({}).first == CheckResult::UNKNOWN);
+	solver.pop();
+	BOOST_CHECK(chrono::steady_clock::now() - start < chrono::seconds(60));
+}
+
+BOOST_AUTO_TEST_CASE(portfolio_unhandled_queries)
+{
+	map<h256, string> const responses;
+	auto unhandledQueries = [&](string const& _answer) {
+		SMTPortfolio solver(responses, stubSolverPool(_answer));
+		Expression x = solver.newVariable("x", make_shared<Sort>(Kind::Int));
+		solver.addAssertion(x > 2);
+		solver.check({});
+		return solver.unhandledQueries().size();
+	};
+	// Queries answered by the solver process are not requested via the auxiliary input.
+	BOOST_CHECK_EQUAL(unhandledQueries("unsat"), 0);
+	BOOST_CHECK_EQUAL(unhandledQueries("unknown"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(output_read_while_sending)
+{
+	// cat answers every line at once, so its output fills up the socket long
+	// before all input is sent.
+	SolverProcess process("cat");
+	string const line(99, 'x');
+	for (size_t i = 0; i < 20000; ++i)
+		process.input() << line << "\n";
+	process.input() << "done\n";
+	auto output = process.readUntil("done");
+	BOOST_REQUIRE(output);
+	BOOST_CHECK_EQUAL(output->size(), 20000 * (line.size() + 1));
+}
+
+BOOST_AUTO_TEST_CASE(missing_solver)
+{
+	SMTLib2ProcessInterface solver(make_shared<SolverProcessPool>("solc-nonexistent-smt-solver", 1));
+	Expression x = solver.newVariable("x", make_shared<Sort>(Kind::Int));
+	solver.addAssertion(x > 0);
+	BOOST_CHECK_THROW(solver.check({}), SolverError);
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
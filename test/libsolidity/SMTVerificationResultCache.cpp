@@ -0,0 +1,167 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the reuse of verification outcomes of unchanged functions.
+ */
+
+#include <libsolidity/interface/CompilerStack.h>
+
+#include <test/Options.h>
+#include <test/TemporaryDirectory.h>
+
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/filesystem.hpp>
+
+using namespace std;
+using namespace langutil;
+using namespace dev::test;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+struct CheckResult
+{
+	/// Messages and locations of the warnings.
+	vector<tuple<string, int, int>> warnings;
+	size_t reusedFunctions = 0;
+	bool solverAvailable = true;
+};
+
+CheckResult check(string const& _source, string const& _cacheDirectory = "")
+{
+	CompilerStack compiler;
+	compiler.setSources({{"a.sol", _source}});
+	compiler.setSMTQueryCacheDirectory(_cacheDirectory);
+	BOOST_REQUIRE(compiler.parseAndAnalyze());
+
+	CheckResult result;
+	for (auto const& error: compiler.errors())
+	{
+		string message = error->comment() ? *error->comment() : "";
+		if (message.find("no integrated SMT solver") != string::npos)
+			result.solverAvailable = false;
+		SourceLocation const* location = boost::get_error_info<errinfo_sourceLocation>(*error);
+		result.warnings.emplace_back(message, location ? location->start : -1, location ? location->end : -1);
+	}
+	result.reusedFunctions = compiler.modelCheckerStatistics()["reusedFunctions"].asUInt();
+	return result;
+}
+
+/// Without an integrated solver, outcomes depend on the environment and are not cached,
+/// so checking @a _source again reports the same warnings and reuses no function.
+void checkNothingCached(CheckResult const& _first, string const& _source, string const& _cacheDirectory)
+{
+	BOOST_CHECK_EQUAL(_first.reusedFunctions, 0);
+	CheckResult second = check(_source, _cacheDirectory);
+	BOOST_CHECK(!second.solverAvailable);
+	BOOST_CHECK_EQUAL(second.reusedFunctions, 0);
+	BOOST_CHECK(second.warnings == _first.warnings);
+}
+
+string const c_source = R"(
+	pragma experimental SMTChecker;
+	contract C {
+		uint x;
+		modifier positive(uint a) { require(a > 0); _; }
+		function inc(uint a) internal pure returns (uint) { return a + 1; }
+		function f(uint a) public positive(a) { x = inc(a); assert(x > 1); }
+		function g(uint b) public view { if (b > 2) { assert(b + x > 3); } }
+	}
+)";
+
+}
+
+BOOST_AUTO_TEST_SUITE(SMTVerificationResultCacheTest)
+
+BOOST_AUTO_TEST_CASE(unchanged_source)
+{
+	TemporaryDirectory directory;
+	CheckResult first = check(c_source, directory.path.string());
+	if (!first.solverAvailable)
+	{
+		checkNothingCached(first, c_source, directory.path.string());
+		return;
+	}
+	BOOST_CHECK_EQUAL(first.reusedFunctions, 0);
+	CheckResult second = check(c_source, directory.path.string());
+	BOOST_CHECK_EQUAL(second.reusedFunctions, 3);
+	BOOST_CHECK(second.warnings == first.warnings);
+}
+
+BOOST_AUTO_TEST_CASE(changed_function)
+{
+	TemporaryDirectory directory;
+	CheckResult first = check(c_source, directory.path.string());
+	if (!first.solverAvailable)
+	{
+		checkNothingCached(first, c_source, directory.path.string());
+		return;
+	}
+
+	// Moves all functions and changes g only.
+	string changed = boost::algorithm::replace_all_copy(c_source, "uint x;", "uint x;\n\n");
+	boost::algorithm::replace_all(changed, "b + x > 3", "b + x > 4");
+	CheckResult result = check(changed, directory.path.string());
+	BOOST_CHECK_EQUAL(result.reusedFunctions, 2);
+	// Reused warnings refer to the new locations.
+	BOOST_CHECK(result.warnings == check(changed).warnings);
+}
+
+BOOST_AUTO_TEST_CASE(changed_callee)
+{
+	TemporaryDirectory directory;
+	CheckResult first = check(c_source, directory.path.string());
+	if (!first.solverAvailable)
+	{
+		checkNothingCached(first, c_source, directory.path.string());
+		return;
+	}
+
+	string changed = boost::algorithm::replace_all_copy(c_source, "return a + 1;", "return a + 2;");
+	CheckResult result = check(changed, directory.path.string());
+	// Only g does not depend on inc.
+	BOOST_CHECK_EQUAL(result.reusedFunctions, 1);
+	BOOST_CHECK(result.warnings == check(changed).warnings);
+}
+
+BOOST_AUTO_TEST_CASE(changed_state_variables)
+{
+	TemporaryDirectory directory;
+	CheckResult first = check(c_source, directory.path.string());
+	if (!first.solverAvailable)
+	{
+		checkNothingCached(first, c_source, directory.path.string());
+		return;
+	}
+
+	string changed = boost::algorithm::replace_all_copy(c_source, "uint x;", "uint x; bool y;");
+	CheckResult result = check(changed, directory.path.string());
+	BOOST_CHECK_EQUAL(result.reusedFunctions, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
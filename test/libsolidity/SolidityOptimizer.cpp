@@ -700,6 +700,50 @@ BOOST_AUTO_TEST_CASE(shift_optimizer_bug)
 	compareVersions("g(uint256)", u256(-1));
 }
 
+BOOST_AUTO_TEST_CASE(tag_table_dispatch)
+{
+	char const* sourceCode = R"(
+		contract C {
+			uint public fallbackCalls;
+			function f1() public pure returns (uint) { return 1; }
+			function f2() public pure returns (uint) { return 2; }
+			function f3() public pure returns (uint) { return 3; }
+			function f4() public pure returns (uint) { return 4; }
+			function f5() public pure returns (uint) { return 5; }
+			function f6() public pure returns (uint) { return 6; }
+			function f7() public pure returns (uint) { return 7; }
+			function f8() public pure returns (uint) { return 8; }
+			function f9() public pure returns (uint) { return 9; }
+			function f10(uint x) public pure returns (uint) { return x + 10; }
+			function f11(uint x) public pure returns (uint) { return x + 11; }
+			function() external { fallbackCalls++; }
+		}
+	)";
+	compileBothVersions(sourceCode, 0, "C", 10000);
+	for (unsigned i = 1; i < 10; ++i)
+	{
+		compareVersions("f" + to_string(i) + "()");
+		ABI_CHECK(callContractFunction("f" + to_string(i) + "()"), encodeArgs(u256(i)));
+	}
+	compareVersions("f10(uint256)", 7);
+	compareVersions("f11(uint256)", 7);
+	ABI_CHECK(callContractFunction("f11(uint256)", 7), encodeArgs(18));
+	// Unknown functions reach the fallback function.
+	for (Address const& contract: {m_nonOptimizedContract, m_optimizedContract})
+	{
+		m_contractAddress = contract;
+		ABI_CHECK(callContractFunction("g()"), encodeArgs());
+		ABI_CHECK(callContractFunction("f12()"), encodeArgs());
+		ABI_CHECK(callContractFunction("fallbackCalls()"), encodeArgs(2));
+	}
+	if (dev::test::Options::get().evmVersion().hasBitwiseShifting())
+	{
+		// The tag table is the only 32 byte push.
+		BOOST_CHECK_EQUAL(numInstructions(m_nonOptimizedBytecode, Instruction::PUSH32), 1);
+		BOOST_CHECK_EQUAL(numInstructions(m_optimizedBytecode, Instruction::PUSH32), 1);
+	}
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -24,6 +24,7 @@
 #include <libsolidity/interface/StandardCompiler.h>
 #include <libsolidity/interface/Version.h>
 #include <libdevcore/JSON.h>
+#include <libdevcore/Keccak256.h>
 #include <test/Metadata.h>
 
 using namespace std;
@@ -1024,6 +1025,7 @@ BOOST_AUTO_TEST_CASE(optimizer_settings_details_different)
 				"fileA": { "A": [ "metadata" ] }
 			},
 			"optimizer": { "runs": 600, "details": {
+				"blockLayout" : true,
 				"constantOptimizer" : true,
 				"cse" : false,
 				"deduplicate" : true,
@@ -1067,10 +1069,215 @@ BOOST_AUTO_TEST_CASE(optimizer_settings_details_different)
 	BOOST_CHECK(optimizer["details"]["yulDetails"].isObject());
 	BOOST_CHECK(optimizer["details"]["yulDetails"].getMemberNames() == vector<string>{"stackAllocation"});
 	BOOST_CHECK(optimizer["details"]["yulDetails"]["stackAllocation"].asBool() == true);
-	BOOST_CHECK_EQUAL(optimizer["details"].getMemberNames().size(), 8);
+	BOOST_CHECK(optimizer["details"]["blockLayout"].asBool() == true);
+	BOOST_CHECK_EQUAL(optimizer["details"].getMemberNames().size(), 9);
 	BOOST_CHECK(optimizer["runs"].asUInt() == 600);
 }
 
+BOOST_AUTO_TEST_CASE(model_checker_timeout_not_a_number)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"modelChecker": { "timeout": "100" }
+		},
+		"sources": {
+			"fileA": {
+				"content": "contract A { }"
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsError(result, "JSONError", "\"settings.modelChecker.timeout\" must be an unsigned number."));
+}
+
+BOOST_AUTO_TEST_CASE(model_checker_invalid_key)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"modelChecker": { "engine": "bmc" }
+		},
+		"sources": {
+			"fileA": {
+				"content": "contract A { }"
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsError(result, "JSONError", "Unknown key \"engine\""));
+}
+
+BOOST_AUTO_TEST_CASE(model_checker_statistics)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"modelChecker": { "timeout": 1000, "statistics": true }
+		},
+		"sources": {
+			"fileA": {
+				"content": "pragma experimental SMTChecker; contract A { function f(uint x) public pure { assert(x > 0); } }"
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsAtMostWarnings(result));
+	Json::Value const& statistics = result["modelChecker"]["statistics"];
+	BOOST_REQUIRE(statistics.isObject());
+	BOOST_CHECK(statistics["queries"].isUInt());
+	BOOST_CHECK_EQUAL(statistics["skippedQueries"].asUInt(), 0);
+	BOOST_REQUIRE(statistics["targets"].isArray());
+	bool foundAssertion = false;
+	for (auto const& target: statistics["targets"])
+		if (target["type"].asString() == "assertion")
+		{
+			foundAssertion = true;
+			BOOST_CHECK_EQUAL(target["source"].asString(), "fileA");
+			BOOST_CHECK(target["result"].isString());
+		}
+	BOOST_CHECK(foundAssertion);
+}
+
+BOOST_AUTO_TEST_CASE(optimizer_statistics)
+{
+	auto input = [](bool _statistics)
+	{
+		return R"(
+		{
+			"language": "Solidity",
+			"settings": {
+				"optimizer": { "enabled": true, "details": { "yul": true }, "statistics": )" + string(_statistics ? "true" : "false") + R"( },
+				"outputSelection": {
+					"fileA": { "A": [ "evm.bytecode.object", "metadata" ] }
+				}
+			},
+			"sources": {
+				"fileA": {
+					"content": "pragma experimental ABIEncoderV2; contract A { uint s; function f(uint[] memory x) public returns (uint[] memory) { s = x.length; return x; } }"
+				}
+			}
+		}
+		)";
+	};
+	Json::Value result = compile(input(true));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	Json::Value const& statistics = result["optimizer"]["statistics"];
+	BOOST_REQUIRE(statistics.isObject());
+	for (string const& step: {"peephole", "deduplicate", "cse", "constantOptimizer"})
+	{
+		BOOST_REQUIRE(statistics["evmasm"][step].isObject());
+		BOOST_CHECK(statistics["evmasm"][step]["runs"].asUInt() >= 1);
+		BOOST_CHECK(statistics["evmasm"][step]["changedRuns"].asUInt() <= statistics["evmasm"][step]["runs"].asUInt());
+		BOOST_CHECK(statistics["evmasm"][step]["time"].isDouble());
+		BOOST_CHECK(statistics["evmasm"][step]["bytesDelta"].isInt());
+	}
+	BOOST_CHECK(!statistics["evmasm"].isMember("blockLayout"));
+	BOOST_REQUIRE(statistics["yul"]["ExpressionSimplifier"].isObject());
+	BOOST_CHECK(statistics["yul"]["ExpressionSimplifier"]["runs"].asUInt() >= 1);
+	BOOST_CHECK(!statistics["yul"]["ExpressionSimplifier"].isMember("gasDelta"));
+
+	// Collecting the statistics does not change the output.
+	Json::Value resultWithout = compile(input(false));
+	BOOST_CHECK(!resultWithout.isMember("optimizer"));
+	BOOST_CHECK_EQUAL(
+		result["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString(),
+		resultWithout["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString()
+	);
+	BOOST_CHECK_EQUAL(
+		result["contracts"]["fileA"]["A"]["metadata"].asString(),
+		resultWithout["contracts"]["fileA"]["A"]["metadata"].asString()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(optimizer_output_independent_of_previous_compilations)
+{
+	auto input = [](string const& _content)
+	{
+		return R"(
+		{
+			"language": "Solidity",
+			"settings": {
+				"optimizer": { "enabled": true, "details": { "yul": true } },
+				"outputSelection": {
+					"fileA": { "*": [ "evm.bytecode.object" ] }
+				}
+			},
+			"sources": {
+				"fileA": {
+					"content": ")" + _content + R"("
+				}
+			}
+		}
+		)";
+	};
+	string const sourceA =
+		"pragma experimental ABIEncoderV2; contract A { "
+		"function f(uint[] memory x) public pure returns (uint, uint[] memory) { "
+		"return (x.length * 0x100000000000000000000000000000000000000000000000000001 + "
+		"0xffffffffffffffffffffffffffff000000000000000000000000000000000000, x); } }";
+	string const sourceB =
+		"contract B { function g(uint x) public pure returns (uint) { "
+		"return x ^ 0x100000000000000000000000000000000000000000000000000002 ^ "
+		"0xfffffffffffffffffffffffffffe000000000000000000000000000000000001 ^ "
+		"0x1000000000000000000000000000000000000000000000000000ffffff; } }";
+
+	Json::Value first = compile(input(sourceA));
+	BOOST_CHECK(containsAtMostWarnings(first));
+	Json::Value other = compile(input(sourceB));
+	BOOST_CHECK(containsAtMostWarnings(other));
+	Json::Value second = compile(input(sourceA));
+	BOOST_CHECK(containsAtMostWarnings(second));
+	BOOST_CHECK(!first["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString().empty());
+	BOOST_CHECK_EQUAL(
+		first["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString(),
+		second["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(tag_table_dispatch_large_code)
+{
+	// The fallback function is placed between the selector and the functions and
+	// makes the code larger than 64 KiB, which tag tables cannot address.
+	string source = "contract C { event E(uint); ";
+	for (unsigned i = 0; i < 12; ++i)
+		source += "function f" + to_string(i) + "() public pure returns (uint) { return " + to_string(i) + "; } ";
+	source += "function() external { ";
+	for (unsigned i = 0; i < 2000; ++i)
+		source += "emit E(0x" + dev::keccak256(to_string(i)).hex() + "); ";
+	source += "} }";
+	string input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"evmVersion": "petersburg",
+			"optimizer": { "enabled": true, "runs": 10000 },
+			"outputSelection": {
+				"fileA": { "C": [ "evm.assembly", "evm.deployedBytecode.object" ] }
+			}
+		},
+		"sources": {
+			"fileA": {
+				"content": ")" + source + R"("
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_REQUIRE(containsAtMostWarnings(result));
+	Json::Value contract = getContractResult(result, "fileA", "C");
+	BOOST_REQUIRE(contract.isObject());
+	BOOST_CHECK(contract["evm"]["deployedBytecode"]["object"].asString().size() > 2 * 0x10000);
+	// The selector in front of the fallback function still uses a tag table.
+	BOOST_CHECK(contract["evm"]["assembly"].asString().find("tagTable(") != string::npos);
+}
+
 BOOST_AUTO_TEST_CASE(metadata_without_compilation)
 {
 	// NOTE: the contract code here should fail to compile due to "out of stack"
@@ -0,0 +1,173 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the cache of Yul helper functions shared between contracts.
+ */
+
+#include <libsolidity/codegen/YulFunctionCache.h>
+#include <libsolidity/codegen/ABIFunctions.h>
+#include <libsolidity/codegen/CompilerContext.h>
+#include <libsolidity/codegen/MultiUseYulFunctionCollector.h>
+#include <libsolidity/codegen/YulUtilFunctions.h>
+#include <libsolidity/ast/TypeProvider.h>
+
+#include <test/Options.h>
+
+using namespace std;
+using namespace langutil;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+/// @returns the helper functions needed to ABI-encode a uint256 and a bytes32 value,
+/// generated for @a _evmVersion, taking functions from @a _cache if it is not null.
+string tupleEncoder(EVMVersion _evmVersion, shared_ptr<YulFunctionCache> _cache)
+{
+	auto collector = make_shared<MultiUseYulFunctionCollector>(move(_cache), _evmVersion);
+	TypePointers types{TypeProvider::uint256(), TypeProvider::fixedBytes(32)};
+	ABIFunctions(_evmVersion, collector).tupleEncoder(types, types);
+	return collector->requestedFunctions();
+}
+
+/// @returns the helper function shifting left by 8 bits, generated for @a _evmVersion.
+string shiftLeft(EVMVersion _evmVersion, shared_ptr<YulFunctionCache> _cache)
+{
+	auto collector = make_shared<MultiUseYulFunctionCollector>(move(_cache), _evmVersion);
+	YulUtilFunctions(_evmVersion, collector).shiftLeftFunction(8);
+	return collector->requestedFunctions();
+}
+
+/// @returns the assembly of a context that pushes a value and appends @a _code with
+/// the value as local variable "x" if @a _withLocal is true.
+string inlineAssembly(
+	string const& _code,
+	bool _withLocal,
+	set<string> const& _externallyUsedFunctions,
+	OptimiserSettings const& _settings,
+	EVMVersion _evmVersion,
+	shared_ptr<YulFunctionCache> _cache
+)
+{
+	CompilerContext context(_evmVersion, nullptr, move(_cache));
+	if (_withLocal)
+		context << u256(1);
+	context.appendInlineAssembly(
+		_code,
+		_withLocal ? vector<string>{"x"} : vector<string>{},
+		_externallyUsedFunctions,
+		false,
+		_settings
+	);
+	return context.assemblyString();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(YulFunctionCacheTest)
+
+BOOST_AUTO_TEST_CASE(cached_functions_identical)
+{
+	EVMVersion evmVersion = dev::test::Options::get().evmVersion();
+	auto cache = make_shared<YulFunctionCache>();
+	string uncached = tupleEncoder(evmVersion, nullptr);
+	BOOST_CHECK_EQUAL(tupleEncoder(evmVersion, cache), uncached);
+	BOOST_CHECK_EQUAL(cache->functionHits(), 0);
+	BOOST_CHECK_EQUAL(tupleEncoder(evmVersion, cache), uncached);
+	// The encoder is taken from the cache together with all functions it calls.
+	BOOST_CHECK(cache->functionHits() > 1);
+}
+
+BOOST_AUTO_TEST_CASE(cached_dependencies_without_creator)
+{
+	auto cache = make_shared<YulFunctionCache>();
+	string expectation;
+	for (size_t i = 0; i < 2; ++i)
+	{
+		MultiUseYulFunctionCollector collector(cache, EVMVersion::petersburg());
+		collector.createFunction("f", [&]() {
+			BOOST_REQUIRE_EQUAL(i, 0);
+			return "function f() { " + collector.createFunction("g", [&]() {
+				BOOST_REQUIRE_EQUAL(i, 0);
+				return string("function g() {}\n");
+			}) + "() }\n";
+		});
+		if (i == 0)
+			expectation = collector.requestedFunctions();
+		else
+			BOOST_CHECK_EQUAL(collector.requestedFunctions(), expectation);
+	}
+	BOOST_CHECK_EQUAL(expectation, "function f() { g() }\nfunction g() {}\n");
+	BOOST_CHECK_EQUAL(cache->functionHits(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(different_evm_version_misses)
+{
+	auto cache = make_shared<YulFunctionCache>();
+	string withShifts = shiftLeft(EVMVersion::constantinople(), cache);
+	string withoutShifts = shiftLeft(EVMVersion::byzantium(), cache);
+	BOOST_CHECK_EQUAL(cache->functionHits(), 0);
+	BOOST_CHECK(withShifts != withoutShifts);
+	BOOST_CHECK_EQUAL(withoutShifts, shiftLeft(EVMVersion::byzantium(), nullptr));
+	BOOST_CHECK_EQUAL(shiftLeft(EVMVersion::constantinople(), cache), withShifts);
+	BOOST_CHECK_EQUAL(cache->functionHits(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(cached_inline_assembly_identical)
+{
+	EVMVersion evmVersion = dev::test::Options::get().evmVersion();
+	string code = "{ function f(a) -> b { b := add(a, 1) } x := f(x) mstore(0, x) }";
+	auto cache = make_shared<YulFunctionCache>();
+	string uncached = inlineAssembly(code, true, {}, OptimiserSettings::none(), evmVersion, nullptr);
+	BOOST_CHECK_EQUAL(inlineAssembly(code, true, {}, OptimiserSettings::none(), evmVersion, cache), uncached);
+	BOOST_CHECK_EQUAL(cache->blockHits(), 0);
+	BOOST_CHECK_EQUAL(inlineAssembly(code, true, {}, OptimiserSettings::none(), evmVersion, cache), uncached);
+	BOOST_CHECK_EQUAL(cache->blockHits(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(inline_assembly_settings_miss)
+{
+	EVMVersion evmVersion = EVMVersion::petersburg();
+	string code = "{ function f() -> r { r := 7 } function g() -> r { r := f() } mstore(0, g()) }";
+	OptimiserSettings none = OptimiserSettings::none();
+	OptimiserSettings full = OptimiserSettings::full();
+	auto cache = make_shared<YulFunctionCache>();
+	string unoptimised = inlineAssembly(code, false, {"f"}, none, evmVersion, cache);
+	string optimised = inlineAssembly(code, false, {"f"}, full, evmVersion, cache);
+	string unused = inlineAssembly(code, false, {}, full, evmVersion, cache);
+	string byzantium = inlineAssembly(code, false, {"f"}, full, EVMVersion::byzantium(), cache);
+	BOOST_CHECK_EQUAL(cache->blockHits(), 0);
+	BOOST_CHECK_EQUAL(unoptimised, inlineAssembly(code, false, {"f"}, none, evmVersion, nullptr));
+	BOOST_CHECK_EQUAL(optimised, inlineAssembly(code, false, {"f"}, full, evmVersion, nullptr));
+	BOOST_CHECK_EQUAL(unused, inlineAssembly(code, false, {}, full, evmVersion, nullptr));
+	BOOST_CHECK_EQUAL(byzantium, inlineAssembly(code, false, {"f"}, full, EVMVersion::byzantium(), nullptr));
+	BOOST_CHECK(unoptimised != optimised);
+	// The optimiser keeps f only if it is used from outside of the block.
+	BOOST_CHECK(optimised != unused);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
@@ -0,0 +1,43 @@
+contract Table {
+    uint public a;
+    uint[] public b;
+    function f1(uint x) public returns (uint) { a = x; b[uint8(msg.data[0])] = x; }
+    function f2(uint x) public returns (uint) { b[uint8(msg.data[1])] = x; }
+    function f3(uint x) public returns (uint) { b[uint8(msg.data[2])] = x; }
+    function f4(uint x) public returns (uint) { b[uint8(msg.data[3])] = x; }
+    function f5(uint x) public returns (uint) { b[uint8(msg.data[4])] = x; }
+    function f6(uint x) public returns (uint) { b[uint8(msg.data[5])] = x; }
+    function f0(uint x) public pure returns (uint) { require(x > 10); }
+    function g1(uint x) public payable returns (uint) { a = x; b[uint8(msg.data[0])] = x; }
+    function g2(uint x) public payable returns (uint) { b[uint8(msg.data[1])] = x; }
+    function g3(uint x) public payable returns (uint) { b[uint8(msg.data[2])] = x; }
+    function g4(uint x) public payable returns (uint) { b[uint8(msg.data[3])] = x; }
+    function g5(uint x) public payable returns (uint) { b[uint8(msg.data[4])] = x; }
+    function g6(uint x) public payable returns (uint) { b[uint8(msg.data[5])] = x; }
+    function g0(uint x) public payable returns (uint) { require(x > 10); }
+}
+// ====
+// optimize: true
+// optimize-runs: 10000
+// ----
+// creation:
+//   codeDepositCost: 234000
+//   executionCost: 275
+//   totalCost: 234275
+// external:
+//   a(): 437
+//   b(uint256): 775
+//   f0(uint256): 307
+//   f1(uint256): 40632
+//   f2(uint256): 20632
+//   f3(uint256): 20632
+//   f4(uint256): 20632
+//   f5(uint256): 20632
+//   f6(uint256): 20632
+//   g0(uint256): 288
+//   g1(uint256): 40603
+//   g2(uint256): 20603
+//   g3(uint256): 20603
+//   g4(uint256): 20603
+//   g5(uint256): 20603
+//   g6(uint256): 20603
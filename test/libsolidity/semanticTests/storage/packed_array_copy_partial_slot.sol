@@ -0,0 +1,37 @@
+contract C {
+    uint24[] a;
+    uint16[17] b;
+    function setA(uint n) public returns (uint) {
+        uint24[] memory x = new uint24[](n);
+        for (uint i = 0; i < n; i++)
+            x[i] = uint24(0x10000 + i);
+        a = x;
+        return a.length;
+    }
+    function setB() public {
+        uint16[17] memory x;
+        for (uint i = 0; i < 17; i++)
+            x[i] = uint16(0x100 + i);
+        b = x;
+    }
+    function slotA(uint i) public view returns (uint r) {
+        assembly {
+            mstore(0, a_slot)
+            r := sload(add(keccak256(0, 0x20), i))
+        }
+    }
+    function slotB(uint i) public view returns (uint r) {
+        assembly { r := sload(add(b_slot, i)) }
+    }
+}
+// ----
+// setA(uint256): 20 -> 20
+// slotA(uint256): 1 -> 0x1001301001201001101001001000f01000e01000d01000c01000b01000a
+// setA(uint256): 11 -> 11
+// slotA(uint256): 0 -> 0x10009010008010007010006010005010004010003010002010001010000
+// slotA(uint256): 1 -> 0x1000a
+// slotA(uint256): 2 -> 0
+// setB() ->
+// slotB(uint256): 0 -> 0x10f010e010d010c010b010a0109010801070106010501040103010201010100
+// slotB(uint256): 1 -> 0x110
+// slotB(uint256): 2 -> 0
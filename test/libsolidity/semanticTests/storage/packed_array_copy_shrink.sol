@@ -0,0 +1,34 @@
+contract C {
+    uint8[] a;
+    function setA(uint n) public returns (uint) {
+        uint8[] memory x = new uint8[](n);
+        for (uint i = 0; i < n; i++)
+            x[i] = uint8(i + 1);
+        a = x;
+        return a.length;
+    }
+    function setACalldata(uint8[] calldata x) external returns (uint) {
+        a = x;
+        return a.length;
+    }
+    function slot(uint i) public view returns (uint r) {
+        assembly {
+            mstore(0, a_slot)
+            r := sload(add(keccak256(0, 0x20), i))
+        }
+    }
+}
+// ----
+// setA(uint256): 70 -> 70
+// slot(uint256): 1 -> 0x403f3e3d3c3b3a393837363534333231302f2e2d2c2b2a292827262524232221
+// slot(uint256): 2 -> 0x464544434241
+// setA(uint256): 3 -> 3
+// slot(uint256): 0 -> 0x030201
+// slot(uint256): 1 -> 0
+// slot(uint256): 2 -> 0
+// setA(uint256): 40 -> 40
+// setACalldata(uint8[]): 0x20, 2, 7, 255 -> 2
+// slot(uint256): 0 -> 0xff07
+// slot(uint256): 1 -> 0
+// setACalldata(uint8[]): 0x20, 0 -> 0
+// slot(uint256): 0 -> 0
@@ -0,0 +1,31 @@
+contract C {
+    int8[] public a;
+    int16[3] public b;
+    function setA(int8[] memory x) public returns (int8[] memory) {
+        a = x;
+        return a;
+    }
+    function setB(int16[3] calldata x) external returns (int16[3] memory) {
+        b = x;
+        return b;
+    }
+    function slotA() public view returns (uint r) {
+        assembly {
+            mstore(0, a_slot)
+            r := sload(keccak256(0, 0x20))
+        }
+    }
+    function slotB() public view returns (uint r) {
+        assembly { r := sload(b_slot) }
+    }
+}
+// ----
+// setA(int8[]): 0x20, 4, -1, 2, -128, 127 -> 0x20, 4, -1, 2, -128, 127
+// a(uint256): 0 -> -1
+// a(uint256): 2 -> -128
+// a(uint256): 3 -> 127
+// slotA() -> 0x7f8002ff
+// setB(int16[3]): -1, -32768, 5 -> -1, -32768, 5
+// b(uint256): 0 -> -1
+// b(uint256): 1 -> -32768
+// slotB() -> 0x00058000ffff
@@ -0,0 +1,56 @@
+#!/usr/bin/env sh
+
+#------------------------------------------------------------------------------
+# Minimal SMT-LIB2 "solver" used to test the solver process backend of the
+# SMTChecker without an actual solver.
+#
+# Answers every (check-sat) with the first argument (default: unsat),
+# every (get-value ...) with the value 0 for the first requested expression
+# and prints the argument of (echo ...). All other commands are ignored.
+# The answer "none" makes the solver stop answering at the first (check-sat).
+#
+# The documentation for solidity is hosted at:
+#
+#     https://solidity.readthedocs.org
+#
+# ------------------------------------------------------------------------------
+# This file is part of solidity.
+#
+# solidity is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# solidity is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with solidity.  If not, see <http://www.gnu.org/licenses/>
+#
+# (c) 2019 solidity contributors.
+#------------------------------------------------------------------------------
+
+answer="${1:-unsat}"
+
+while IFS= read -r line
+do
+	case "$line" in
+		"(check-sat)"*)
+			if [ "$answer" = "none" ]
+			then
+				exec sleep 600
+			fi
+			echo "$answer"
+			;;
+		"(get-value ("*)
+			name="${line#(get-value (}"
+			echo "((${name%% *} 0))"
+			;;
+		"(echo "*)
+			text="${line#(echo \"}"
+			echo "${text%\")}"
+			;;
+	esac
+done
@@ -0,0 +1,123 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Benchmark for the time spent in the libevmasm optimiser.
+ */
+
+#include <libsolidity/interface/CompilerStack.h>
+#include <libsolidity/interface/OptimiserSettings.h>
+
+#include <libdevcore/CommonIO.h>
+
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+/// @returns the time in seconds to compile @a _sources with @a _settings or a negative
+/// value if the compilation failed.
+double compileTime(map<string, string> const& _sources, OptimiserSettings const& _settings)
+{
+	CompilerStack compiler;
+	compiler.setSources(_sources);
+	compiler.setOptimiserSettings(_settings);
+	auto start = chrono::steady_clock::now();
+	if (!compiler.compile())
+		return -1;
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	size_t iterations = 0;
+	vector<string> files;
+	po::options_description options(
+		R"(optimiserbench, the libevmasm optimiser benchmark.
+Usage: optimiserbench [Options] file...
+Compiles the given files with and without the libevmasm optimiser and reports
+the time taken by the optimiser. Relative imports are resolved against the given paths.
+
+Allowed options)",
+		po::options_description::m_default_line_length,
+		po::options_description::m_default_line_length - 23);
+	options.add_options()
+		("iterations", po::value<size_t>(&iterations)->default_value(10), "number of compilations per setting")
+		("help", "Show this help screen.");
+	po::options_description allOptions = options;
+	allOptions.add_options()("input-file", po::value<vector<string>>(&files), "input file");
+	po::positional_options_description filesPositions;
+	filesPositions.add("input-file", -1);
+
+	po::variables_map arguments;
+	try
+	{
+		po::store(po::command_line_parser(argc, argv).options(allOptions).positional(filesPositions).run(), arguments);
+		po::notify(arguments);
+	}
+	catch (po::error const& _exception)
+	{
+		cerr << _exception.what() << endl;
+		return 1;
+	}
+	if (arguments.count("help") || files.empty())
+	{
+		cout << options;
+		return 0;
+	}
+
+	map<string, string> sources;
+	for (string const& file: files)
+		sources[file] = readFileAsString(file);
+
+	OptimiserSettings settings = OptimiserSettings::standard();
+	// Only measure the libevmasm optimiser, not the different code generation.
+	settings.runOrderLiterals = false;
+	double unoptimisedTime = 0;
+	double optimisedTime = 0;
+	for (size_t i = 0; i < iterations; ++i)
+	{
+		double unoptimised = compileTime(sources, OptimiserSettings::minimal());
+		double optimised = compileTime(sources, settings);
+		if (unoptimised < 0 || optimised < 0)
+		{
+			cerr << "Compilation failed." << endl;
+			return 1;
+		}
+		unoptimisedTime += unoptimised;
+		optimisedTime += optimised;
+	}
+	cout <<
+		"compilation without optimiser: " << unoptimisedTime / double(iterations) << " s, " <<
+		"with optimiser: " << optimisedTime / double(iterations) << " s, " <<
+		"optimiser: " << (optimisedTime - unoptimisedTime) / double(iterations) << " s" <<
+		endl;
+	return 0;
+}
@@ -0,0 +1,140 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Render throughput benchmark for Whiskers templates.
+ */
+
+#include <libdevcore/Whiskers.h>
+
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace dev;
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+// Templates in the style of the ABI coder, instantiated the way the code generator does.
+string const c_functionTemplate = R"(
+	function <functionName>(headStart, dataEnd) <arrow> <valueReturnParams> {
+		if slt(sub(dataEnd, headStart), <minimumSize>) { revert(0, 0) }
+		<decodeElements>
+	}
+)";
+
+string const c_tupleTemplate = R"(
+	function <functionName>(headStart <valueParams>) -> tail {
+		tail := add(headStart, <headSize>)
+		<#values>
+		{
+			<?dynamic>
+				mstore(add(headStart, <pos>), sub(tail, headStart))
+				tail := <abiEncode>(<memberValues> tail)
+			<!dynamic>
+				<abiEncode>(<memberValues> add(headStart, <pos>))
+			</dynamic>
+		}
+		</values>
+		<?cleanup>tail := <cleanup>(tail)</cleanup>
+	}
+)";
+
+size_t renderFunction(size_t _index)
+{
+	return Whiskers(c_functionTemplate)
+		("functionName", "abi_decode_tuple_t_uint256_" + to_string(_index))
+		("arrow", "->")
+		("valueReturnParams", "value0, value1")
+		("minimumSize", "64")
+		("decodeElements", "value0 := calldataload(headStart)")
+		.render().size();
+}
+
+size_t renderTuple(size_t _index)
+{
+	vector<Whiskers::StringMap> values(4);
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		values[i]["pos"] = to_string(i * 32);
+		values[i]["abiEncode"] = "abi_encode_t_uint256_" + to_string(i);
+		values[i]["memberValues"] = "value" + to_string(i) + ",";
+	}
+	return Whiskers(c_tupleTemplate)
+		("functionName", "abi_encode_tuple_" + to_string(_index))
+		("valueParams", ", value0, value1, value2, value3")
+		("headSize", "128")
+		("dynamic", _index % 2 == 0)
+		("values", values)
+		("cleanup", false)
+		.render().size();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	size_t iterations = 0;
+	po::options_description options(
+		R"(whiskersbench, the Whiskers render throughput benchmark.
+Usage: whiskersbench [Options]
+Renders typical code generator templates and reports the number of renders per second.
+
+Allowed options)",
+		po::options_description::m_default_line_length,
+		po::options_description::m_default_line_length - 23);
+	options.add_options()
+		("iterations", po::value<size_t>(&iterations)->default_value(100000), "number of renders per template")
+		("help", "Show this help screen.");
+
+	po::variables_map arguments;
+	try
+	{
+		po::store(po::command_line_parser(argc, argv).options(options).run(), arguments);
+		po::notify(arguments);
+	}
+	catch (po::error const& _exception)
+	{
+		cerr << _exception.what() << endl;
+		return 1;
+	}
+	if (arguments.count("help"))
+	{
+		cout << options;
+		return 0;
+	}
+
+	for (auto const& benchmark: {make_pair("function", &renderFunction), make_pair("tuple", &renderTuple)})
+	{
+		size_t totalSize = 0;
+		auto start = chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; ++i)
+			totalSize += benchmark.second(i);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		cout <<
+			benchmark.first << ": " <<
+			size_t(double(iterations) / seconds) << " renders/s, " <<
+			size_t(double(totalSize) / seconds / 1024 / 1024) << " MiB/s" <<
+			endl;
+	}
+	return 0;
+}